@@ -0,0 +1,59 @@
+/* C Interface Example
+ * Queue a capture through the C ABI, wait for it to complete and take
+ * ownership of the image bytes without copying them. */
+
+#include <pxshot/pxshot.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+int main(void) {
+    const char* api_key = getenv("PXSHOT_API_KEY");
+    if (!api_key) {
+        fprintf(stderr, "Error: PXSHOT_API_KEY environment variable not set\n");
+        return 1;
+    }
+    
+    pxshot_client* client = NULL;
+    if (pxshot_client_new(api_key, &client) != PXSHOT_OK) {
+        fprintf(stderr, "Error: %s\n", pxshot_last_error());
+        return 1;
+    }
+    
+    pxshot_request* request = NULL;
+    pxshot_status status = pxshot_client_submit(
+        client, "{\"url\": \"https://example.com\", \"format\": \"png\"}",
+        PXSHOT_PRIORITY_INTERACTIVE, &request);
+    if (status != PXSHOT_OK) {
+        fprintf(stderr, "Error: %s\n", pxshot_last_error());
+        pxshot_client_free(client);
+        return 1;
+    }
+    
+    /* An event loop would call pxshot_request_poll() from its idle handler */
+    pxshot_result* result = NULL;
+    while ((status = pxshot_request_wait(request, 100, &result)) == PXSHOT_PENDING) {
+        printf("waiting...\n");
+    }
+    pxshot_request_free(request);
+    if (status != PXSHOT_OK) {
+        fprintf(stderr, "Error (%d): %s\n", (int)status, pxshot_last_error());
+        pxshot_client_free(client);
+        return 1;
+    }
+    
+    pxshot_buffer image;
+    if (pxshot_result_export(result, &image) == PXSHOT_OK) {
+        FILE* file = fopen("screenshot.png", "wb");
+        if (file) {
+            fwrite(image.data, 1, image.size, file);
+            fclose(file);
+            printf("Saved %zu bytes to screenshot.png\n", image.size);
+        }
+        image.release(&image);
+    }
+    
+    pxshot_result_free(result);
+    pxshot_client_free(client);
+    return 0;
+}
@@ -0,0 +1,166 @@
+/// Cache Replay Benchmark
+/// Replay synthetic request traces through clients with the LRU and the
+/// TinyLFU result cache, against an in-process mock server that answers
+/// each capture with an image whose size depends on the page.
+///
+/// Interactive traffic requests pages with Zipf-like popularity. Each
+/// simulated day can end with a batch sweep of one-off pages, which under
+/// LRU evicts what interactive traffic was reusing. A loop over more
+/// pages than fit in the cache shows the other recency-hostile pattern.
+/// Every miss costs a render, counted by the server.
+///
+/// Usage: cache_replay_benchmark [days] [cache_megabytes]
+
+#include <pxshot/pxshot.hpp>
+
+#include "mock_server.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+constexpr int kPages = 20000;           // Distinct interactive pages
+constexpr int kRequestsPerDay = 20000;  // Interactive requests per day
+
+/// Answers every capture with an image/png body of 2-20 KB, the size
+/// picked by the request body so repeats of a page get the same size, and
+/// counts the captures rendered
+class Renderer {
+public:
+    mock::Response handle(const mock::Request& request) {
+        ++renders_;
+        size_t size = 2000 + std::hash<std::string>{}(request.body) % 18000;
+        return mock::image(std::string_view(image_).substr(0, size));
+    }
+    
+    /// Captures rendered so far
+    int64_t renders() const { return renders_.load(); }
+
+private:
+    std::string image_ = std::string(20000, '\x89');
+    std::atomic<int64_t> renders_{0};
+};
+
+struct Request {
+    std::string url;
+    bool interactive;
+};
+
+/// Requests of `days` days: Zipf-like interactive traffic, each day
+/// followed by a sweep of `sweep` one-off pages
+std::vector<Request> daily_trace(int days, int sweep) {
+    std::vector<double> weights(kPages);
+    for (int i = 0; i < kPages; ++i) {
+        weights[static_cast<size_t>(i)] = 1 / std::pow(i + 1, 0.9);
+    }
+    std::discrete_distribution<int> popularity(weights.begin(), weights.end());
+    std::mt19937_64 rng(42);
+    
+    std::vector<Request> trace;
+    int one_off = 0;
+    for (int day = 0; day < days; ++day) {
+        for (int i = 0; i < kRequestsPerDay; ++i) {
+            trace.push_back({"https://example.com/page/" + std::to_string(popularity(rng)), true});
+        }
+        for (int i = 0; i < sweep; ++i) {
+            trace.push_back({"https://example.com/batch/" + std::to_string(one_off++), false});
+        }
+    }
+    return trace;
+}
+
+/// `rounds` passes over `pages` pages in the same order
+std::vector<Request> loop_trace(int pages, int rounds) {
+    std::vector<Request> trace;
+    for (int round = 0; round < rounds; ++round) {
+        for (int i = 0; i < pages; ++i) {
+            trace.push_back({"https://example.com/page/" + std::to_string(i), true});
+        }
+    }
+    return trace;
+}
+
+void replay(const mock::Server& server, const Renderer& renderer, const std::vector<Request>& trace,
+            int64_t cache_bytes, pxshot::CachePolicy policy) {
+    pxshot::Client client(pxshot::ClientConfig{
+        .api_key = "px_benchmark",
+        .base_url = server.url(),
+        .result_cache_bytes = cache_bytes,
+        .result_cache_ttl = std::chrono::hours(24 * 365),
+        .result_cache_policy = policy
+    });
+    
+    int64_t interactive = 0;
+    int64_t interactive_hits = 0;
+    int64_t renders = renderer.renders();
+    auto start = Clock::now();
+    for (const auto& request : trace) {
+        auto rendered = renderer.renders();
+        (void)client.screenshot({.url = request.url});
+        if (request.interactive) {
+            ++interactive;
+            interactive_hits += renderer.renders() == rendered;
+        }
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    
+    auto stats = client.stats();
+    auto total = static_cast<double>(trace.size());
+    std::cout << "    " << std::left << std::setw(8) << pxshot::to_string(policy) << std::right << std::fixed
+              << std::setprecision(1) << std::setw(5) << 100.0 * static_cast<double>(stats.cache_hits) / total
+              << "% hits, interactive " << std::setw(5)
+              << (interactive > 0 ? 100.0 * static_cast<double>(interactive_hits) / static_cast<double>(interactive) : 0)
+              << "%, " << renderer.renders() - renders << " renders, " << stats.cache_rejected << " rejected, "
+              << std::setprecision(0) << total / seconds << " req/s\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int days = argc > 1 ? std::atoi(argv[1]) : 3;
+    int64_t megabytes = argc > 2 ? std::atoll(argv[2]) : 16;
+    
+    try {
+        Renderer renderer;
+        mock::Server server([&](const mock::Request& request) { return renderer.handle(request); });
+        int64_t cache_bytes = megabytes * 1024 * 1024;
+        // Pages average 11 KB, so the loop is about twice the cache
+        int loop_pages = static_cast<int>(cache_bytes / 11000 * 2);
+        
+        struct Workload {
+            std::string name;
+            std::vector<Request> trace;
+        };
+        std::vector<Workload> workloads;
+        workloads.push_back({"interactive only", daily_trace(days, 0)});
+        workloads.push_back({"interactive + nightly sweeps of 10k one-offs", daily_trace(days, 10000)});
+        workloads.push_back({"interactive + nightly sweeps of 30k one-offs", daily_trace(days, 30000)});
+        workloads.push_back({"loop over " + std::to_string(loop_pages) + " pages", loop_trace(loop_pages, 5)});
+        
+        std::cout << days << " days of " << kRequestsPerDay << " interactive requests over " << kPages
+                  << " pages, " << megabytes << " MB cache\n";
+        for (const auto& workload : workloads) {
+            std::cout << "\n  " << workload.name << " (" << workload.trace.size() << " requests)\n";
+            for (auto policy : {pxshot::CachePolicy::Lru, pxshot::CachePolicy::TinyLfu}) {
+                replay(server, renderer, workload.trace, cache_bytes, policy);
+            }
+        }
+    } catch (const pxshot::Error& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+    
+    return 0;
+}
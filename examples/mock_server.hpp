@@ -0,0 +1,209 @@
+/// Mock Server
+/// Keep-alive HTTP/1.1 server on a loopback port, standing in for the API
+/// (or S3) in the benchmarks, examples and tests. Each request is answered
+/// with whatever a handler returns. POSIX sockets only.
+
+#pragma once
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace mock {
+
+struct Request {
+    std::string method;
+    std::string path;           // Without the query
+    std::string query;
+    std::string body;
+    int connection = 0;         // Numbered in order of acceptance
+};
+
+struct Response {
+    int status = 200;
+    std::string headers;        // Extra header lines, each ending in \r\n
+    std::string body;
+    std::string_view borrowed_body;                 // Sent instead of body if set; must outlive the server
+    std::chrono::steady_clock::time_point send_at;  // Not before this; responses still leave in order
+};
+
+/// A capture's image/png response, sending `body` without copying it
+inline Response image(std::string_view body) {
+    Response response;
+    response.headers = "Content-Type: image/png\r\n";
+    response.borrowed_body = body;
+    return response;
+}
+
+/// Calls `handler` for each request, from one thread per connection, so
+/// the handler must be safe to call concurrently. Requests pipelined on a
+/// connection are read and handled while earlier responses wait to be sent.
+class Server {
+public:
+    using Handler = std::function<Response(const Request&)>;
+    
+    explicit Server(Handler handler) : handler_(std::move(handler)) {
+        listen_fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+        int one = 1;
+        setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+        listen(listen_fd_, 64);
+        socklen_t len = sizeof(addr);
+        getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&addr), &len);
+        port_ = ntohs(addr.sin_port);
+        acceptor_ = std::thread([this] { accept_loop(); });
+    }
+    
+    /// Waits for clients to close their connections
+    ~Server() {
+        stopping_ = true;
+        ::shutdown(listen_fd_, SHUT_RDWR);
+        ::close(listen_fd_);
+        acceptor_.join();
+        for (auto& t : connections_) {
+            t.join();
+        }
+    }
+    
+    Server(const Server&) = delete;
+    Server& operator=(const Server&) = delete;
+    
+    int port() const { return port_; }
+    std::string url() const { return "http://127.0.0.1:" + std::to_string(port_); }
+
+private:
+    Handler handler_;
+    int listen_fd_ = -1;
+    int port_ = 0;
+    std::atomic<bool> stopping_{false};
+    std::thread acceptor_;
+    std::vector<std::thread> connections_;
+    
+    void accept_loop() {
+        while (!stopping_) {
+            int fd = ::accept(listen_fd_, nullptr, nullptr);
+            if (fd < 0) {
+                return;
+            }
+            int one = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));    // Head and body go out separately
+            int connection = static_cast<int>(connections_.size());
+            connections_.emplace_back([this, fd, connection] { serve(fd, connection); });
+        }
+    }
+    
+    static bool send_all(int fd, std::string_view data) {
+        while (!data.empty()) {
+            ssize_t n = ::send(fd, data.data(), data.size(), MSG_NOSIGNAL);
+            if (n <= 0) {
+                return false;
+            }
+            data.remove_prefix(static_cast<size_t>(n));
+        }
+        return true;
+    }
+    
+    void serve(int fd, int connection) {
+        std::mutex mutex;
+        std::condition_variable cv;
+        std::deque<Response> outgoing;
+        bool done = false;
+        
+        // Sends responses in order, each once its time has come, without
+        // holding up reading and handling of later requests
+        std::thread writer([&] {
+            std::unique_lock<std::mutex> lock(mutex);
+            for (;;) {
+                cv.wait(lock, [&] { return done || !outgoing.empty(); });
+                if (outgoing.empty()) {
+                    return;
+                }
+                auto next = std::move(outgoing.front());
+                outgoing.pop_front();
+                lock.unlock();
+                std::this_thread::sleep_until(next.send_at);
+                auto body = next.borrowed_body.data() ? next.borrowed_body : std::string_view(next.body);
+                std::string head = "HTTP/1.1 " + std::to_string(next.status) +
+                                   (next.status < 400 ? " OK\r\n" : " Error\r\n") + next.headers +
+                                   "Content-Length: " + std::to_string(body.size()) + "\r\n\r\n";
+                bool sent = send_all(fd, head) && send_all(fd, body);
+                lock.lock();
+                if (!sent) {
+                    outgoing.clear();
+                    done = true;
+                    ::shutdown(fd, SHUT_RD);    // Stop the reader too
+                    return;
+                }
+            }
+        });
+        
+        std::string buffer;
+        char chunk[65536];
+        for (;;) {
+            auto header_end = buffer.find("\r\n\r\n");
+            size_t length = 0;
+            if (header_end != std::string::npos) {
+                auto cl = buffer.find("Content-Length: ");
+                if (cl != std::string::npos && cl < header_end) {
+                    length = std::strtoul(buffer.c_str() + cl + 16, nullptr, 10);
+                }
+            }
+            if (header_end == std::string::npos || buffer.size() < header_end + 4 + length) {
+                ssize_t n = ::recv(fd, chunk, sizeof(chunk), 0);
+                if (n <= 0) {
+                    break;
+                }
+                buffer.append(chunk, static_cast<size_t>(n));
+                continue;
+            }
+            
+            Request request;
+            auto line_end = buffer.find("\r\n");
+            auto space = buffer.find(' ');
+            auto target = buffer.substr(space + 1, buffer.rfind(' ', line_end) - space - 1);
+            request.method = buffer.substr(0, space);
+            request.path = target.substr(0, target.find('?'));
+            if (auto q = target.find('?'); q != std::string::npos) {
+                request.query = target.substr(q + 1);
+            }
+            request.body = buffer.substr(header_end + 4, length);
+            request.connection = connection;
+            buffer.erase(0, header_end + 4 + length);
+            
+            auto response = handler_(request);
+            std::lock_guard<std::mutex> lock(mutex);
+            if (done) {
+                break;
+            }
+            outgoing.push_back(std::move(response));
+            cv.notify_one();
+        }
+        
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            done = true;
+        }
+        cv.notify_one();
+        writer.join();
+        ::close(fd);
+    }
+};
+
+} // namespace mock
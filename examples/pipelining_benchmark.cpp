@@ -0,0 +1,103 @@
+/// Pipelining Benchmark
+/// Compare stored-mode throughput with and without HTTP/1.1 pipelining
+/// against an in-process mock server that supports pipelining.
+///
+/// The mock adds a one-way network delay to every request and response
+/// and renders each connection's requests one after another, so the
+/// difference between the runs is the round trips pipelining saves.
+///
+/// Usage: pipelining_benchmark [requests] [one_way_delay_ms] [render_ms]
+
+#include <pxshot/pxshot.hpp>
+
+#include "mock_server.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+/// Answers POST /v1/screenshot with a stored screenshot document. Each
+/// request and response takes a one-way network delay, and each
+/// connection renders its requests one after another.
+class Renderer {
+public:
+    Renderer(std::chrono::milliseconds one_way_delay, std::chrono::milliseconds render)
+        : delay_(one_way_delay), render_(render) {}
+
+    mock::Response handle(const mock::Request& request) {
+        auto visible = Clock::now() + delay_;
+        mock::Response response;
+        response.headers = "Content-Type: application/json\r\n";
+        response.body = R"({"url":"https://storage.example/shot.png",)"
+                        R"("expires_at":"2030-01-01T00:00:00Z","width":1280,)"
+                        R"("height":720,"size_bytes":123456})";
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto& render_free = render_free_[request.connection];
+        render_free = std::max(render_free, visible) + render_;
+        response.send_at = render_free + delay_;
+        return response;
+    }
+
+private:
+    std::chrono::milliseconds delay_;
+    std::chrono::milliseconds render_;
+    std::mutex mutex_;
+    std::map<int, Clock::time_point> render_free_;     // By connection
+};
+
+double run(int port, int depth, int requests) {
+    pxshot::Client client(pxshot::ClientConfig{
+        .api_key = "px_benchmark",
+        .base_url = "http://127.0.0.1:" + std::to_string(port),
+        .max_concurrency = 1,
+        .pipeline_depth = depth
+    });
+
+    std::vector<pxshot::ScreenshotOptions> batch;
+    for (int i = 0; i < requests; ++i) {
+        batch.push_back({.url = "https://example.com/page/" + std::to_string(i), .store = true});
+    }
+
+    auto start = Clock::now();
+    for (auto& future : client.submit_batch(std::move(batch))) {
+        (void)future.get();
+    }
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int requests = argc > 1 ? std::atoi(argv[1]) : 64;
+    int delay_ms = argc > 2 ? std::atoi(argv[2]) : 20;
+    int render_ms = argc > 3 ? std::atoi(argv[3]) : 5;
+
+    try {
+        Renderer renderer{std::chrono::milliseconds(delay_ms), std::chrono::milliseconds(render_ms)};
+        mock::Server server([&](const mock::Request& request) { return renderer.handle(request); });
+
+        std::cout << requests << " stored-mode requests, " << delay_ms << " ms one-way delay, "
+                  << render_ms << " ms render\n\n";
+
+        for (int depth : {1, 4, 8, 16}) {
+            double seconds = run(server.port(), depth, requests);
+            std::cout << "  pipeline_depth " << depth << ": " << seconds * 1000 << " ms ("
+                      << requests / seconds << " req/s)\n";
+        }
+    } catch (const pxshot::Error& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,131 @@
+/// S3 Stand-In
+/// Just enough of the S3 API for PutObject and multipart uploads, keeping
+/// objects in memory, for the S3 upload example and tests. Serve it with a
+/// mock::Server. Signatures are not checked.
+
+#pragma once
+
+#include "mock_server.hpp"
+
+#include <map>
+#include <mutex>
+#include <string>
+
+namespace mock {
+
+class S3StandIn {
+public:
+    Response handle(const Request& request) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto upload_id = query_value(request.query, "uploadId");
+        
+        if (request.method == "POST" && request.query.rfind("uploads", 0) == 0) {
+            auto id = "upload-" + std::to_string(++next_id_);
+            uploads_[id];
+            return reply(200, "", "<InitiateMultipartUploadResult><UploadId>" + id +
+                                  "</UploadId></InitiateMultipartUploadResult>");
+        }
+        if (request.method == "PUT" && !upload_id.empty()) {
+            auto part = std::stoi(query_value(request.query, "partNumber"));
+            ++part_requests_;
+            if (auto failure = failures_.find(part); failure != failures_.end() && failure->second.times != 0) {
+                --failure->second.times;
+                return reply(failure->second.status, "", "<Error><Code>InjectedFailure</Code></Error>");
+            }
+            uploads_[upload_id][part] = request.body;
+            return reply(200, "ETag: \"part-" + std::to_string(part) + "\"\r\n", "");
+        }
+        if (request.method == "POST" && !upload_id.empty()) {
+            std::string object;
+            for (auto& [number, data] : uploads_[upload_id]) {
+                object += data;
+            }
+            uploads_.erase(upload_id);
+            objects_[request.path] = std::move(object);
+            return reply(200, "", "<CompleteMultipartUploadResult><ETag>\"multipart\"</ETag>"
+                                  "</CompleteMultipartUploadResult>");
+        }
+        if (request.method == "DELETE") {
+            uploads_.erase(upload_id);
+            ++aborted_;
+            return reply(204, "", "");
+        }
+        if (request.method == "PUT") {
+            objects_[request.path] = request.body;
+            return reply(200, "ETag: \"single\"\r\n", "");
+        }
+        return reply(400, "", "<Error><Code>NotImplemented</Code></Error>");
+    }
+    
+    /// Stored object at `path` ("/bucket/key"); empty if there is none
+    std::string object(const std::string& path) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = objects_.find(path);
+        return it == objects_.end() ? std::string() : it->second;
+    }
+    
+    /// Answer the next `times` uploads of part `part` (every one, if
+    /// negative) with HTTP `status`
+    void fail_part(int part, int status, int times = -1) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        failures_[part] = {status, times};
+    }
+    
+    /// Multipart uploads started and neither completed nor aborted
+    size_t open_uploads() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return uploads_.size();
+    }
+    
+    int aborted() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return aborted_;
+    }
+    
+    /// Part uploads received, failed ones included
+    int part_requests() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return part_requests_;
+    }
+
+private:
+    struct Failure {
+        int status;
+        int times;
+    };
+    
+    std::mutex mutex_;
+    int next_id_ = 0;
+    int aborted_ = 0;
+    int part_requests_ = 0;
+    std::map<std::string, std::map<int, std::string>> uploads_;
+    std::map<std::string, std::string> objects_;
+    std::map<int, Failure> failures_;
+    
+    static Response reply(int status, std::string headers, std::string body) {
+        Response response;
+        response.status = status;
+        response.headers = std::move(headers);
+        response.body = std::move(body);
+        return response;
+    }
+    
+    /// Value of `name` in a query string ("" if absent)
+    static std::string query_value(const std::string& query, const std::string& name) {
+        size_t pos = 0;
+        while (pos <= query.size()) {
+            auto end = query.find('&', pos);
+            auto item = query.substr(pos, end == std::string::npos ? std::string::npos : end - pos);
+            if (item.compare(0, name.size() + 1, name + "=") == 0) {
+                return item.substr(name.size() + 1);
+            }
+            if (end == std::string::npos) {
+                break;
+            }
+            pos = end + 1;
+        }
+        return {};
+    }
+};
+
+} // namespace mock
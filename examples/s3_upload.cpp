@@ -0,0 +1,93 @@
+/// S3 Upload
+/// Stream captures straight into an S3 bucket as multipart uploads, without
+/// holding whole images in memory. Captures come from an in-process mock
+/// server that returns an image body of the requested size.
+///
+/// By default uploads go to a minimal in-process S3 stand-in, which checks
+/// that every object reassembles to the captured bytes. To use a real
+/// S3-compatible service (AWS, MinIO, ...) set S3_ENDPOINT, S3_BUCKET,
+/// S3_REGION (optional), AWS_ACCESS_KEY_ID and AWS_SECRET_ACCESS_KEY.
+///
+/// Usage: s3_upload [captures] [megabytes]
+
+#include <pxshot/pxshot.hpp>
+
+#include "mock_server.hpp"
+#include "s3_stand_in.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+std::string env(const char* name, const char* fallback = "") {
+    const char* value = std::getenv(name);
+    return value ? value : fallback;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int captures = argc > 1 ? std::atoi(argv[1]) : 4;
+    int megabytes = argc > 2 ? std::atoi(argv[2]) : 40;
+    
+    std::string image(static_cast<size_t>(megabytes) * 1024 * 1024, '\0');
+    for (size_t i = 0; i < image.size(); ++i) {
+        image[i] = static_cast<char>(i * 131 + i / 4096);
+    }
+    
+    try {
+        mock::Server api([&](const mock::Request&) { return mock::image(image); });
+        mock::S3StandIn stand_in;
+        mock::Server s3([&](const mock::Request& request) { return stand_in.handle(request); });
+        
+        bool real_s3 = !env("S3_ENDPOINT").empty();
+        pxshot::S3Target target{
+            .endpoint = real_s3 ? env("S3_ENDPOINT") : s3.url(),
+            .region = env("S3_REGION", "us-east-1"),
+            .bucket = env("S3_BUCKET", "screenshots"),
+            .access_key_id = env("AWS_ACCESS_KEY_ID", "example"),
+            .secret_access_key = env("AWS_SECRET_ACCESS_KEY", "example"),
+            .session_token = env("AWS_SESSION_TOKEN")
+        };
+        
+        pxshot::Client client(pxshot::ClientConfig{
+            .api_key = "px_example",
+            .base_url = api.url()
+        });
+        pxshot::S3Uploader uploader(target);
+        
+        std::cout << captures << " captures of " << megabytes << " MB to "
+                  << target.endpoint << "/" << target.bucket << "\n\n";
+        
+        auto start = Clock::now();
+        for (int i = 0; i < captures; ++i) {
+            auto key = "captures/shot-" + std::to_string(i) + ".png";
+            auto sink = uploader.open(key);
+            client.screenshot_to({.url = "https://example.com"}, *sink);
+            
+            const auto& object = sink->object();
+            std::cout << "  " << object.key << ": " << object.size_bytes << " bytes in "
+                      << object.parts << " parts, ETag " << object.etag;
+            if (!real_s3) {
+                bool intact = stand_in.object("/" + target.bucket + "/" + key) == image;
+                std::cout << (intact ? " (verified)" : " (MISMATCH)");
+                if (!intact) {
+                    return 1;
+                }
+            }
+            std::cout << "\n";
+        }
+        double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        std::cout << "\n" << captures * megabytes / seconds << " MB/s\n";
+    } catch (const pxshot::Error& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+    
+    return 0;
+}
@@ -0,0 +1,107 @@
+/// Submit Benchmark
+/// Measure how long submit() takes and how many captures per second the
+/// client completes when many threads submit at once, against an
+/// in-process mock server that answers every request immediately.
+///
+/// Submitting threads push to the queue shard of the CPU they run on, so
+/// the time per submit() should stay flat as threads are added rather than
+/// grow with contention on a single queue.
+///
+/// Usage: submit_benchmark [threads] [captures per thread] [connections]
+
+#include <pxshot/pxshot.hpp>
+
+#include "mock_server.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+void run(int port, int threads, int captures, int connections) {
+    pxshot::Client client(pxshot::ClientConfig{
+        .api_key = "px_benchmark",
+        .base_url = "http://127.0.0.1:" + std::to_string(port),
+        .max_concurrency = connections
+    });
+    
+    // Warm up the worker connections
+    std::vector<std::future<pxshot::ScreenshotResult>> warmup;
+    for (int i = 0; i < connections; ++i) {
+        warmup.push_back(client.submit({.url = "https://example.com"}, pxshot::Priority::Batch));
+    }
+    for (auto& future : warmup) {
+        future.get();
+    }
+    
+    std::atomic<int64_t> submit_ns{0};
+    std::atomic<int> failed{0};
+    auto start = Clock::now();
+    std::vector<std::thread> submitters;
+    for (int t = 0; t < threads; ++t) {
+        submitters.emplace_back([&, t] {
+            std::vector<std::future<pxshot::ScreenshotResult>> futures;
+            futures.reserve(static_cast<size_t>(captures));
+            auto submitting = Clock::now();
+            for (int i = 0; i < captures; ++i) {
+                futures.push_back(client.submit(
+                    {.url = "https://example.com/" + std::to_string(t) + "/" + std::to_string(i)},
+                    i % 4 == 0 ? pxshot::Priority::Interactive : pxshot::Priority::Batch));
+            }
+            submit_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - submitting).count();
+            for (auto& future : futures) {
+                try {
+                    future.get();
+                } catch (const pxshot::Error&) {
+                    ++failed;
+                }
+            }
+        });
+    }
+    for (auto& submitter : submitters) {
+        submitter.join();
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    int total = threads * captures;
+    
+    std::cout << "  " << threads << (threads == 1 ? " thread:  " : " threads: ")
+              << static_cast<double>(submit_ns) / total << " ns per submit(), "
+              << static_cast<int>(total / seconds) << " captures/s";
+    if (failed > 0) {
+        std::cout << " (" << failed << " failed)";
+    }
+    std::cout << "\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int max_threads = argc > 1 ? std::atoi(argv[1]) :
+                      static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    int captures = argc > 2 ? std::atoi(argv[2]) : 2000;
+    int connections = argc > 3 ? std::atoi(argv[3]) : 8;
+    
+    try {
+        std::string image(2048, '\x89');
+        mock::Server server([&](const mock::Request&) { return mock::image(image); });
+        
+        std::cout << captures << " captures per thread over " << connections << " connections\n\n";
+        for (int threads = 1; threads < max_threads; threads *= 2) {
+            run(server.port(), threads, captures, connections);
+        }
+        run(server.port(), max_threads, captures, connections);
+    } catch (const pxshot::Error& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+    
+    return 0;
+}
@@ -0,0 +1,202 @@
+/* Pxshot C++ SDK - C interface
+ * Stable C ABI over pxshot::Client for use through foreign function
+ * interfaces. All objects are opaque handles; no C++ exception crosses this
+ * boundary. Functions that can fail return a pxshot_status and leave a
+ * description in pxshot_last_error() on the calling thread.
+ *
+ * Options and configuration are passed as JSON objects using the API's
+ * field names, e.g. {"url": "https://example.com", "format": "png"}.
+ *
+ * https://pxshot.com
+ */
+
+#ifndef PXSHOT_H
+#define PXSHOT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Incremented on incompatible changes to this header */
+#define PXSHOT_ABI_VERSION 1
+
+/* ========================================================================== */
+/* Status codes                                                               */
+/* ========================================================================== */
+
+typedef enum pxshot_status {
+    PXSHOT_OK = 0,
+    PXSHOT_PENDING = 1,                 /* Request has not completed yet */
+    PXSHOT_ERROR = -1,                  /* Unclassified failure */
+    PXSHOT_ERROR_INVALID_ARGUMENT = -2, /* Null handle, bad JSON, wrong result kind */
+    PXSHOT_ERROR_VALIDATION = -3,       /* pxshot::ValidationError */
+    PXSHOT_ERROR_HTTP = -4,             /* pxshot::HttpError */
+    PXSHOT_ERROR_API = -5,              /* pxshot::ApiError */
+    PXSHOT_ERROR_CANCELLED = -6,        /* pxshot::CancelledError */
+    PXSHOT_ERROR_HANDOVER = -7,         /* pxshot::HandoverError */
+    PXSHOT_ERROR_OUT_OF_MEMORY = -8
+} pxshot_status;
+
+typedef enum pxshot_priority {
+    PXSHOT_PRIORITY_INTERACTIVE = 0,
+    PXSHOT_PRIORITY_BATCH = 1
+} pxshot_priority;
+
+/* Verdict of the blank page check (pxshot::BlankVerdict) */
+typedef enum pxshot_blank_verdict {
+    PXSHOT_BLANK_NOT_CHECKED = 0,
+    PXSHOT_BLANK_CONTENT = 1,
+    PXSHOT_BLANK_BLANK = 2
+} pxshot_blank_verdict;
+
+/* Flags of pxshot_result_degradation() */
+#define PXSHOT_DEGRADED_DEVICE_SCALE_FACTOR 0x1u
+#define PXSHOT_DEGRADED_FULL_PAGE 0x2u
+#define PXSHOT_DEGRADED_WAIT_UNTIL 0x4u
+#define PXSHOT_DEGRADED_WAIT_FOR_TIMEOUT 0x8u
+
+/* ========================================================================== */
+/* Handles                                                                    */
+/* ========================================================================== */
+
+typedef struct pxshot_client pxshot_client;    /* pxshot::Client */
+typedef struct pxshot_request pxshot_request;  /* A submitted, possibly pending capture */
+typedef struct pxshot_result pxshot_result;    /* A completed capture */
+
+/* Metadata of a stored screenshot. Strings are owned by the result and
+ * valid until it is freed. */
+typedef struct pxshot_stored {
+    const char* url;
+    const char* expires_at;
+    int32_t width;
+    int32_t height;
+    int64_t size_bytes;
+} pxshot_stored;
+
+/* Image bytes handed to the caller without copying. The memory stays valid
+ * until release(buffer) is called, independently of the result it came
+ * from; release must be called exactly once, from any thread. */
+typedef struct pxshot_buffer {
+    const uint8_t* data;
+    size_t size;
+    void (*release)(struct pxshot_buffer* buffer);
+    void* owner;                        /* Internal */
+} pxshot_buffer;
+
+/* ========================================================================== */
+/* Library                                                                    */
+/* ========================================================================== */
+
+/* PXSHOT_ABI_VERSION the library was built with */
+uint32_t pxshot_abi_version(void);
+
+/* SDK version string, e.g. "1.0.0" */
+const char* pxshot_version(void);
+
+/* Description of the last failure on this thread ("" if none). Valid until
+ * the next pxshot_* call on the same thread. */
+const char* pxshot_last_error(void);
+
+/* ========================================================================== */
+/* Client                                                                     */
+/* ========================================================================== */
+
+/* Create a client with default configuration */
+pxshot_status pxshot_client_new(const char* api_key, pxshot_client** out);
+
+/* Create a client from a JSON object with ClientConfig field names:
+ * api_key (required), base_url, timeout_seconds, user_agent,
+ * max_concurrency, adaptive_timeouts, max_output_pixels, strict_preflight,
+ * memory_budget_bytes, pipeline_depth, buffer_pool_bytes, result_cache_bytes,
+ * result_cache_ttl (seconds), result_cache_policy ("lru" or "tinylfu"),
+ * proxy, tcp_info_sample_rate, tcp_fast_open, tls_early_data, tuning_file,
+ * handle_fork, bandwidth as {"bytes_per_second", "interactive_share",
+ * "batch_share"}, degradation as {"error_window", "rules":
+ * [{"queue_wait_ms", "error_rate", "max_device_scale_factor",
+ * "disable_full_page", "wait_until", "max_wait_for_timeout"}, ...]}, and
+ * blank_detection as {"enabled", "max_variance", "min_dominant_share",
+ * "tolerance", "action" ("flag" or "retry"), "retries"}. */
+pxshot_status pxshot_client_new_with_config(const char* config_json, pxshot_client** out);
+
+/* pxshot::Client::shared(): a handle to the process-wide client for a
+ * configuration (as pxshot_client_new_with_config), created on first use.
+ * Each handle is freed with pxshot_client_free; the client is destroyed
+ * with the last one, including handles obtained from C++. */
+pxshot_status pxshot_client_new_shared(const char* config_json, pxshot_client** out);
+
+/* Destroy a client, or release a shared handle. Pending requests fail when
+ * the client is destroyed; their handles must still be freed. Null is
+ * ignored. */
+void pxshot_client_free(pxshot_client* client);
+
+/* pxshot::Client::after_fork() */
+void pxshot_client_after_fork(pxshot_client* client);
+
+/* pxshot::Client::tune() from a JSON object with Tuning field names:
+ * max_concurrency, memory_budget_bytes, bandwidth, buffer_pool_bytes,
+ * result_cache_bytes. Absent fields keep their current value. */
+pxshot_status pxshot_client_tune(pxshot_client* client, const char* tuning_json);
+
+/* Capture synchronously. On success *out receives a result to free. */
+pxshot_status pxshot_client_screenshot(pxshot_client* client, const char* options_json,
+                                       pxshot_result** out);
+
+/* Queue a capture on the client's worker connections. On success *out
+ * receives a request handle to poll or wait on and then free. */
+pxshot_status pxshot_client_submit(pxshot_client* client, const char* options_json,
+                                   pxshot_priority priority, pxshot_request** out);
+
+/* ========================================================================== */
+/* Requests                                                                   */
+/* ========================================================================== */
+
+/* Non-blocking: PXSHOT_PENDING while the capture runs, then PXSHOT_OK with
+ * *out set, or the capture's error. The outcome is delivered once; later
+ * calls return PXSHOT_ERROR_INVALID_ARGUMENT. */
+pxshot_status pxshot_request_poll(pxshot_request* request, pxshot_result** out);
+
+/* As pxshot_request_poll(), blocking for up to timeout_ms (negative waits
+ * indefinitely). */
+pxshot_status pxshot_request_wait(pxshot_request* request, int64_t timeout_ms,
+                                  pxshot_result** out);
+
+/* Free a request handle. A capture still running completes and its result
+ * is discarded. Null is ignored. */
+void pxshot_request_free(pxshot_request* request);
+
+/* ========================================================================== */
+/* Results                                                                    */
+/* ========================================================================== */
+
+/* Non-zero if the result is a stored screenshot rather than image bytes */
+int pxshot_result_is_stored(const pxshot_result* result);
+
+/* Options relaxed under overload (pxshot::ScreenshotResult::degradation()),
+ * as PXSHOT_DEGRADED_* flags; 0 if the capture is as requested */
+uint32_t pxshot_result_degradation(const pxshot_result* result);
+
+/* Whether the capture came back blank (pxshot::ScreenshotResult::blank()) */
+pxshot_blank_verdict pxshot_result_blank(const pxshot_result* result);
+
+/* Metadata of a stored screenshot */
+pxshot_status pxshot_result_stored(const pxshot_result* result, pxshot_stored* out);
+
+/* Borrow the image bytes; valid until the result is freed or its bytes are
+ * exported */
+pxshot_status pxshot_result_bytes(const pxshot_result* result, const uint8_t** data, size_t* size);
+
+/* Hand the image bytes to a caller-owned buffer, with no copy, even when
+ * the result cache shares them. Afterwards the result holds no bytes. */
+pxshot_status pxshot_result_export(pxshot_result* result, pxshot_buffer* out);
+
+/* Destroy a result. Exported buffers remain valid. Null is ignored. */
+void pxshot_result_free(pxshot_result* result);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* PXSHOT_H */
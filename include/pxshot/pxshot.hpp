@@ -10,7 +10,14 @@
 #include <vector>
 #include <optional>
 #include <stdexcept>
+#include <exception>
+#include <memory>
+#include <chrono>
+#include <future>
+#include <functional>
 #include <cstdint>
+#include <array>
+#include <atomic>
 
 namespace pxshot {
 
@@ -49,6 +56,19 @@ public:
         : Error(message), error_code(code) {}
 };
 
+/// Transfer aborted by a progress handler
+class CancelledError : public Error {
+public:
+    explicit CancelledError(const std::string& message) : Error(message) {}
+};
+
+/// Request was not sent because Client::drain() handed it over, or, in a
+/// forked child, because it was queued in the parent
+class HandoverError : public Error {
+public:
+    explicit HandoverError(const std::string& message) : Error(message) {}
+};
+
 /// Invalid parameters
 class ValidationError : public Error {
 public:
@@ -74,6 +94,40 @@ enum class WaitUntil {
     Commit          // first network response
 };
 
+/// Scheduling class for queued requests
+enum class Priority {
+    Interactive,    // latency-sensitive: shortest expected job first
+    Batch           // throughput work: first in, first out
+};
+
+/// Severity of a log record
+enum class LogLevel {
+    Debug,          // every request as it is sent
+    Info,           // completed requests and client events
+    Warning,        // slow requests and degraded operation
+    Error           // failed requests
+};
+
+/// What the blank page check made of a result
+enum class BlankVerdict {
+    NotChecked,     // Check off, stored result, or an image it cannot decode
+    Content,
+    Blank           // Nearly one colour throughout
+};
+
+/// What happens to a capture found blank
+enum class BlankAction {
+    Flag,           // Return it, marked by ScreenshotResult::blank()
+    Retry           // Capture again, up to BlankDetection::retries times
+};
+
+/// Which results the result cache keeps when it is full
+enum class CachePolicy {
+    Lru,            // Evict the least recently used
+    TinyLfu         // Admit only results requested more often than those
+                    // they would evict, so one-off requests cannot flush it
+};
+
 /// Screenshot request options
 struct ScreenshotOptions {
     std::string url;                                    // Required: URL to capture
@@ -99,14 +153,69 @@ struct StoredScreenshot {
     int64_t size_bytes;         // File size in bytes
 };
 
+/// The kernel's view of a TCP connection (Linux TCP_INFO). Counters cover
+/// the connection's life, not just one request. The congestion window and
+/// delivery rate describe the sending side (requests); a slow download
+/// shows up as a high RTT, retransmits or a low receive rate.
+struct TcpInfo {
+    std::chrono::microseconds rtt{0};               // Smoothed round-trip time
+    std::chrono::microseconds rtt_variance{0};
+    std::chrono::microseconds receive_rtt{0};       // Estimated while receiving (0 until measured)
+    uint32_t congestion_window = 0;                 // Segments
+    uint32_t mss = 0;                               // Bytes per segment sent
+    uint32_t retransmits = 0;                       // Segments sent again
+    uint32_t segments_out = 0;                      // Segments sent
+    uint64_t delivery_rate = 0;                     // Bytes per second, as the kernel estimates
+    uint64_t bytes_received = 0;
+};
+
+/// Where the time of one request went. Connection phases are zero when a
+/// kept-alive connection was reused, and for plain-http connections made
+/// through cpp-httplib, which does not expose them.
+struct RequestTimings {
+    std::chrono::microseconds queued{0};            // Waiting for a worker (submit() only)
+    std::chrono::microseconds proxy_connect{0};     // TCP to the proxy and its CONNECT reply
+    std::chrono::microseconds connect{0};           // TCP to the API, when direct
+    std::chrono::microseconds tls_handshake{0};
+    std::chrono::microseconds first_byte{0};        // Until the response headers arrived
+    std::chrono::microseconds total{0};             // Until the body was complete
+    bool reused_connection = false;
+    std::optional<TcpInfo> tcp;                     // Sampled after the response, at
+                                                    // ClientConfig::tcp_info_sample_rate
+};
+
+/// Options a request had relaxed by ClientConfig::degradation
+struct Degradation {
+    bool device_scale_factor = false;   // Lowered to a rule's cap
+    bool full_page = false;             // Switched off
+    bool wait_until = false;            // Replaced by a lighter condition
+    bool wait_for_timeout = false;      // Shortened to a rule's cap
+    
+    /// Whether anything was relaxed
+    [[nodiscard]] bool any() const noexcept {
+        return device_scale_factor || full_page || wait_until || wait_for_timeout;
+    }
+};
+
+/// Blank page check of a result, measured on a downsampled preview
+struct BlankCheck {
+    BlankVerdict verdict = BlankVerdict::NotChecked;
+    double luma_variance = 0;           // On a 0-255 scale
+    uint32_t dominant_color = 0;        // Most common colour, 0xRRGGBB
+    double dominant_share = 0;          // Fraction of pixels within tolerance of it
+};
+
 /// Screenshot result (either bytes or stored URL)
+/// Image bytes are immutable and reference-counted: copying a result is
+/// O(1), copies share one buffer, which is freed with the last of them,
+/// and copies may be used from different threads.
 class ScreenshotResult {
 public:
     /// Check if result contains stored screenshot (URL)
     [[nodiscard]] bool is_stored() const noexcept { return stored_.has_value(); }
     
     /// Check if result contains raw image bytes
-    [[nodiscard]] bool is_bytes() const noexcept { return !bytes_.empty(); }
+    [[nodiscard]] bool is_bytes() const noexcept { return bytes_ && !bytes_->empty(); }
     
     /// Get stored screenshot info (throws if not stored)
     [[nodiscard]] const StoredScreenshot& stored() const {
@@ -118,18 +227,41 @@ public:
     
     /// Get raw image bytes (throws if stored)
     [[nodiscard]] const std::vector<uint8_t>& bytes() const {
+        if (stored_) {
+            throw Error("Screenshot was stored - use stored() instead");
+        }
+        static const std::vector<uint8_t> empty;
+        return bytes_ ? *bytes_ : empty;
+    }
+    
+    /// Get raw image bytes as a shared buffer that stays valid on its own,
+    /// for handing to other consumers without a copy (throws if stored;
+    /// null once the bytes were taken)
+    [[nodiscard]] std::shared_ptr<const std::vector<uint8_t>> shared_bytes() const {
         if (stored_) {
             throw Error("Screenshot was stored - use stored() instead");
         }
         return bytes_;
     }
     
-    /// Get raw bytes, moving them out
+    /// Get raw bytes, moving them out if this result is their only holder
+    /// and copying them if other copies share them. Either way this result
+    /// holds no bytes afterwards.
     [[nodiscard]] std::vector<uint8_t> take_bytes() {
         if (stored_) {
             throw Error("Screenshot was stored - use stored() instead");
         }
-        return std::move(bytes_);
+        auto bytes = std::move(bytes_);
+        if (!bytes) {
+            return {};
+        }
+        if (bytes.use_count() == 1) {
+            // Pairs with the release of the last other holder, so its reads
+            // are done before the buffer changes hands
+            std::atomic_thread_fence(std::memory_order_acquire);
+            return std::move(*bytes);
+        }
+        return *bytes;
     }
     
     // Convenience accessors for stored screenshots
@@ -138,17 +270,146 @@ public:
     [[nodiscard]] int width() const { return stored().width; }
     [[nodiscard]] int height() const { return stored().height; }
     [[nodiscard]] int64_t size_bytes() const { return stored().size_bytes; }
+    
+    /// How long the request took, by phase (all zero for cached results)
+    [[nodiscard]] const RequestTimings& timings() const noexcept { return timings_; }
+    
+    /// Options the client relaxed because it was overloaded; the capture
+    /// is cheaper than the one requested when any() is true
+    [[nodiscard]] const Degradation& degradation() const noexcept { return degradation_; }
+    
+    /// Whether the capture came back blank (ClientConfig::blank_detection)
+    [[nodiscard]] const BlankCheck& blank() const noexcept { return blank_; }
 
 private:
     friend class Client;
     
-    std::vector<uint8_t> bytes_;
+    std::shared_ptr<std::vector<uint8_t>> bytes_;  // Never modified while shared
     std::optional<StoredScreenshot> stored_;
+    RequestTimings timings_;
+    Degradation degradation_;
+    BlankCheck blank_;
     
-    explicit ScreenshotResult(std::vector<uint8_t> data) : bytes_(std::move(data)) {}
+    explicit ScreenshotResult(std::vector<uint8_t> data)
+        : bytes_(std::make_shared<std::vector<uint8_t>>(std::move(data))) {}
     explicit ScreenshotResult(StoredScreenshot info) : stored_(std::move(info)) {}
 };
 
+/// Predicted cost of a request, learned from completed requests per host
+struct CostEstimate {
+    std::chrono::milliseconds latency;  // Expected time to complete
+    std::chrono::milliseconds stddev;   // Spread of observed latency
+    int64_t bytes;                      // Expected response size
+    int samples;                        // Observations for this host (0 = no history yet)
+};
+
+/// Live progress of a screenshot download
+struct TransferProgress {
+    uint64_t bytes_received;                // Body bytes received so far
+    std::optional<uint64_t> expected_bytes; // From Content-Length, if sent
+    double bytes_per_second;                // Throughput since the first byte
+    std::chrono::milliseconds elapsed;      // Time since the request was sent
+};
+
+/// Progress observer; return false to cancel the transfer
+using ProgressHandler = std::function<bool(const TransferProgress&)>;
+
+/// Receives a screenshot body as it arrives; see Client::screenshot_to()
+class ResultSink {
+public:
+    virtual ~ResultSink() = default;
+    
+    /// The response headers are in; called once, before any data
+    virtual void begin(std::string_view content_type, std::optional<uint64_t> content_length) = 0;
+    
+    /// The next bytes of the body, called on the receive path. Blocking
+    /// here slows the sender down through TCP flow control.
+    virtual void write(const uint8_t* data, size_t size) = 0;
+    
+    /// The whole body has been written
+    virtual void finish() = 0;
+    
+    /// The transfer failed after begin(); discard what was written
+    virtual void abort() noexcept = 0;
+};
+
+/// Result of checking a request locally before it is sent
+struct PreflightReport {
+    std::vector<std::string> errors;    // Problems that would fail or waste a render
+    std::vector<std::string> warnings;  // Likely costly mistakes
+    int64_t estimated_pixels;           // Output pixel count
+    int64_t estimated_bytes;            // Expected response size
+    
+    /// True when the request would be sent
+    [[nodiscard]] bool ok() const noexcept { return errors.empty(); }
+};
+
+/// Outcome of Client::drain()
+struct DrainResult {
+    int completed = 0;          // In-flight requests that finished before the deadline
+    int interrupted = 0;        // In-flight requests cut off at the deadline
+    int handed_over = 0;        // Requests recorded in `handover`
+    std::string handover;       // Unfinished requests, for Client::resume() elsewhere
+};
+
+/// Summary of a streamed distribution. Quantiles come from a log-bucketed
+/// sketch and are accurate to within about 6%.
+struct Distribution {
+    uint64_t count = 0;
+    double mean = 0;
+    double p50 = 0;
+    double p90 = 0;
+    double p99 = 0;
+    double max = 0;
+};
+
+/// How requests to one target host fared
+struct HostStats {
+    std::string host;                   // Target host of the captured URL
+    uint64_t requests = 0;              // Requests that finished, successfully or not
+    uint64_t failures = 0;              // Of those, the ones that produced no result
+    uint64_t retries = 0;               // Requests resent after going unanswered
+    Distribution latency_ms;            // Of successful requests
+    Distribution bytes;                 // Image size of successful requests
+    std::vector<std::pair<std::string, uint64_t>> errors;  // Failure label -> count,
+                                                           // most frequent first
+    double total_ms = 0;                // Time spent on all requests
+    double wasted_ms = 0;               // Time spent on requests that failed
+};
+
+/// Per-host performance since the client was created or last reset
+struct HostReport {
+    std::chrono::system_clock::time_point since;
+    std::vector<HostStats> hosts;       // Most total time first
+};
+
+/// An entry in a client's flight recorder
+struct FlightEvent {
+    std::chrono::system_clock::time_point time;
+    std::string message;        // e.g. "tune(): max_concurrency 4 -> 8"
+};
+
+/// A structured log record. The views are valid only for the duration of
+/// the LogHandler call.
+struct LogRecord {
+    std::chrono::system_clock::time_point time;
+    LogLevel level;
+    std::string_view event;     // "send", "done", "slow", "failed", or "client" for client events
+    std::string_view url;       // Captured URL, truncated to 256 bytes
+    std::string_view host;      // Target host of the URL
+    Priority priority;
+    int status;                 // HTTP status, 0 if none was received
+    double latency_ms;          // Time to complete the request
+    RequestTimings timings;     // Breakdown of latency_ms (queued is not part of it)
+    uint64_t bytes;             // Image size
+    std::string_view detail;    // Error of a failed request, or the client event
+    uint64_t dropped;           // Records lost to a full queue just before this one
+    std::string_view line;      // All of the above as one logfmt line
+};
+
+/// Receives log records on the client's logging thread
+using LogHandler = std::function<void(const LogRecord&)>;
+
 /// API usage statistics
 struct Usage {
     int screenshots_taken;      // Total screenshots this period
@@ -163,11 +424,170 @@ struct Usage {
 // Client Configuration
 // =============================================================================
 
+/// Client-wide cap on received bytes, shared between priority classes
+struct BandwidthLimit {
+    int64_t bytes_per_second = 0;       // Total receive rate (0 = unlimited)
+    double interactive_share = 1.0;     // Fraction of the cap interactive transfers may use
+    double batch_share = 1.0;           // Fraction of the cap batch transfers may use
+};
+
+/// Structured request logging. Records are formatted and delivered on a
+/// background thread; the thread that sends a request only copies it into
+/// a preallocated queue and never formats or allocates.
+struct LogConfig {
+    LogHandler handler;                                 // Receives records (empty = no logging)
+    LogLevel level = LogLevel::Info;                    // Least severe level delivered
+    double debug_sample_rate = 1.0;                     // Fraction of request records kept, per
+    double info_sample_rate = 1.0;                      // level. Failed and slow requests are
+                                                        // always kept; client events are kept
+                                                        // unless below `level`.
+    std::chrono::milliseconds slow_request{10'000};     // Requests at least this slow are
+                                                        // logged as Warning
+    size_t queue_records = 1024;                        // Records buffered for the logging
+                                                        // thread; beyond that they are dropped
+                                                        // and counted
+};
+
+/// When a DegradationRule applies and what it relaxes. A rule applies
+/// while either of its triggers is crossed; a zero trigger never fires.
+struct DegradationRule {
+    std::chrono::milliseconds queue_wait{0};        // submit() requests wait this long for a worker
+    double error_rate = 0;                          // This fraction of recent requests failed
+    std::optional<double> max_device_scale_factor;  // Lower device_scale_factor to at most this
+    bool disable_full_page = false;                 // Capture the viewport only
+    std::optional<WaitUntil> wait_until;            // Wait for this instead, if lighter than
+                                                    // requested (unset counts as Load)
+    std::optional<int> max_wait_for_timeout;        // Shorten wait_for_timeout to at most this (ms)
+};
+
+/// Cheaper captures instead of timeouts while the client is overloaded.
+/// As each request is sent, every rule whose trigger is crossed relaxes
+/// its options; where rules overlap, the cheapest setting wins. Queue wait
+/// is that of the submit() request dispatched last, and zero once the
+/// queue has emptied. The error rate counts failed requests, except
+/// cancellations and handovers, among the last `error_window` sent.
+struct DegradationPolicy {
+    std::vector<DegradationRule> rules;             // Empty = never degrade
+    size_t error_window = 100;
+};
+
+/// Checks image results for blank pages: all white, all black, or a
+/// browser error page of mostly one plain colour. Each result is decoded
+/// into a preview of about 64K pixels (1-10 ms for a 720p capture), and
+/// is blank if the preview's luma variance is at most max_variance or
+/// min_dominant_share of it lies within `tolerance` of one colour. PNG
+/// (when built with zlib) and baseline JPEG are checked; WebP, stored
+/// results and screenshot_to() are not. Blank results are never cached.
+/// With BlankAction::Retry the last capture is returned, marked if still
+/// blank; progress handlers see each capture's transfer from the start.
+struct BlankDetection {
+    bool enabled = false;
+    double max_variance = 4.0;          // Luma variance, on a 0-255 scale
+    double min_dominant_share = 0.98;   // Fraction of the preview
+    int tolerance = 16;                 // Per channel, 0-255
+    BlankAction action = BlankAction::Flag;
+    int retries = 1;                    // Resends per request, with BlankAction::Retry
+};
+
 struct ClientConfig {
     std::string api_key;                                // Required: API key
     std::string base_url = "https://api.pxshot.com";    // API base URL
     int timeout_seconds = 60;                           // Request timeout
     std::optional<std::string> user_agent;              // Custom User-Agent
+    int max_concurrency = 4;                            // Connections serving submit()
+    bool adaptive_timeouts = false;                     // Derive read timeout from learned latency
+    int64_t max_output_pixels = 200'000'000;            // Reject larger captures (0 = no limit)
+    bool strict_preflight = false;                      // Treat preflight warnings as errors
+    int64_t memory_budget_bytes = 0;                    // Cap on expected bytes in flight (0 = none)
+    int pipeline_depth = 0;                             // Stored-mode submit() requests pipelined
+                                                        // per connection (0 or 1 = off). Requests
+                                                        // left unanswered by a server that closes
+                                                        // mid-pipeline are resent, so a capture
+                                                        // may occasionally render twice.
+    BandwidthLimit bandwidth{};                         // Receive rate shaping
+    int64_t buffer_pool_bytes = 0;                      // Idle memory kept for large result
+                                                        // buffers (0 = no pooling)
+    int64_t result_cache_bytes = 0;                     // Memory for results of repeated identical
+                                                        // requests (0 = no caching)
+    std::chrono::seconds result_cache_ttl{300};         // How long a cached result is served
+    CachePolicy result_cache_policy = CachePolicy::Lru; // What the cache evicts and admits
+    std::string proxy{};                                // "http://[user:password@]host:port" to
+                                                        // reach base_url through (empty = direct).
+                                                        // https APIs are reached via CONNECT
+                                                        // tunnels, kept alive like connections.
+    double tcp_info_sample_rate = 0;                    // Fraction of requests whose connection's
+                                                        // TCP_INFO is read into their timings and
+                                                        // stats() (0 = none; Linux only)
+    DegradationPolicy degradation{};                    // Relax costly options under overload
+    BlankDetection blank_detection{};                   // Flag or retry blank captures
+    bool tcp_fast_open = false;                         // Open usage() and pipelined connections
+                                                        // with TCP Fast Open where the first
+                                                        // flight is replay-safe (Linux)
+    bool tls_early_data = false;                        // Send usage() as TLS 1.3 0-RTT early data
+                                                        // on connections resuming a session
+    std::string tuning_file{};                          // JSON Tuning polled every second and
+                                                        // applied on change (empty = none)
+    LogConfig log{};                                    // Structured request logging
+    bool handle_fork = false;                           // Install pthread_atfork handlers that
+                                                        // call after_fork() in child processes
+};
+
+/// Limits that can be changed on a running client with Client::tune().
+/// Unset fields keep their current value.
+struct Tuning {
+    std::optional<int> max_concurrency;
+    std::optional<int64_t> memory_budget_bytes;
+    std::optional<BandwidthLimit> bandwidth;            // Replaces the whole limit
+    std::optional<int64_t> buffer_pool_bytes;
+    std::optional<int64_t> result_cache_bytes;
+};
+
+/// Snapshot of a client's limits and activity
+struct ClientStats {
+    // Limits in effect
+    int max_concurrency = 0;
+    int64_t memory_budget_bytes = 0;
+    BandwidthLimit bandwidth{};
+    int64_t buffer_pool_bytes = 0;
+    int64_t result_cache_bytes = 0;
+    uint64_t tuning_changes = 0;        // tune() calls and tuning file reloads that changed a limit
+    
+    // Scheduler
+    int queued = 0;                     // submit() requests waiting for a worker
+    int in_flight = 0;                  // submit() requests being sent
+    int64_t in_flight_bytes = 0;        // Expected response bytes of those
+    bool pipelining_disabled = false;   // Switched off after repeated mid-pipeline closes
+    bool degrading = false;             // A degradation rule is in force
+    uint64_t degraded_requests = 0;     // Sent with options relaxed by the degradation policy
+    
+    // Memory
+    uint64_t cache_hits = 0;
+    uint64_t cache_misses = 0;
+    int64_t cache_bytes = 0;            // Held by cached results
+    uint64_t cache_rejected = 0;        // Results not admitted (CachePolicy::TinyLfu)
+    uint64_t buffer_pool_hits = 0;
+    uint64_t buffer_pool_misses = 0;
+    int64_t buffer_pool_idle_bytes = 0; // Held for reuse
+    
+    // Transport
+    uint64_t connections_opened = 0;    // Including proxy tunnels
+    uint64_t fast_open_attempts = 0;    // Connections opened with TCP Fast Open
+    uint64_t fast_open_accepted = 0;    // Of those, data in the SYN was accepted
+    uint64_t early_data_attempts = 0;   // Requests sent as TLS early data
+    uint64_t early_data_accepted = 0;   // Of those, accepted (the rest were sent again)
+    
+    // Blank page detection
+    uint64_t blank_checked = 0;         // Image results decoded and checked
+    uint64_t blank_detected = 0;        // Of those, found blank
+    uint64_t blank_retries = 0;         // Captures sent again because they came back blank
+    
+    // Network, from TCP_INFO samples
+    uint64_t tcp_samples = 0;
+    std::chrono::microseconds tcp_rtt_mean{0};
+    std::chrono::microseconds tcp_rtt_max{0};
+    double tcp_retransmit_ratio = 0;    // Segments sent again per segment sent, averaged
+    double tcp_cwnd_mean = 0;           // Segments
+    uint64_t tcp_delivery_rate_mean = 0;    // Bytes per second
 };
 
 // =============================================================================
@@ -186,6 +606,20 @@ public:
     /// Destructor
     ~Client();
     
+    /// The process-wide client for `config`, created on first use
+    /// Every caller asking for the same configuration gets a handle to one
+    /// client, so independent libraries share its connections, caches,
+    /// resolved addresses, TLS state and limits. Synchronous calls made at
+    /// the same time each get a connection of their own, so holders do not
+    /// wait on one another's captures. The client is destroyed
+    /// when the last handle is released, failing requests still queued;
+    /// asking again afterwards creates a new one. tune() and drain() through
+    /// any handle affect every holder. Configurations match on every field
+    /// except log.handler, which cannot be compared: the client keeps the
+    /// handler of the configuration that created it.
+    /// @throws ValidationError as Client(ClientConfig)
+    [[nodiscard]] static std::shared_ptr<Client> shared(const ClientConfig& config);
+    
     // Non-copyable, movable
     Client(const Client&) = delete;
     Client& operator=(const Client&) = delete;
@@ -200,6 +634,116 @@ public:
     /// @throws ValidationError on invalid parameters
     [[nodiscard]] ScreenshotResult screenshot(const ScreenshotOptions& options);
     
+    /// Capture a screenshot, observing the download as it arrives
+    /// @param options Screenshot configuration
+    /// @param on_progress Called on the receive path every granularity_bytes
+    ///        and once at the end; returning false aborts the transfer
+    /// @param granularity_bytes Minimum bytes between progress calls
+    /// @throws CancelledError if on_progress returned false
+    /// @throws HttpError, ApiError, ValidationError as screenshot()
+    [[nodiscard]] ScreenshotResult screenshot(const ScreenshotOptions& options,
+                                              const ProgressHandler& on_progress,
+                                              size_t granularity_bytes = 64 * 1024);
+    
+    /// Capture a screenshot, streaming the image into `sink` as it arrives
+    /// instead of collecting it in memory. The result cache is not used.
+    /// @return Image bytes written to the sink
+    /// @throws ValidationError if options.store is set, or as screenshot()
+    /// @throws HttpError, ApiError as screenshot(), or whatever the sink
+    ///         throws; either way the sink is aborted
+    uint64_t screenshot_to(const ScreenshotOptions& options, ResultSink& sink);
+    
+    /// Queue a screenshot for capture on the client's worker connections
+    /// Interactive requests run before batch requests, shortest expected first.
+    /// @param options Screenshot configuration
+    /// @param priority Scheduling class
+    /// @return Future resolving to the result or the error screenshot() would throw
+    /// @throws ValidationError on invalid parameters
+    [[nodiscard]] std::future<ScreenshotResult> submit(ScreenshotOptions options,
+                                                       Priority priority = Priority::Interactive);
+    
+    /// Queue several screenshots at once
+    /// @return One future per option set, in the same order
+    /// @throws ValidationError if any entry is invalid (nothing is queued)
+    [[nodiscard]] std::vector<std::future<ScreenshotResult>> submit_batch(
+        std::vector<ScreenshotOptions> batch, Priority priority = Priority::Batch);
+    
+    /// Check a request locally without sending it
+    /// Parses the URL and wait_for_selector, flags costly option combinations
+    /// and estimates the output size. screenshot() and submit() throw
+    /// ValidationError with the first error of this report.
+    [[nodiscard]] PreflightReport preflight(const ScreenshotOptions& options) const;
+    
+    /// Predict latency and response size from previously completed requests
+    [[nodiscard]] CostEstimate estimate(const ScreenshotOptions& options) const;
+    
+    /// Predict how long until a batch submitted now would be complete
+    /// Accounts for queued and in-flight work and the worker count.
+    [[nodiscard]] std::chrono::milliseconds estimate_batch(
+        const std::vector<ScreenshotOptions>& batch, Priority priority = Priority::Batch) const;
+    
+    /// Stop accepting work and wind down for shutdown
+    /// New requests are rejected from now on. Queued requests already being
+    /// sent get until `deadline` to finish; any still running then are cut
+    /// off. Blocking screenshot() calls in progress are not affected.
+    /// Queued requests and cut-off ones are serialised into the result for
+    /// a replacement process, and their futures fail with HandoverError.
+    /// A cut-off request may already have rendered, so resuming it can
+    /// capture the page twice.
+    DrainResult drain(std::chrono::steady_clock::time_point deadline);
+    
+    /// Queue requests handed over by another client's drain()
+    /// @param handover DrainResult::handover from the draining client
+    /// @return One future per request, in handover order
+    /// @throws ValidationError if the handover is malformed or invalid
+    [[nodiscard]] std::vector<std::future<ScreenshotResult>> resume(std::string_view handover);
+    
+    /// Hand back a result buffer (from take_bytes()) once done with it
+    /// With buffer_pool_bytes set, large buffers are kept and reused for
+    /// later captures, already resident on the right NUMA node; otherwise
+    /// the buffer is simply freed.
+    void recycle(std::vector<uint8_t> buffer);
+    
+    /// Hand back a result once done with it. Its buffer is recycled as
+    /// above if no copy of the result still shares it, and otherwise only
+    /// released, so copies handed to other consumers stay valid.
+    void recycle(ScreenshotResult result);
+    
+    /// Change limits on a running client
+    /// Each change takes effect from the next scheduling decision; a worker
+    /// picking its next job while tune() runs may see some of the changes
+    /// and not others. Requests already running are not interrupted:
+    /// lowering max_concurrency parks surplus workers once they finish
+    /// their current request. Lowering a pool or cache
+    /// budget frees the memory beyond it immediately. Each change is
+    /// counted in stats() and logged to the flight recorder.
+    /// @throws ValidationError on out-of-range values (nothing is changed)
+    void tune(const Tuning& changes);
+    
+    /// Current limits and counters
+    [[nodiscard]] ClientStats stats() const;
+    
+    /// Per-host latency, size and failure statistics of every capture sent
+    /// Gathered into fixed-size sketches as requests complete, so memory
+    /// does not grow with the number of requests.
+    /// @param reset Start a new reporting window, e.g. at the end of a crawl
+    [[nodiscard]] HostReport host_report(bool reset = false);
+    
+    /// Recent notable events, oldest first: limit changes, tuning file
+    /// errors, pipelining being switched off, drains and forks
+    [[nodiscard]] std::vector<FlightEvent> flight_recorder() const;
+    
+    /// Make a client inherited through fork() usable in the child
+    /// Call in the child before any other use, unless handle_fork is set.
+    /// The child drops its copies of the parent's connections without
+    /// closing them on the parent, and opens its own on first use. Learned
+    /// costs, resolved API addresses, TLS configuration and prepared
+    /// request headers carry over. In the child, futures of requests still
+    /// queued at the fork fail with HandoverError (the parent runs them),
+    /// and those of requests already running never become ready. Without
+    /// handle_fork, fork only while no queued requests are running.
+    void after_fork();
+    
     /// Get current usage statistics
     /// @return Usage information for current billing period
     /// @throws HttpError on network/HTTP errors
@@ -217,6 +761,260 @@ private:
     std::unique_ptr<Impl> impl_;
 };
 
+// =============================================================================
+// S3 Upload
+// =============================================================================
+
+/// An S3-compatible bucket (AWS S3, MinIO, ...) and how to upload to it
+struct S3Target {
+    std::string endpoint;                           // e.g. "https://s3.eu-west-1.amazonaws.com"
+    std::string region = "us-east-1";               // Signing region
+    std::string bucket;
+    std::string access_key_id;
+    std::string secret_access_key;
+    std::string session_token{};                    // Temporary credentials only
+    bool virtual_hosted = false;                    // bucket.host/key rather than host/bucket/key
+    size_t part_bytes = 8 * 1024 * 1024;            // Multipart part size (S3 minimum: 5 MiB)
+    int parallel_parts = 4;                         // Part uploads in flight at once
+    int timeout_seconds = 60;
+};
+
+/// An object written by an S3Sink
+struct UploadedObject {
+    std::string bucket;
+    std::string key;
+    std::string etag;
+    uint64_t size_bytes = 0;
+    int parts = 0;                                  // 0 if sent with a single PUT
+};
+
+class S3Sink;
+
+/// Streams screenshots into S3 while they are received. Bodies are cut
+/// into parts that upload in parallel, as a multipart upload, while the
+/// rest is still arriving; a body that fits in one part is sent with a
+/// single PUT. Part buffers are pooled, and the parts waiting or uploading
+/// are bounded, so when S3 falls behind the capture download slows down
+/// instead of buffering. One uploader can serve many concurrent sinks.
+class S3Uploader {
+public:
+    /// @throws ValidationError if the endpoint or part size is invalid
+    explicit S3Uploader(S3Target target);
+    ~S3Uploader();
+    
+    S3Uploader(const S3Uploader&) = delete;
+    S3Uploader& operator=(const S3Uploader&) = delete;
+    
+    /// A sink that uploads one object under `key`
+    [[nodiscard]] std::unique_ptr<S3Sink> open(std::string key);
+
+private:
+    friend class S3Sink;
+    struct Impl;
+    std::shared_ptr<Impl> impl_;
+};
+
+/// ResultSink writing one object, from S3Uploader::open(). Failed uploads
+/// throw HttpError and leave no partial object behind.
+class S3Sink final : public ResultSink {
+public:
+    ~S3Sink() override;
+    
+    S3Sink(const S3Sink&) = delete;
+    S3Sink& operator=(const S3Sink&) = delete;
+    
+    void begin(std::string_view content_type, std::optional<uint64_t> content_length) override;
+    void write(const uint8_t* data, size_t size) override;
+    void finish() override;
+    void abort() noexcept override;
+    
+    /// The uploaded object; complete once finish() has returned
+    [[nodiscard]] const UploadedObject& object() const noexcept { return object_; }
+
+private:
+    friend class S3Uploader;
+    struct Upload;
+    
+    std::shared_ptr<S3Uploader::Impl> uploader_;
+    std::shared_ptr<Upload> upload_;
+    std::string buffer_;                            // Part being filled
+    UploadedObject object_;
+    
+    S3Sink(std::shared_ptr<S3Uploader::Impl> uploader, std::string key);
+    
+    /// Hand the filled buffer to the uploader as the next part
+    void submit_part();
+};
+
+// =============================================================================
+// Results Manifest
+// =============================================================================
+
+/// One capture, as recorded in a results manifest
+struct ManifestRow {
+    std::string url;
+    std::string options;                                // Request body JSON
+    std::chrono::system_clock::time_point captured_at;
+    int status = 0;                                     // HTTP status, 0 if none was received
+    std::string error{};                                // Failure message (empty = succeeded)
+    double latency_ms = 0;                              // 0 if unknown
+    std::optional<int64_t> size_bytes{};                // Image size, if captured
+    std::optional<std::array<uint8_t, 32>> content_hash{};  // SHA-256 of the image bytes
+    std::optional<int> width{};                         // Image dimensions, if known
+    std::optional<int> height{};
+};
+
+/// Writes capture outcomes to an Arrow IPC file (Feather v2), which
+/// pandas, Polars, DuckDB, Spark and the Arrow libraries read directly.
+/// Rows are buffered by column and written a record batch at a time, so
+/// appending costs a few copies and memory stays bounded however many
+/// rows are written. Columns: url, options, captured_at (UTC milliseconds),
+/// status, error, latency_ms, size_bytes, content_hash (32-byte binary),
+/// width and height; the last six are null where unknown. Not thread-safe.
+class ManifestWriter {
+public:
+    /// Create or truncate `path`
+    /// @param rows_per_batch Rows per record batch; larger batches scan
+    ///        faster, smaller ones bound memory and lose less on a crash
+    /// @throws Error if the file cannot be opened
+    explicit ManifestWriter(const std::string& path, size_t rows_per_batch = 64 * 1024);
+    
+    /// Closes the file, ignoring errors; call close() to see them
+    ~ManifestWriter();
+    
+    ManifestWriter(const ManifestWriter&) = delete;
+    ManifestWriter& operator=(const ManifestWriter&) = delete;
+    ManifestWriter(ManifestWriter&&) noexcept;
+    ManifestWriter& operator=(ManifestWriter&&) noexcept;
+    
+    /// @throws Error if a record batch could not be written
+    void append(const ManifestRow& row);
+    
+    /// Record a completed capture. Image results are hashed and their
+    /// dimensions read from the PNG, JPEG or WebP header; stored results
+    /// report those of the API response and have no hash.
+    void append(const ScreenshotOptions& options, const ScreenshotResult& result);
+    
+    /// Record a failed capture; the status is that of an HttpError
+    void append(const ScreenshotOptions& options, const std::exception& error);
+    
+    /// Write buffered rows as a record batch now
+    void flush();
+    
+    /// Write the remaining rows and the file footer. The file is readable
+    /// only once closed; later appends throw.
+    /// @throws Error on write failure
+    void close();
+    
+    /// Rows appended so far
+    [[nodiscard]] uint64_t rows() const noexcept;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+// =============================================================================
+// Monitoring
+// =============================================================================
+
+/// One capture in a monitored page's history
+struct MonitorObservation {
+    std::chrono::seconds interval;      // Since the capture before it
+    bool changed;                       // Its content hash differed from that capture's
+};
+
+/// A monitored page and what the monitor has learned about it. Passing
+/// one from Monitor::status() back to Monitor::add() resumes monitoring
+/// where it left off, e.g. after a restart.
+struct MonitoredPage {
+    ScreenshotOptions options;
+    std::chrono::seconds interval{0};                       // Current capture interval
+    std::chrono::system_clock::time_point next_capture{};   // In the past = capture now
+    std::chrono::system_clock::time_point last_capture{};   // When content_hash was taken
+    std::string content_hash{};                             // Of the last capture (empty = none yet)
+    std::vector<MonitorObservation> history{};              // Oldest first
+    double change_rate = 0;                                 // Estimated changes per hour
+    uint64_t captures = 0;                                  // Completed, including failures
+    uint64_t changes = 0;
+    uint64_t failures = 0;
+};
+
+/// A completed capture of a monitored page
+struct MonitorCapture {
+    const ScreenshotOptions& options;
+    const ScreenshotResult* result;         // Null if the capture failed
+    std::exception_ptr error;               // Set if the capture failed
+    bool changed;                           // Content differs from the previous capture
+    std::chrono::seconds next_interval;     // Until the page is captured again
+};
+
+/// Receives each capture on the monitor's thread
+using MonitorHandler = std::function<void(const MonitorCapture&)>;
+
+/// Content hash of a capture, compared between captures of a page
+using Fingerprint = std::function<std::string(const ScreenshotResult&)>;
+
+/// How often a Monitor captures its pages. Without `adaptive`, every page
+/// is captured every `interval`. With it, each page starts at `interval`
+/// and moves between min_interval and max_interval as its history shows
+/// how often it changes: the monitor estimates the page's change rate
+/// from the captures that did and did not see a change (by maximum
+/// likelihood, treating changes as a Poisson process), then picks the
+/// interval over which a change is `change_probability` likely. Stable
+/// pages back off, by at most `max_growth` per capture; a change pulls
+/// the interval back in at once.
+struct MonitorConfig {
+    std::chrono::seconds interval{3600};                // Fixed, or starting, capture interval
+    bool adaptive = false;
+    std::chrono::seconds min_interval{300};
+    std::chrono::seconds max_interval{7 * 24 * 3600};
+    double change_probability = 0.5;                    // Aim: chance each capture finds a change
+    double max_growth = 2.0;                            // Largest factor an interval grows by at once
+    size_t history = 32;                                // Captures per page the estimate draws on
+    Priority priority = Priority::Batch;                // Of the captures in the client's queue
+    MonitorHandler on_capture;                          // Receives every capture (empty = none)
+    Fingerprint fingerprint;                            // Empty = SHA-256 of the image bytes
+};
+
+/// Captures pages repeatedly through a client's submit() queue and
+/// reports which captures changed. Pages found blank by the client's
+/// blank page detection are reported but not compared, so they neither
+/// count as changes nor replace the last hash. Failed captures are
+/// retried at the page's current interval. Captures are served from the
+/// client's result cache like any other, so keep intervals longer than
+/// result_cache_ttl. The client must outlive the monitor.
+class Monitor {
+public:
+    /// @throws ValidationError for out-of-range settings
+    Monitor(Client& client, MonitorConfig config);
+    
+    /// Stops capturing; captures in flight complete unreported
+    ~Monitor();
+    
+    Monitor(const Monitor&) = delete;
+    Monitor& operator=(const Monitor&) = delete;
+    
+    /// Start monitoring a page, first capturing it right away. A page with
+    /// identical options is replaced.
+    /// @throws ValidationError if options.store is set and no fingerprint
+    ///         is configured, as stored results have no bytes to hash
+    void add(ScreenshotOptions options);
+    
+    /// Resume monitoring a page from an earlier status()
+    void add(MonitoredPage page);
+    
+    /// Stop monitoring a page; returns whether it was monitored
+    bool remove(const ScreenshotOptions& options);
+    
+    /// Every monitored page, soonest capture first
+    [[nodiscard]] std::vector<MonitoredPage> status() const;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
 // =============================================================================
 // Utility Functions
 // =============================================================================
@@ -242,6 +1040,48 @@ private:
     return "load";
 }
 
+/// Convert LogLevel enum to string
+[[nodiscard]] inline const char* to_string(LogLevel l) noexcept {
+    switch (l) {
+        case LogLevel::Debug: return "debug";
+        case LogLevel::Info: return "info";
+        case LogLevel::Warning: return "warning";
+        case LogLevel::Error: return "error";
+    }
+    return "info";
+}
+
+/// Convert BlankVerdict enum to string
+[[nodiscard]] inline const char* to_string(BlankVerdict v) noexcept {
+    switch (v) {
+        case BlankVerdict::NotChecked: return "not_checked";
+        case BlankVerdict::Content: return "content";
+        case BlankVerdict::Blank: return "blank";
+    }
+    return "not_checked";
+}
+
+/// Convert BlankAction enum to string
+[[nodiscard]] inline const char* to_string(BlankAction a) noexcept {
+    switch (a) {
+        case BlankAction::Flag: return "flag";
+        case BlankAction::Retry: return "retry";
+    }
+    return "flag";
+}
+
+/// Convert CachePolicy enum to string
+[[nodiscard]] inline const char* to_string(CachePolicy p) noexcept {
+    switch (p) {
+        case CachePolicy::Lru: return "lru";
+        case CachePolicy::TinyLfu: return "tinylfu";
+    }
+    return "lru";
+}
+
+/// Format a HostReport as a compact table, one line per host
+[[nodiscard]] std::string to_string(const HostReport& report);
+
 } // namespace pxshot
 
 #endif // PXSHOT_HPP
@@ -0,0 +1,440 @@
+// Pxshot C++ SDK - Arrow IPC file writer
+
+#include "arrow_ipc.hpp"
+
+#include "pxshot/pxshot.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace pxshot {
+namespace detail {
+
+namespace {
+
+constexpr char kMagic[] = "ARROW1";                 // Padded to 8 bytes at the start
+constexpr uint32_t kContinuation = 0xFFFFFFFF;
+constexpr int16_t kMetadataV5 = 4;
+
+// Message header and Type union members, from Message.fbs and Schema.fbs
+constexpr uint8_t kHeaderSchema = 1;
+constexpr uint8_t kHeaderRecordBatch = 3;
+constexpr uint8_t kTypeInt = 2;
+constexpr uint8_t kTypeFloatingPoint = 3;
+constexpr uint8_t kTypeUtf8 = 5;
+constexpr uint8_t kTypeTimestamp = 10;
+constexpr uint8_t kTypeFixedSizeBinary = 15;
+constexpr int16_t kPrecisionDouble = 2;
+constexpr int16_t kTimeUnitMillisecond = 1;
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+constexpr int16_t kEndianness = 1;
+#else
+constexpr int16_t kEndianness = 0;
+#endif
+
+size_t padding_for(size_t size) {
+    return (8 - size % 8) % 8;
+}
+
+/// Builds one FlatBuffer back to front, as the reference implementation
+/// does: children are written before the tables that refer to them, so
+/// every offset points forward. Objects are identified by their distance
+/// from the end of the buffer, which does not change as it grows.
+class FlatBuilder {
+public:
+    using Ref = uint32_t;
+    
+    Ref string(std::string_view text) {
+        prep(4, text.size() + 1);
+        push_scalar<uint8_t>(0);
+        push(text.data(), text.size());
+        push_scalar(static_cast<uint32_t>(text.size()));
+        return size();
+    }
+    
+    /// Vector of fixed-size structs laid out as in `data`
+    Ref struct_vector(const void* data, size_t count, size_t struct_size, size_t align) {
+        prep(4, count * struct_size);
+        prep(align, count * struct_size);
+        push(data, count * struct_size);
+        push_scalar(static_cast<uint32_t>(count));
+        return size();
+    }
+    
+    Ref offset_vector(const std::vector<Ref>& refs) {
+        prep(4, refs.size() * 4);
+        for (auto it = refs.rbegin(); it != refs.rend(); ++it) {
+            push_scalar(static_cast<uint32_t>(size() + 4 - *it));
+        }
+        push_scalar(static_cast<uint32_t>(refs.size()));
+        return size();
+    }
+    
+    void start_table() {
+        fields_.clear();
+        table_start_ = size();
+    }
+    
+    template <class T>
+    void add(int field, T value) {
+        prep(sizeof(T), 0);
+        push_scalar(value);
+        fields_.emplace_back(field, size());
+    }
+    
+    void add_offset(int field, Ref ref) {
+        prep(4, 0);
+        push_scalar(static_cast<uint32_t>(size() + 4 - ref));
+        fields_.emplace_back(field, size());
+    }
+    
+    Ref end_table() {
+        prep(4, 0);
+        push_scalar<int32_t>(0);        // Offset to the vtable, patched below
+        Ref table = size();
+        
+        int slots = 0;
+        for (const auto& field : fields_) {
+            slots = std::max(slots, field.first + 1);
+        }
+        std::vector<uint16_t> vtable(2 + static_cast<size_t>(slots), 0);
+        vtable[0] = static_cast<uint16_t>(vtable.size() * 2);
+        vtable[1] = static_cast<uint16_t>(table - table_start_);
+        for (const auto& [field, ref] : fields_) {
+            vtable[2 + static_cast<size_t>(field)] = static_cast<uint16_t>(table - ref);
+        }
+        push(vtable.data(), vtable.size() * 2);
+        
+        // The vtable precedes the table, which records the distance back
+        auto distance = static_cast<int32_t>(size() - table);
+        std::memcpy(at(table), &distance, sizeof(distance));
+        fields_.clear();
+        return table;
+    }
+    
+    /// Complete the buffer with `root` as its root table
+    [[nodiscard]] std::string finish(Ref root) {
+        prep(min_align_, 4);
+        push_scalar(static_cast<uint32_t>(size() + 4 - root));
+        return std::string(reinterpret_cast<const char*>(at(size())), size());
+    }
+
+private:
+    std::vector<uint8_t> buffer_;           // Contents fill the end
+    size_t used_ = 0;
+    size_t min_align_ = 4;
+    std::vector<std::pair<int, Ref>> fields_;
+    Ref table_start_ = 0;
+    
+    [[nodiscard]] Ref size() const { return static_cast<Ref>(used_); }
+    
+    uint8_t* at(Ref ref) { return buffer_.data() + buffer_.size() - ref; }
+    
+    /// Pad so that `align` holds after `extra` more bytes
+    void prep(size_t align, size_t extra) {
+        min_align_ = std::max(min_align_, align);
+        size_t padding = (align - (used_ + extra) % align) % align;
+        static const uint8_t zeros[8] = {};
+        push(zeros, padding);
+    }
+    
+    void push(const void* data, size_t count) {
+        if (used_ + count > buffer_.size()) {
+            std::vector<uint8_t> grown(std::max({buffer_.size() * 2, used_ + count, size_t{1024}}));
+            if (used_ > 0) {
+                std::memcpy(grown.data() + grown.size() - used_, at(size()), used_);
+            }
+            buffer_ = std::move(grown);
+        }
+        used_ += count;
+        if (count > 0) {
+            std::memcpy(at(size()), data, count);
+        }
+    }
+    
+    template <class T>
+    void push_scalar(T value) {
+        push(&value, sizeof(value));
+    }
+};
+
+/// A Type union member table for `field`
+std::pair<uint8_t, FlatBuilder::Ref> build_type(FlatBuilder& fb, const ArrowField& field) {
+    switch (field.type) {
+        case ArrowType::Utf8:
+            fb.start_table();
+            return {kTypeUtf8, fb.end_table()};
+        case ArrowType::Int32:
+        case ArrowType::Int64:
+            fb.start_table();
+            fb.add<int32_t>(0, field.type == ArrowType::Int32 ? 32 : 64);     // bitWidth
+            fb.add<uint8_t>(1, 1);                                              // is_signed
+            return {kTypeInt, fb.end_table()};
+        case ArrowType::Float64:
+            fb.start_table();
+            fb.add<int16_t>(0, kPrecisionDouble);
+            return {kTypeFloatingPoint, fb.end_table()};
+        case ArrowType::TimestampMs: {
+            auto timezone = fb.string("UTC");
+            fb.start_table();
+            fb.add<int16_t>(0, kTimeUnitMillisecond);
+            fb.add_offset(1, timezone);
+            return {kTypeTimestamp, fb.end_table()};
+        }
+        case ArrowType::FixedBinary:
+            fb.start_table();
+            fb.add<int32_t>(0, field.byte_width);
+            return {kTypeFixedSizeBinary, fb.end_table()};
+    }
+    throw Error("Unknown Arrow type");
+}
+
+/// Schema table, shared by the schema message and the footer
+FlatBuilder::Ref build_schema(FlatBuilder& fb, const std::vector<ArrowField>& schema) {
+    std::vector<FlatBuilder::Ref> fields;
+    for (const auto& field : schema) {
+        auto name = fb.string(field.name);
+        auto [type_id, type] = build_type(fb, field);
+        auto children = fb.offset_vector({});   // Readers require the vector, even empty
+        fb.start_table();
+        fb.add_offset(0, name);
+        fb.add<uint8_t>(1, field.nullable ? 1 : 0);
+        fb.add<uint8_t>(2, type_id);
+        fb.add_offset(3, type);
+        fb.add_offset(5, children);
+        fields.push_back(fb.end_table());
+    }
+    auto field_vector = fb.offset_vector(fields);
+    fb.start_table();
+    fb.add<int16_t>(0, kEndianness);
+    fb.add_offset(1, field_vector);
+    return fb.end_table();
+}
+
+std::string message(FlatBuilder& fb, uint8_t header_type, FlatBuilder::Ref header, int64_t body_length) {
+    fb.start_table();
+    fb.add<int64_t>(3, body_length);
+    fb.add<int16_t>(0, kMetadataV5);
+    fb.add<uint8_t>(1, header_type);
+    fb.add_offset(2, header);
+    return fb.finish(fb.end_table());
+}
+
+} // namespace
+
+// -----------------------------------------------------------------------------
+// ArrowColumn
+// -----------------------------------------------------------------------------
+
+ArrowColumn::ArrowColumn(ArrowField field) : field_(std::move(field)) {
+    clear();
+}
+
+void ArrowColumn::push_validity(bool valid) {
+    if (length_ % 8 == 0) {
+        validity_.push_back(0);
+    }
+    if (valid) {
+        validity_.back() |= static_cast<uint8_t>(1u << (length_ % 8));
+    } else {
+        ++nulls_;
+    }
+    ++length_;
+}
+
+void ArrowColumn::append_null() {
+    switch (field_.type) {
+        case ArrowType::Utf8:
+            offsets_.push_back(offsets_.back());
+            break;
+        case ArrowType::Int32:
+            values_.append(4, '\0');
+            break;
+        case ArrowType::Int64:
+        case ArrowType::Float64:
+        case ArrowType::TimestampMs:
+            values_.append(8, '\0');
+            break;
+        case ArrowType::FixedBinary:
+            values_.append(static_cast<size_t>(field_.byte_width), '\0');
+            break;
+    }
+    push_validity(false);
+}
+
+void ArrowColumn::append(int64_t value) {
+    if (field_.type == ArrowType::Int32) {
+        auto narrow = static_cast<int32_t>(value);
+        values_.append(reinterpret_cast<const char*>(&narrow), sizeof(narrow));
+    } else if (field_.type == ArrowType::Int64 || field_.type == ArrowType::TimestampMs) {
+        values_.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    } else {
+        throw Error("Arrow column " + field_.name + " does not hold integers");
+    }
+    push_validity(true);
+}
+
+void ArrowColumn::append(double value) {
+    if (field_.type != ArrowType::Float64) {
+        throw Error("Arrow column " + field_.name + " does not hold doubles");
+    }
+    values_.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    push_validity(true);
+}
+
+void ArrowColumn::append(std::string_view value) {
+    if (field_.type == ArrowType::Utf8) {
+        if (values_.size() + value.size() > static_cast<size_t>(std::numeric_limits<int32_t>::max())) {
+            throw Error("Arrow column " + field_.name + " exceeds 2 GiB in one batch");
+        }
+        values_.append(value);
+        offsets_.push_back(static_cast<int32_t>(values_.size()));
+    } else if (field_.type == ArrowType::FixedBinary && value.size() == static_cast<size_t>(field_.byte_width)) {
+        values_.append(value);
+    } else {
+        throw Error("Arrow column " + field_.name + " does not hold this value");
+    }
+    push_validity(true);
+}
+
+size_t ArrowColumn::bytes() const noexcept {
+    return validity_.size() + offsets_.size() * sizeof(int32_t) + values_.size();
+}
+
+std::vector<std::string_view> ArrowColumn::buffers() const {
+    std::vector<std::string_view> buffers;
+    buffers.emplace_back(reinterpret_cast<const char*>(validity_.data()), nulls_ > 0 ? validity_.size() : 0);
+    if (field_.type == ArrowType::Utf8) {
+        buffers.emplace_back(reinterpret_cast<const char*>(offsets_.data()), offsets_.size() * sizeof(int32_t));
+    }
+    buffers.emplace_back(values_);
+    return buffers;
+}
+
+void ArrowColumn::clear() {
+    validity_.clear();
+    offsets_.assign(1, 0);
+    values_.clear();
+    length_ = 0;
+    nulls_ = 0;
+}
+
+// -----------------------------------------------------------------------------
+// ArrowFileWriter
+// -----------------------------------------------------------------------------
+
+ArrowFileWriter::ArrowFileWriter(const std::string& path, std::vector<ArrowField> schema)
+    : path_(path), schema_(std::move(schema)), out_(path, std::ios::binary | std::ios::trunc) {
+    if (!out_) {
+        throw Error("Failed to open " + path_ + " for writing");
+    }
+    write(kMagic, 6);
+    write_padding(6);
+    
+    FlatBuilder fb;
+    auto schema_table = build_schema(fb, schema_);
+    write_message(message(fb, kHeaderSchema, schema_table, 0));
+}
+
+void ArrowFileWriter::write(const void* data, size_t size) {
+    out_.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+    if (!out_) {
+        throw Error("Failed to write " + path_);
+    }
+    position_ += static_cast<int64_t>(size);
+}
+
+void ArrowFileWriter::write_padding(size_t size) {
+    static const char zeros[8] = {};
+    write(zeros, padding_for(size));
+}
+
+int32_t ArrowFileWriter::write_message(const std::string& metadata) {
+    // The body that follows must start 8-byte aligned
+    auto length = static_cast<int32_t>(metadata.size() + padding_for(metadata.size()));
+    write(&kContinuation, sizeof(kContinuation));
+    write(&length, sizeof(length));
+    write(metadata.data(), metadata.size());
+    write_padding(metadata.size());
+    return length + 8;
+}
+
+void ArrowFileWriter::write_batch(const std::vector<ArrowColumn>& columns) {
+    if (columns.size() != schema_.size()) {
+        throw Error("Arrow record batch does not match the schema");
+    }
+    struct FieldNode {
+        int64_t length;
+        int64_t null_count;
+    };
+    struct Buffer {
+        int64_t offset;
+        int64_t length;
+    };
+    std::vector<FieldNode> nodes;
+    std::vector<Buffer> buffers;
+    std::vector<std::string_view> body;
+    int64_t rows = columns.empty() ? 0 : columns.front().length();
+    int64_t body_length = 0;
+    for (const auto& column : columns) {
+        if (column.length() != rows) {
+            throw Error("Arrow columns differ in length");
+        }
+        nodes.push_back({column.length(), column.null_count()});
+        for (auto buffer : column.buffers()) {
+            buffers.push_back({body_length, static_cast<int64_t>(buffer.size())});
+            body.push_back(buffer);
+            body_length += static_cast<int64_t>(buffer.size() + padding_for(buffer.size()));
+        }
+    }
+    
+    FlatBuilder fb;
+    auto buffer_vector = fb.struct_vector(buffers.data(), buffers.size(), sizeof(Buffer), 8);
+    auto node_vector = fb.struct_vector(nodes.data(), nodes.size(), sizeof(FieldNode), 8);
+    fb.start_table();
+    fb.add<int64_t>(0, rows);
+    fb.add_offset(1, node_vector);
+    fb.add_offset(2, buffer_vector);
+    auto batch = fb.end_table();
+    
+    Block block{position_, 0, 0, body_length};
+    block.metadata_length = write_message(message(fb, kHeaderRecordBatch, batch, body_length));
+    for (auto buffer : body) {
+        write(buffer.data(), buffer.size());
+        write_padding(buffer.size());
+    }
+    batches_.push_back(block);
+}
+
+void ArrowFileWriter::close() {
+    if (!out_.is_open()) {
+        return;
+    }
+    const uint32_t end_of_stream[2] = {kContinuation, 0};
+    write(end_of_stream, sizeof(end_of_stream));
+    
+    FlatBuilder fb;
+    auto batch_vector = fb.struct_vector(batches_.data(), batches_.size(), sizeof(Block), 8);
+    auto dictionary_vector = fb.struct_vector(nullptr, 0, sizeof(Block), 8);
+    auto schema_table = build_schema(fb, schema_);
+    fb.start_table();
+    fb.add_offset(1, schema_table);
+    fb.add_offset(2, dictionary_vector);
+    fb.add_offset(3, batch_vector);
+    fb.add<int16_t>(0, kMetadataV5);
+    auto footer = fb.finish(fb.end_table());
+    
+    auto footer_length = static_cast<int32_t>(footer.size());
+    write(footer.data(), footer.size());
+    write(&footer_length, sizeof(footer_length));
+    write(kMagic, 6);
+    out_.close();
+    if (!out_) {
+        throw Error("Failed to write " + path_);
+    }
+}
+
+} // namespace detail
+} // namespace pxshot
@@ -0,0 +1,110 @@
+// Pxshot C++ SDK - Arrow IPC file writer (internal)
+//
+// Just enough of the Arrow columnar format to write flat tables of
+// strings, integers, doubles, timestamps and fixed-size binaries as an
+// Arrow IPC file (also known as Feather v2), without depending on the
+// Arrow libraries. The FlatBuffers metadata is encoded by hand.
+
+#ifndef PXSHOT_ARROW_IPC_HPP
+#define PXSHOT_ARROW_IPC_HPP
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace pxshot {
+namespace detail {
+
+enum class ArrowType {
+    Utf8,
+    Int32,
+    Int64,
+    Float64,
+    TimestampMs,        // Milliseconds since the epoch, UTC
+    FixedBinary         // byte_width bytes per value
+};
+
+struct ArrowField {
+    std::string name;
+    ArrowType type;
+    bool nullable = false;
+    int byte_width = 0;     // FixedBinary only
+};
+
+/// Values of one column for the next record batch. Buffers keep their
+/// capacity across clear(), so steady-state appends do not allocate.
+class ArrowColumn {
+public:
+    explicit ArrowColumn(ArrowField field);
+    
+    void append_null();
+    void append(int64_t value);             // Int32, Int64 and TimestampMs
+    void append(double value);              // Float64
+    void append(std::string_view value);    // Utf8, and FixedBinary of exactly byte_width
+    
+    [[nodiscard]] const ArrowField& field() const noexcept { return field_; }
+    [[nodiscard]] int64_t length() const noexcept { return length_; }
+    [[nodiscard]] int64_t null_count() const noexcept { return nulls_; }
+    [[nodiscard]] size_t bytes() const noexcept;
+    
+    /// Buffers in IPC order: validity (empty when there are no nulls),
+    /// offsets (Utf8 only), values
+    [[nodiscard]] std::vector<std::string_view> buffers() const;
+    
+    void clear();
+
+private:
+    ArrowField field_;
+    std::vector<uint8_t> validity_;
+    std::vector<int32_t> offsets_;
+    std::string values_;
+    int64_t length_ = 0;
+    int64_t nulls_ = 0;
+    
+    void push_validity(bool valid);
+};
+
+/// Writes an Arrow IPC file: the schema up front, then one record batch
+/// per write_batch(), then on close() the footer that indexes them.
+/// Readers need the footer, so a file is only complete once closed.
+class ArrowFileWriter {
+public:
+    /// Create or truncate `path`. Throws Error if it cannot be opened.
+    ArrowFileWriter(const std::string& path, std::vector<ArrowField> schema);
+    
+    /// Write `columns`, one per schema field and of equal length, as a
+    /// record batch. Throws Error on write failure.
+    void write_batch(const std::vector<ArrowColumn>& columns);
+    
+    /// Write the footer and close the file. Throws Error on write failure.
+    void close();
+    
+    [[nodiscard]] bool is_open() const noexcept { return out_.is_open(); }
+
+private:
+    struct Block {
+        int64_t offset;             // Of the message, from the start of the file
+        int32_t metadata_length;    // Prefix, flatbuffer and padding
+        int32_t padding;
+        int64_t body_length;
+    };
+    
+    std::string path_;
+    std::vector<ArrowField> schema_;
+    std::ofstream out_;
+    int64_t position_ = 0;
+    std::vector<Block> batches_;
+    
+    void write(const void* data, size_t size);
+    void write_padding(size_t size);
+    
+    /// Write an encapsulated message and return its length with prefix
+    int32_t write_message(const std::string& metadata);
+};
+
+} // namespace detail
+} // namespace pxshot
+
+#endif // PXSHOT_ARROW_IPC_HPP
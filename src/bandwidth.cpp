@@ -0,0 +1,84 @@
+// Pxshot C++ SDK - Receive bandwidth shaping
+
+#include "bandwidth.hpp"
+
+#include <algorithm>
+#include <thread>
+
+namespace pxshot {
+namespace detail {
+
+namespace {
+
+/// Enough burst to smooth over a quarter second, but never less than a
+/// few socket reads so small rates still make progress
+double burst_for(double rate) {
+    return std::max(rate / 4, 64.0 * 1024);
+}
+
+} // namespace
+
+TokenBucket::TokenBucket(double rate, double burst) {
+    configure(rate, burst);
+}
+
+void TokenBucket::configure(double rate, double burst) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    rate_ = rate;
+    burst_ = burst;
+    tokens_ = std::min(tokens_, burst_);
+    updated_ = Clock::now();
+}
+
+TokenBucket::Clock::duration TokenBucket::take(size_t bytes) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (rate_ <= 0) {
+        return Clock::duration::zero();
+    }
+    
+    auto now = Clock::now();
+    double elapsed = std::chrono::duration<double>(now - updated_).count();
+    tokens_ = std::min(burst_, tokens_ + elapsed * rate_);
+    updated_ = now;
+    
+    tokens_ -= static_cast<double>(bytes);
+    if (tokens_ >= 0) {
+        return Clock::duration::zero();
+    }
+    return std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(-tokens_ / rate_));
+}
+
+BandwidthLimiter::BandwidthLimiter(const BandwidthLimit& limit) {
+    configure(limit);
+}
+
+void BandwidthLimiter::configure(const BandwidthLimit& limit) {
+    double total = static_cast<double>(std::max<int64_t>(0, limit.bytes_per_second));
+    total_.configure(total, burst_for(total));
+    
+    // A class with the full share needs no bucket of its own; tiny or
+    // negative shares are floored so the class still makes progress
+    auto lane_rate = [&](double share) {
+        return share >= 1 ? 0.0 : total * std::max(share, 0.01);
+    };
+    double interactive = lane_rate(limit.interactive_share);
+    double batch = lane_rate(limit.batch_share);
+    interactive_.configure(interactive, burst_for(interactive));
+    batch_.configure(batch, burst_for(batch));
+    enabled_.store(total > 0, std::memory_order_relaxed);
+}
+
+void BandwidthLimiter::consume(Priority priority, size_t bytes) {
+    if (!enabled()) {
+        return;
+    }
+    auto& lane = priority == Priority::Interactive ? interactive_ : batch_;
+    auto wait = std::max(total_.take(bytes), lane.take(bytes));
+    if (wait > TokenBucket::Clock::duration::zero()) {
+        std::this_thread::sleep_for(wait);
+    }
+}
+
+} // namespace detail
+} // namespace pxshot
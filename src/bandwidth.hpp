@@ -0,0 +1,77 @@
+// Pxshot C++ SDK - Receive bandwidth shaping (internal)
+
+#ifndef PXSHOT_BANDWIDTH_HPP
+#define PXSHOT_BANDWIDTH_HPP
+
+#include "pxshot/pxshot.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+
+namespace pxshot {
+namespace detail {
+
+/// Token bucket measured in bytes. Callers take tokens up front and may
+/// drive the bucket into debt; the returned delay is how long to wait
+/// before the bytes count as sent at the configured rate.
+class TokenBucket {
+public:
+    using Clock = std::chrono::steady_clock;
+    
+    TokenBucket() = default;
+    TokenBucket(double rate, double burst);
+    
+    void configure(double rate, double burst);
+    
+    /// Take `bytes` tokens; returns how long the caller should wait
+    [[nodiscard]] Clock::duration take(size_t bytes);
+    
+    void lock() { mutex_.lock(); }
+    void unlock() { mutex_.unlock(); }
+
+private:
+    std::mutex mutex_;
+    double rate_ = 0;           // Tokens per second (0 = unlimited)
+    double burst_ = 0;          // Bucket capacity
+    double tokens_ = 0;
+    Clock::time_point updated_ = Clock::now();
+};
+
+/// Client-wide receive limiter with per-priority ceilings. Every transfer
+/// draws on the shared bucket and on its class bucket, so a class never
+/// exceeds its share and all classes together never exceed the cap.
+class BandwidthLimiter {
+public:
+    explicit BandwidthLimiter(const BandwidthLimit& limit);
+    
+    void configure(const BandwidthLimit& limit);
+    
+    [[nodiscard]] bool enabled() const { return enabled_.load(std::memory_order_relaxed); }
+    
+    /// Account for received bytes, sleeping as needed to honour the limits
+    void consume(Priority priority, size_t bytes);
+    
+    void lock() {
+        total_.lock();
+        interactive_.lock();
+        batch_.lock();
+    }
+    void unlock() {
+        batch_.unlock();
+        interactive_.unlock();
+        total_.unlock();
+    }
+
+private:
+    std::atomic<bool> enabled_{false};
+    TokenBucket total_;
+    TokenBucket interactive_;
+    TokenBucket batch_;
+};
+
+} // namespace detail
+} // namespace pxshot
+
+#endif // PXSHOT_BANDWIDTH_HPP
@@ -0,0 +1,239 @@
+// Pxshot C++ SDK - Blank page detection
+
+#include "blank_detection.hpp"
+
+#include <algorithm>
+#include <bitset>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define PXSHOT_BLANK_SSE2 1
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define PXSHOT_BLANK_NEON 1
+#endif
+
+namespace pxshot {
+namespace detail {
+
+namespace {
+
+// Previews are kept this small; beyond it more pixels barely change the
+// verdict but cost decode time
+constexpr size_t kPreviewPixels = 64 * 1024;
+
+// Luma weights in 1/256ths (BT.601)
+constexpr int kRedWeight = 77;
+constexpr int kGreenWeight = 150;
+constexpr int kBlueWeight = 29;
+
+uint8_t luma(uint8_t red, uint8_t green, uint8_t blue) {
+    return static_cast<uint8_t>((kRedWeight * red + kGreenWeight * green + kBlueWeight * blue) >> 8);
+}
+
+/// Sum of luma and of squared luma over `count` pixels
+void luma_moments(const uint8_t* red, const uint8_t* green, const uint8_t* blue, size_t count,
+                  uint64_t& sum, uint64_t& sum_squares) {
+    size_t i = 0;
+    sum = 0;
+    sum_squares = 0;
+#if defined(PXSHOT_BLANK_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i red_weight = _mm_set1_epi16(kRedWeight);
+    const __m128i green_weight = _mm_set1_epi16(kGreenWeight);
+    const __m128i blue_weight = _mm_set1_epi16(kBlueWeight);
+    __m128i sums = zero;            // Two 64-bit lanes, from _mm_sad_epu8
+    while (i + 16 <= count) {
+        // Squares are summed in 32-bit lanes, which 4096 rounds cannot overflow
+        __m128i squares = zero;
+        for (size_t round = 0; round < 4096 && i + 16 <= count; ++round, i += 16) {
+            __m128i r = _mm_loadu_si128(reinterpret_cast<const __m128i*>(red + i));
+            __m128i g = _mm_loadu_si128(reinterpret_cast<const __m128i*>(green + i));
+            __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(blue + i));
+            // The weighted sums reach 65280, so they wrap as signed 16-bit
+            // values but shift back into range as unsigned ones
+            __m128i low = _mm_add_epi16(
+                _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(r, zero), red_weight),
+                              _mm_mullo_epi16(_mm_unpacklo_epi8(g, zero), green_weight)),
+                _mm_mullo_epi16(_mm_unpacklo_epi8(b, zero), blue_weight));
+            __m128i high = _mm_add_epi16(
+                _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(r, zero), red_weight),
+                              _mm_mullo_epi16(_mm_unpackhi_epi8(g, zero), green_weight)),
+                _mm_mullo_epi16(_mm_unpackhi_epi8(b, zero), blue_weight));
+            low = _mm_srli_epi16(low, 8);
+            high = _mm_srli_epi16(high, 8);
+            sums = _mm_add_epi64(sums, _mm_sad_epu8(_mm_packus_epi16(low, high), zero));
+            squares = _mm_add_epi32(squares, _mm_add_epi32(_mm_madd_epi16(low, low), _mm_madd_epi16(high, high)));
+        }
+        alignas(16) uint32_t lanes[4];
+        _mm_store_si128(reinterpret_cast<__m128i*>(lanes), squares);
+        sum_squares += uint64_t{lanes[0]} + lanes[1] + lanes[2] + lanes[3];
+    }
+    alignas(16) uint64_t halves[2];
+    _mm_store_si128(reinterpret_cast<__m128i*>(halves), sums);
+    sum = halves[0] + halves[1];
+#elif defined(PXSHOT_BLANK_NEON)
+    const uint8x8_t red_weight = vdup_n_u8(kRedWeight);
+    const uint8x8_t green_weight = vdup_n_u8(kGreenWeight);
+    const uint8x8_t blue_weight = vdup_n_u8(kBlueWeight);
+    uint64x2_t sums = vdupq_n_u64(0);
+    uint64x2_t squares = vdupq_n_u64(0);
+    for (; i + 16 <= count; i += 16) {
+        uint8x16_t r = vld1q_u8(red + i);
+        uint8x16_t g = vld1q_u8(green + i);
+        uint8x16_t b = vld1q_u8(blue + i);
+        uint16x8_t low = vmull_u8(vget_low_u8(r), red_weight);
+        low = vmlal_u8(low, vget_low_u8(g), green_weight);
+        low = vmlal_u8(low, vget_low_u8(b), blue_weight);
+        uint16x8_t high = vmull_u8(vget_high_u8(r), red_weight);
+        high = vmlal_u8(high, vget_high_u8(g), green_weight);
+        high = vmlal_u8(high, vget_high_u8(b), blue_weight);
+        uint8x8_t luma_low = vshrn_n_u16(low, 8);
+        uint8x8_t luma_high = vshrn_n_u16(high, 8);
+        sums = vpadalq_u32(sums, vpaddlq_u16(vpaddlq_u8(vcombine_u8(luma_low, luma_high))));
+        uint32x4_t pairs = vaddq_u32(vpaddlq_u16(vmull_u8(luma_low, luma_low)),
+                                     vpaddlq_u16(vmull_u8(luma_high, luma_high)));
+        squares = vpadalq_u32(squares, pairs);
+    }
+    sum = vgetq_lane_u64(sums, 0) + vgetq_lane_u64(sums, 1);
+    sum_squares = vgetq_lane_u64(squares, 0) + vgetq_lane_u64(squares, 1);
+#endif
+    for (; i < count; ++i) {
+        uint64_t y = luma(red[i], green[i], blue[i]);
+        sum += y;
+        sum_squares += y * y;
+    }
+}
+
+/// Pixels whose every channel is within `tolerance` of (r0, g0, b0)
+size_t count_near(const uint8_t* red, const uint8_t* green, const uint8_t* blue, size_t count,
+                  uint8_t r0, uint8_t g0, uint8_t b0, uint8_t tolerance) {
+    size_t i = 0;
+    size_t near = 0;
+#if defined(PXSHOT_BLANK_SSE2)
+    auto distance = [](__m128i a, __m128i b) {
+        return _mm_or_si128(_mm_subs_epu8(a, b), _mm_subs_epu8(b, a));
+    };
+    const __m128i red0 = _mm_set1_epi8(static_cast<char>(r0));
+    const __m128i green0 = _mm_set1_epi8(static_cast<char>(g0));
+    const __m128i blue0 = _mm_set1_epi8(static_cast<char>(b0));
+    const __m128i limit = _mm_set1_epi8(static_cast<char>(tolerance));
+    for (; i + 16 <= count; i += 16) {
+        __m128i r = _mm_loadu_si128(reinterpret_cast<const __m128i*>(red + i));
+        __m128i g = _mm_loadu_si128(reinterpret_cast<const __m128i*>(green + i));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(blue + i));
+        __m128i worst = _mm_max_epu8(_mm_max_epu8(distance(r, red0), distance(g, green0)), distance(b, blue0));
+        __m128i within = _mm_cmpeq_epi8(_mm_max_epu8(worst, limit), limit);
+        near += std::bitset<16>(static_cast<unsigned>(_mm_movemask_epi8(within))).count();
+    }
+#elif defined(PXSHOT_BLANK_NEON)
+    const uint8x16_t red0 = vdupq_n_u8(r0);
+    const uint8x16_t green0 = vdupq_n_u8(g0);
+    const uint8x16_t blue0 = vdupq_n_u8(b0);
+    const uint8x16_t limit = vdupq_n_u8(tolerance);
+    for (; i + 16 <= count; i += 16) {
+        uint8x16_t worst = vmaxq_u8(vmaxq_u8(vabdq_u8(vld1q_u8(red + i), red0),
+                                             vabdq_u8(vld1q_u8(green + i), green0)),
+                                    vabdq_u8(vld1q_u8(blue + i), blue0));
+        near += vaddvq_u8(vshrq_n_u8(vcleq_u8(worst, limit), 7));
+    }
+#endif
+    auto within = [tolerance](uint8_t value, uint8_t target) {
+        return (value > target ? value - target : target - value) <= tolerance;
+    };
+    for (; i < count; ++i) {
+        near += within(red[i], r0) && within(green[i], g0) && within(blue[i], b0);
+    }
+    return near;
+}
+
+} // namespace
+
+BlankCheck measure(const Preview& preview, int tolerance) {
+    BlankCheck check;
+    size_t count = preview.pixels();
+    if (count == 0) {
+        return check;
+    }
+    const uint8_t* red = preview.red.data();
+    const uint8_t* green = preview.green.data();
+    const uint8_t* blue = preview.blue.data();
+    
+    uint64_t sum = 0;
+    uint64_t sum_squares = 0;
+    luma_moments(red, green, blue, count, sum, sum_squares);
+    double mean = static_cast<double>(sum) / static_cast<double>(count);
+    check.luma_variance = std::max(0.0, static_cast<double>(sum_squares) / static_cast<double>(count) - mean * mean);
+    
+    // The most common colour, to 4 bits per channel, taken as the mean of
+    // the pixels in its bucket
+    std::vector<uint32_t> buckets(4096 * 4);   // Count and channel sums
+    for (size_t i = 0; i < count; ++i) {
+        size_t bucket = 4 * (static_cast<size_t>(red[i] >> 4) << 8 | static_cast<size_t>(green[i] >> 4) << 4 |
+                             static_cast<size_t>(blue[i] >> 4));
+        buckets[bucket] += 1;
+        buckets[bucket + 1] += red[i];
+        buckets[bucket + 2] += green[i];
+        buckets[bucket + 3] += blue[i];
+    }
+    size_t top = 0;
+    for (size_t bucket = 4; bucket < buckets.size(); bucket += 4) {
+        if (buckets[bucket] > buckets[top]) {
+            top = bucket;
+        }
+    }
+    uint32_t members = buckets[top];
+    auto r0 = static_cast<uint8_t>(buckets[top + 1] / members);
+    auto g0 = static_cast<uint8_t>(buckets[top + 2] / members);
+    auto b0 = static_cast<uint8_t>(buckets[top + 3] / members);
+    check.dominant_color = uint32_t{r0} << 16 | uint32_t{g0} << 8 | b0;
+    check.dominant_share = static_cast<double>(count_near(red, green, blue, count, r0, g0, b0,
+                                                          static_cast<uint8_t>(tolerance))) /
+                           static_cast<double>(count);
+    return check;
+}
+
+BlankDetector::BlankDetector(const BlankDetection& config) : config_(config) {
+    if (!(config_.max_variance >= 0)) {
+        throw ValidationError("blank_detection.max_variance must not be negative");
+    }
+    if (!(config_.min_dominant_share > 0 && config_.min_dominant_share <= 1)) {
+        throw ValidationError("blank_detection.min_dominant_share must be above 0 and at most 1");
+    }
+    if (config_.tolerance < 0 || config_.tolerance > 255) {
+        throw ValidationError("blank_detection.tolerance must be between 0 and 255");
+    }
+    if (config_.retries < 0) {
+        throw ValidationError("blank_detection.retries must not be negative");
+    }
+}
+
+BlankCheck BlankDetector::check(const std::vector<uint8_t>& image) {
+    auto preview = decode_preview(image, kPreviewPixels);
+    if (!preview || preview->pixels() == 0) {
+        return {};
+    }
+    auto check = measure(*preview, config_.tolerance);
+    bool blank = check.luma_variance <= config_.max_variance ||
+                 check.dominant_share >= config_.min_dominant_share;
+    check.verdict = blank ? BlankVerdict::Blank : BlankVerdict::Content;
+    checked_.fetch_add(1, std::memory_order_relaxed);
+    if (blank) {
+        detected_.fetch_add(1, std::memory_order_relaxed);
+    }
+    return check;
+}
+
+bool BlankDetector::retry_due(const BlankCheck& check, int retries) const noexcept {
+    return check.verdict == BlankVerdict::Blank && config_.action == BlankAction::Retry &&
+           retries < config_.retries;
+}
+
+void BlankDetector::fill(ClientStats& stats) const {
+    stats.blank_checked = checked_.load(std::memory_order_relaxed);
+    stats.blank_detected = detected_.load(std::memory_order_relaxed);
+    stats.blank_retries = retries_.load(std::memory_order_relaxed);
+}
+
+} // namespace detail
+} // namespace pxshot
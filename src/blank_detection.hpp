@@ -0,0 +1,52 @@
+// Pxshot C++ SDK - Blank page detection (internal)
+
+#ifndef PXSHOT_BLANK_DETECTION_HPP
+#define PXSHOT_BLANK_DETECTION_HPP
+
+#include "pxshot/pxshot.hpp"
+#include "image_preview.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+namespace pxshot {
+namespace detail {
+
+/// Luma mean and variance of `preview`, and the share of its pixels
+/// within `tolerance` (per channel) of its most common colour. The scans
+/// use SSE2 on x86-64 and NEON on AArch64.
+[[nodiscard]] BlankCheck measure(const Preview& preview, int tolerance);
+
+/// Checks image results against a BlankDetection policy and counts the
+/// outcomes for stats()
+class BlankDetector {
+public:
+    /// Throws ValidationError for out-of-range settings
+    explicit BlankDetector(const BlankDetection& config);
+    
+    [[nodiscard]] bool enabled() const noexcept { return config_.enabled; }
+    
+    /// Verdict on `image`; NotChecked if it cannot be decoded
+    [[nodiscard]] BlankCheck check(const std::vector<uint8_t>& image);
+    
+    /// Whether a capture with verdict `check` should be sent again, after
+    /// `retries` resends already
+    [[nodiscard]] bool retry_due(const BlankCheck& check, int retries) const noexcept;
+    
+    void count_retry() noexcept { retries_.fetch_add(1, std::memory_order_relaxed); }
+    
+    /// Fill the blank_* fields of `stats`
+    void fill(ClientStats& stats) const;
+
+private:
+    BlankDetection config_;
+    std::atomic<uint64_t> checked_{0};
+    std::atomic<uint64_t> detected_{0};
+    std::atomic<uint64_t> retries_{0};
+};
+
+} // namespace detail
+} // namespace pxshot
+
+#endif // PXSHOT_BLANK_DETECTION_HPP
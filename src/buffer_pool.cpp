@@ -0,0 +1,164 @@
+// Pxshot C++ SDK - Pooled result buffers
+
+#include "buffer_pool.hpp"
+
+#include <algorithm>
+
+#ifdef __linux__
+#include <linux/mempolicy.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace pxshot {
+namespace detail {
+
+namespace {
+
+constexpr size_t kPageSize = 4096;
+constexpr size_t kHugePageSize = 2 * 1024 * 1024;
+
+size_t round_up(size_t n, size_t multiple) {
+    return (n + multiple - 1) / multiple * multiple;
+}
+
+#ifdef __linux__
+
+/// Node backing the page at `address`, or -1 if unknown
+int node_of(const void* address) {
+    int node = -1;
+    if (syscall(SYS_get_mempolicy, &node, nullptr, 0, const_cast<void*>(address),
+                MPOL_F_NODE | MPOL_F_ADDR) != 0) {
+        return -1;
+    }
+    return node;
+}
+
+/// Prefer `node` for the whole pages of a buffer and ask for huge pages.
+/// Must run before the pages are first touched. Both are hints: kernels
+/// without NUMA or THP support reject them and nothing changes.
+void place(uint8_t* data, size_t size, int node) {
+    auto first = round_up(reinterpret_cast<uintptr_t>(data), kPageSize);
+    auto last = (reinterpret_cast<uintptr_t>(data) + size) / kPageSize * kPageSize;
+    if (last <= first) {
+        return;
+    }
+    auto* start = reinterpret_cast<void*>(first);
+    size_t length = last - first;
+    
+    madvise(start, length, MADV_HUGEPAGE);
+    
+    if (node >= 0) {
+        constexpr size_t kBits = 8 * sizeof(unsigned long);
+        std::vector<unsigned long> mask(static_cast<size_t>(node) / kBits + 1);
+        mask[static_cast<size_t>(node) / kBits] = 1UL << (static_cast<size_t>(node) % kBits);
+        // The kernel reads one bit fewer than maxnode
+        syscall(SYS_mbind, start, length, MPOL_PREFERRED, mask.data(), mask.size() * kBits + 1, 0);
+    }
+}
+
+#else
+
+int node_of(const void*) {
+    return -1;
+}
+
+void place(uint8_t*, size_t, int) {}
+
+#endif // __linux__
+
+} // namespace
+
+std::vector<uint8_t> BufferPool::acquire(size_t capacity, int node) {
+    auto slot = static_cast<size_t>(std::max(node, 0));
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (slot < free_.size()) {
+            // Best fit, but never more than twice the request
+            auto& list = free_[slot];
+            auto best = list.end();
+            for (auto it = list.begin(); it != list.end(); ++it) {
+                size_t have = it->capacity();
+                if (have >= capacity && have / 2 <= capacity &&
+                    (best == list.end() || have < best->capacity())) {
+                    best = it;
+                }
+            }
+            if (best != list.end()) {
+                auto buffer = std::move(*best);
+                list.erase(best);
+                stats_.idle_bytes -= buffer.capacity();
+                ++stats_.hits;
+                return buffer;
+            }
+        }
+        ++stats_.misses;
+    }
+    
+    // Whole huge pages, which also lets slightly larger bodies reuse it
+    std::vector<uint8_t> buffer;
+    buffer.reserve(round_up(capacity, kHugePageSize));
+    place(buffer.data(), buffer.capacity(), node);
+    
+    // Writing every byte faults the pages in now, on the chosen node,
+    // instead of one by one as the body arrives
+    buffer.resize(buffer.capacity());
+    buffer.clear();
+    return buffer;
+}
+
+void BufferPool::release(std::vector<uint8_t>&& buffer) {
+    if (!enabled() || buffer.capacity() < kMinPooled) {
+        return;
+    }
+    // The middle is clear of allocator headers, so it has the bound policy
+    int node = node_of(buffer.data() + buffer.capacity() / 2);
+    auto slot = static_cast<size_t>(std::max(node, 0));
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (stats_.idle_bytes + buffer.capacity() > max_idle_bytes_.load(std::memory_order_relaxed)) {
+        return;     // The caller's buffer is freed as usual
+    }
+    if (free_.size() <= slot) {
+        free_.resize(slot + 1);
+    }
+    buffer.clear();
+    stats_.idle_bytes += buffer.capacity();
+    free_[slot].push_back(std::move(buffer));
+}
+
+void BufferPool::set_max_idle_bytes(size_t max_idle_bytes) {
+    std::vector<std::vector<uint8_t>> evicted;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        max_idle_bytes_.store(max_idle_bytes, std::memory_order_relaxed);
+        for (auto& list : free_) {
+            while (!list.empty() && stats_.idle_bytes > max_idle_bytes) {
+                stats_.idle_bytes -= list.back().capacity();
+                evicted.push_back(std::move(list.back()));
+                list.pop_back();
+            }
+        }
+    }
+    // Unmapping large buffers is slow; do it without holding up acquire()
+}
+
+BufferPool::Stats BufferPool::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+int BufferPool::current_node() {
+#ifdef __linux__
+    unsigned cpu = 0;
+    unsigned node = 0;
+    if (syscall(SYS_getcpu, &cpu, &node, nullptr) == 0) {
+        return static_cast<int>(node);
+    }
+#endif
+    return 0;
+}
+
+} // namespace detail
+} // namespace pxshot
@@ -0,0 +1,64 @@
+// Pxshot C++ SDK - Pooled result buffers (internal)
+
+#ifndef PXSHOT_BUFFER_POOL_HPP
+#define PXSHOT_BUFFER_POOL_HPP
+
+#include <cstddef>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace pxshot {
+namespace detail {
+
+/// Recycles large receive buffers. A fresh multi-megabyte vector costs one
+/// page fault per 4 KiB page as the body is written into it, and on NUMA
+/// machines the pages land on whichever node the receiving worker runs on.
+/// Buffers made here are bound to the consumer's node, advised for
+/// transparent huge pages and pre-faulted once; returned buffers are kept,
+/// per node, up to an idle byte budget and handed out again best-fit.
+class BufferPool {
+public:
+    /// Smaller buffers are not worth pooling
+    static constexpr size_t kMinPooled = 1024 * 1024;
+    
+    struct Stats {
+        uint64_t hits = 0;          // Served from the pool
+        uint64_t misses = 0;        // Newly allocated and pre-faulted
+        uint64_t idle_bytes = 0;    // Capacity currently held for reuse
+    };
+    
+    explicit BufferPool(size_t max_idle_bytes) : max_idle_bytes_(max_idle_bytes) {}
+    
+    [[nodiscard]] bool enabled() const { return max_idle_bytes_.load(std::memory_order_relaxed) > 0; }
+    
+    /// Empty buffer with at least `capacity` bytes reserved, resident on
+    /// `node` (negative = no preference)
+    [[nodiscard]] std::vector<uint8_t> acquire(size_t capacity, int node);
+    
+    /// Keep `buffer` for reuse if it is large enough and fits the budget
+    void release(std::vector<uint8_t>&& buffer);
+    
+    /// Change the idle budget, freeing held buffers beyond it
+    void set_max_idle_bytes(size_t max_idle_bytes);
+    
+    [[nodiscard]] Stats stats() const;
+    
+    /// NUMA node of the CPU the calling thread is running on (0 if unknown)
+    [[nodiscard]] static int current_node();
+    
+    void lock() { mutex_.lock(); }
+    void unlock() { mutex_.unlock(); }
+
+private:
+    std::atomic<size_t> max_idle_bytes_;
+    mutable std::mutex mutex_;
+    std::vector<std::vector<std::vector<uint8_t>>> free_;  // Per node
+    Stats stats_;
+};
+
+} // namespace detail
+} // namespace pxshot
+
+#endif // PXSHOT_BUFFER_POOL_HPP
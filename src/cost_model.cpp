@@ -0,0 +1,151 @@
+// Pxshot C++ SDK - Per-host cost model
+
+#include "cost_model.hpp"
+#include "preflight.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+
+namespace pxshot {
+namespace detail {
+
+namespace {
+
+/// Coarse option shape: the switches that dominate render time
+std::string shape_of(const ScreenshotOptions& options) {
+    std::string shape;
+    shape += options.full_page.value_or(false) ? 'F' : 'V';
+    shape += options.store.value_or(false) ? 'S' : 'B';
+    shape += to_string(options.wait_until.value_or(WaitUntil::Load));
+    return shape;
+}
+
+template <typename Map>
+void evict_oldest(Map& map, size_t limit) {
+    if (map.size() < limit) {
+        return;
+    }
+    auto oldest = std::min_element(map.begin(), map.end(), [](const auto& a, const auto& b) {
+        return a.second.last_seen < b.second.last_seen;
+    });
+    map.erase(oldest);
+}
+
+} // namespace
+
+std::string host_of(std::string_view url) {
+    auto scheme = url.find("://");
+    if (scheme == std::string_view::npos) {
+        return {};
+    }
+    auto rest = url.substr(scheme + 3);
+    auto end = rest.find_first_of("/?#");
+    auto authority = rest.substr(0, end);
+    
+    // Strip userinfo and port
+    if (auto at = authority.rfind('@'); at != std::string_view::npos) {
+        authority = authority.substr(at + 1);
+    }
+    if (!authority.empty() && authority.front() == '[') {
+        authority = authority.substr(0, authority.find(']') + 1);
+    } else if (auto colon = authority.find(':'); colon != std::string_view::npos) {
+        authority = authority.substr(0, colon);
+    }
+    
+    std::string host(authority);
+    std::transform(host.begin(), host.end(), host.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return host;
+}
+
+void CostModel::Stats::add(double latency_ms, double bytes) {
+    if (samples == 0) {
+        mean_ms = latency_ms;
+        var_ms = 0;
+        mean_bytes = bytes;
+    } else {
+        double delta = latency_ms - mean_ms;
+        mean_ms += kAlpha * delta;
+        var_ms = (1 - kAlpha) * (var_ms + kAlpha * delta * delta);
+        mean_bytes += kAlpha * (bytes - mean_bytes);
+    }
+    ++samples;
+    last_seen = std::chrono::steady_clock::now();
+}
+
+CostModel::Estimate CostModel::prior(const ScreenshotOptions& options) {
+    Estimate e;
+    
+    e.latency_ms = 1500;
+    switch (options.wait_until.value_or(WaitUntil::Load)) {
+        case WaitUntil::NetworkIdle: e.latency_ms += 1500; break;
+        case WaitUntil::Load: e.latency_ms += 500; break;
+        case WaitUntil::DOMContentLoaded:
+        case WaitUntil::Commit: break;
+    }
+    if (options.wait_for_selector) {
+        e.latency_ms += 500;
+    }
+    if (options.full_page.value_or(false)) {
+        e.latency_ms *= 2;
+    }
+    e.latency_ms += std::max(0, options.wait_for_timeout.value_or(0));
+    e.stddev_ms = e.latency_ms / 2;
+    
+    if (options.store.value_or(false)) {
+        e.bytes = 512;
+        return e;
+    }
+    
+    double pixels = estimate_pixels(options);
+    double bytes_per_pixel = 0.6;
+    switch (options.format.value_or(Format::PNG)) {
+        case Format::PNG: bytes_per_pixel = 0.6; break;
+        case Format::JPEG: bytes_per_pixel = 0.05 + 0.002 * options.quality.value_or(80); break;
+        case Format::WEBP: bytes_per_pixel = 0.03 + 0.0015 * options.quality.value_or(80); break;
+    }
+    e.bytes = pixels * bytes_per_pixel;
+    return e;
+}
+
+CostModel::Estimate CostModel::estimate(const ScreenshotOptions& options) const {
+    auto shape = shape_of(options);
+    auto key = host_of(options.url) + '|' + shape;
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    const Stats* stats = nullptr;
+    bool host_specific = false;
+    if (auto it = hosts_.find(key); it != hosts_.end()) {
+        stats = &it->second;
+        host_specific = true;
+    } else if (auto sit = shapes_.find(shape); sit != shapes_.end()) {
+        stats = &sit->second;
+    }
+    if (!stats) {
+        return prior(options);
+    }
+    
+    Estimate e;
+    e.latency_ms = stats->mean_ms;
+    e.stddev_ms = std::sqrt(stats->var_ms);
+    e.bytes = stats->mean_bytes;
+    // Only history for this very host may tighten timeouts
+    e.samples = host_specific ? stats->samples : 0;
+    return e;
+}
+
+void CostModel::record(const ScreenshotOptions& options, double latency_ms, double bytes) {
+    auto shape = shape_of(options);
+    auto key = host_of(options.url) + '|' + shape;
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (hosts_.find(key) == hosts_.end()) {
+        evict_oldest(hosts_, kMaxKeys);
+    }
+    hosts_[key].add(latency_ms, bytes);
+    shapes_[shape].add(latency_ms, bytes);
+}
+
+} // namespace detail
+} // namespace pxshot
@@ -0,0 +1,67 @@
+// Pxshot C++ SDK - Per-host cost model (internal)
+
+#ifndef PXSHOT_COST_MODEL_HPP
+#define PXSHOT_COST_MODEL_HPP
+
+#include "pxshot/pxshot.hpp"
+
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace pxshot {
+namespace detail {
+
+/// Extract the lower-cased host from an absolute URL ("" if none)
+[[nodiscard]] std::string host_of(std::string_view url);
+
+/// Learned latency/size model, keyed by target host and option shape.
+///
+/// Each key keeps exponentially weighted mean and variance of the observed
+/// latency plus a mean response size. Lookups fall back from the exact key
+/// to the global model for the same shape, and finally to a static prior
+/// derived from the options alone.
+class CostModel {
+public:
+    struct Estimate {
+        double latency_ms = 0;      // Expected end-to-end latency
+        double stddev_ms = 0;       // Spread of observed latency
+        double bytes = 0;           // Expected response size
+        int samples = 0;            // Observations for this host (0 = fallback)
+    };
+    
+    [[nodiscard]] Estimate estimate(const ScreenshotOptions& options) const;
+    
+    void record(const ScreenshotOptions& options, double latency_ms, double bytes);
+    
+    /// Static estimate used before anything has been observed
+    [[nodiscard]] static Estimate prior(const ScreenshotOptions& options);
+    
+    void lock() const { mutex_.lock(); }
+    void unlock() const { mutex_.unlock(); }
+
+private:
+    struct Stats {
+        double mean_ms = 0;
+        double var_ms = 0;
+        double mean_bytes = 0;
+        int samples = 0;
+        std::chrono::steady_clock::time_point last_seen;
+        
+        void add(double latency_ms, double bytes);
+    };
+    
+    static constexpr double kAlpha = 0.2;
+    static constexpr size_t kMaxKeys = 4096;
+    
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, Stats> hosts_;
+    std::unordered_map<std::string, Stats> shapes_;
+};
+
+} // namespace detail
+} // namespace pxshot
+
+#endif // PXSHOT_COST_MODEL_HPP
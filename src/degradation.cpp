@@ -0,0 +1,147 @@
+// Pxshot C++ SDK - Degradation under overload
+
+#include "degradation.hpp"
+
+#include <algorithm>
+#include <string>
+
+namespace pxshot {
+namespace detail {
+
+namespace {
+
+// The error rate trigger waits for this many outcomes (or a full window,
+// if smaller), so one early failure cannot degrade a fresh client
+constexpr uint64_t kMinOutcomes = 10;
+
+/// How long the browser waits for each condition, lightest first
+int weight(WaitUntil wait) {
+    switch (wait) {
+        case WaitUntil::Commit: return 0;
+        case WaitUntil::DOMContentLoaded: return 1;
+        case WaitUntil::Load: return 2;
+        case WaitUntil::NetworkIdle: return 3;
+    }
+    return 2;
+}
+
+} // namespace
+
+Degrader::Degrader(DegradationPolicy policy)
+    : rules_(std::move(policy.rules)), window_(policy.error_window) {
+    if (rules_.size() > kMaxRules) {
+        throw ValidationError("degradation allows at most " + std::to_string(kMaxRules) + " rules");
+    }
+    if (!rules_.empty() && window_ == 0) {
+        throw ValidationError("degradation.error_window must be at least 1");
+    }
+    for (const auto& rule : rules_) {
+        if (rule.queue_wait.count() < 0) {
+            throw ValidationError("degradation queue_wait must not be negative");
+        }
+        if (!(rule.error_rate >= 0 && rule.error_rate <= 1)) {
+            throw ValidationError("degradation error_rate must be between 0 and 1");
+        }
+        if (rule.max_device_scale_factor && !(*rule.max_device_scale_factor > 0)) {
+            throw ValidationError("degradation max_device_scale_factor must be positive");
+        }
+        if (rule.max_wait_for_timeout && *rule.max_wait_for_timeout < 0) {
+            throw ValidationError("degradation max_wait_for_timeout must not be negative");
+        }
+    }
+    if (enabled()) {
+        outcomes_ = std::make_unique<std::atomic<uint8_t>[]>(window_);
+    }
+}
+
+void Degrader::record_queue_wait(std::chrono::microseconds wait) noexcept {
+    queue_wait_us_.store(wait.count(), std::memory_order_relaxed);
+}
+
+void Degrader::record_outcome(bool failed) noexcept {
+    if (!enabled()) {
+        return;
+    }
+    // The slot's exchange keeps failures_ equal to the ring's sum even when
+    // requests complete concurrently
+    auto n = outcome_count_.fetch_add(1, std::memory_order_relaxed);
+    auto previous = outcomes_[n % window_].exchange(failed ? 1 : 0, std::memory_order_relaxed);
+    failures_.fetch_add(static_cast<int64_t>(failed ? 1 : 0) - previous, std::memory_order_relaxed);
+}
+
+uint64_t Degrader::triggered() const noexcept {
+    auto queue_wait = std::chrono::microseconds(queue_wait_us_.load(std::memory_order_relaxed));
+    auto outcomes = std::min<uint64_t>(outcome_count_.load(std::memory_order_relaxed), window_);
+    double error_rate = -1;     // Below every threshold until enough outcomes are in
+    if (outcomes >= std::min<uint64_t>(kMinOutcomes, window_)) {
+        error_rate = static_cast<double>(failures_.load(std::memory_order_relaxed)) /
+                     static_cast<double>(outcomes);
+    }
+    
+    uint64_t rules = 0;
+    for (size_t i = 0; i < rules_.size(); ++i) {
+        const auto& rule = rules_[i];
+        if ((rule.queue_wait.count() > 0 && queue_wait >= rule.queue_wait) ||
+            (rule.error_rate > 0 && error_rate >= rule.error_rate)) {
+            rules |= uint64_t{1} << i;
+        }
+    }
+    return rules;
+}
+
+uint64_t Degrader::enter(uint64_t rules) noexcept {
+    return in_force_.exchange(rules, std::memory_order_relaxed);
+}
+
+std::optional<ScreenshotOptions> Degrader::relax(const ScreenshotOptions& options, uint64_t rules,
+                                                 Degradation& applied) {
+    applied = Degradation{};
+    if (rules == 0) {
+        return std::nullopt;
+    }
+    
+    std::optional<ScreenshotOptions> relaxed;
+    auto edit = [&]() -> ScreenshotOptions& {
+        if (!relaxed) {
+            relaxed = options;
+        }
+        return *relaxed;
+    };
+    for (size_t i = 0; i < rules_.size(); ++i) {
+        if (!(rules & uint64_t{1} << i)) {
+            continue;
+        }
+        const auto& rule = rules_[i];
+        const auto& current = relaxed ? *relaxed : options;
+        
+        if (rule.max_device_scale_factor &&
+            current.device_scale_factor.value_or(1.0) > *rule.max_device_scale_factor) {
+            edit().device_scale_factor = *rule.max_device_scale_factor;
+            applied.device_scale_factor = true;
+        }
+        if (rule.disable_full_page && current.full_page.value_or(false)) {
+            edit().full_page = false;
+            applied.full_page = true;
+        }
+        if (rule.wait_until && weight(*rule.wait_until) < weight(current.wait_until.value_or(WaitUntil::Load))) {
+            edit().wait_until = *rule.wait_until;
+            applied.wait_until = true;
+        }
+        if (rule.max_wait_for_timeout && current.wait_for_timeout.value_or(0) > *rule.max_wait_for_timeout) {
+            edit().wait_for_timeout = *rule.max_wait_for_timeout;
+            applied.wait_for_timeout = true;
+        }
+    }
+    if (relaxed) {
+        degraded_.fetch_add(1, std::memory_order_relaxed);
+    }
+    return relaxed;
+}
+
+void Degrader::fill(ClientStats& stats) const {
+    stats.degrading = in_force_.load(std::memory_order_relaxed) != 0;
+    stats.degraded_requests = degraded_.load(std::memory_order_relaxed);
+}
+
+} // namespace detail
+} // namespace pxshot
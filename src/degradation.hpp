@@ -0,0 +1,64 @@
+// Pxshot C++ SDK - Degradation under overload (internal)
+
+#ifndef PXSHOT_DEGRADATION_HPP
+#define PXSHOT_DEGRADATION_HPP
+
+#include "pxshot/pxshot.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace pxshot {
+namespace detail {
+
+/// Tracks the overload signals of a DegradationPolicy and relaxes options
+/// by the rules they trigger
+class Degrader {
+public:
+    static constexpr size_t kMaxRules = 64;
+    
+    /// Throws ValidationError for out-of-range rules
+    explicit Degrader(DegradationPolicy policy);
+    
+    [[nodiscard]] bool enabled() const noexcept { return !rules_.empty(); }
+    
+    /// Queue wait of the submit() request just dispatched, or zero when a
+    /// worker found the queue empty
+    void record_queue_wait(std::chrono::microseconds wait) noexcept;
+    
+    /// Outcome of a request that was sent
+    void record_outcome(bool failed) noexcept;
+    
+    /// Bit i set for each rule i whose trigger is crossed now
+    [[nodiscard]] uint64_t triggered() const noexcept;
+    
+    /// Record `rules` as the ones in force, returning those previously in force
+    uint64_t enter(uint64_t rules) noexcept;
+    
+    /// `options` relaxed by `rules`, or empty if they change nothing.
+    /// `applied` marks what was relaxed.
+    [[nodiscard]] std::optional<ScreenshotOptions> relax(const ScreenshotOptions& options, uint64_t rules,
+                                                         Degradation& applied);
+    
+    /// Fill degrading and degraded_requests of `stats`
+    void fill(ClientStats& stats) const;
+
+private:
+    std::vector<DegradationRule> rules_;
+    size_t window_;
+    std::unique_ptr<std::atomic<uint8_t>[]> outcomes_;  // Ring of the last window_ outcomes
+    std::atomic<uint64_t> outcome_count_{0};
+    std::atomic<int64_t> failures_{0};                  // In the ring
+    std::atomic<int64_t> queue_wait_us_{0};
+    std::atomic<uint64_t> in_force_{0};
+    std::atomic<uint64_t> degraded_{0};
+};
+
+} // namespace detail
+} // namespace pxshot
+
+#endif // PXSHOT_DEGRADATION_HPP
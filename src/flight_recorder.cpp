@@ -0,0 +1,32 @@
+// Pxshot C++ SDK - Flight recorder
+
+#include "flight_recorder.hpp"
+
+namespace pxshot {
+namespace detail {
+
+void FlightRecorder::record(std::string message) {
+    if (capacity_ == 0) {
+        return;
+    }
+    FlightEvent event{std::chrono::system_clock::now(), std::move(message)};
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (ring_.size() < capacity_) {
+        ring_.push_back(std::move(event));
+        return;
+    }
+    ring_[next_] = std::move(event);
+    next_ = (next_ + 1) % capacity_;
+}
+
+std::vector<FlightEvent> FlightRecorder::events() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<FlightEvent> events;
+    events.reserve(ring_.size());
+    events.insert(events.end(), ring_.begin() + static_cast<std::ptrdiff_t>(next_), ring_.end());
+    events.insert(events.end(), ring_.begin(), ring_.begin() + static_cast<std::ptrdiff_t>(next_));
+    return events;
+}
+
+} // namespace detail
+} // namespace pxshot
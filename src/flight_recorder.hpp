@@ -0,0 +1,41 @@
+// Pxshot C++ SDK - Flight recorder (internal)
+
+#ifndef PXSHOT_FLIGHT_RECORDER_HPP
+#define PXSHOT_FLIGHT_RECORDER_HPP
+
+#include "pxshot/pxshot.hpp"
+
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace pxshot {
+namespace detail {
+
+/// Bounded history of notable client events (limit changes, pipelining
+/// being switched off, drains), kept so that a misbehaving process can be
+/// inspected after the fact. Once full, the oldest entry is overwritten.
+class FlightRecorder {
+public:
+    explicit FlightRecorder(size_t capacity) : capacity_(capacity) {}
+    
+    void record(std::string message);
+    
+    /// Recorded events, oldest first
+    [[nodiscard]] std::vector<FlightEvent> events() const;
+    
+    void lock() { mutex_.lock(); }
+    void unlock() { mutex_.unlock(); }
+
+private:
+    size_t capacity_;
+    mutable std::mutex mutex_;
+    std::vector<FlightEvent> ring_;
+    size_t next_ = 0;           // Slot overwritten once the ring is full
+};
+
+} // namespace detail
+} // namespace pxshot
+
+#endif // PXSHOT_FLIGHT_RECORDER_HPP
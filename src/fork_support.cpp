@@ -0,0 +1,96 @@
+// Pxshot C++ SDK - State that survives fork()
+
+#include "fork_support.hpp"
+
+#include <algorithm>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <netdb.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace pxshot {
+namespace detail {
+
+#ifdef _WIN32
+
+// There is no fork() to survive
+void SocketTracker::add(int) {}
+
+void SocketTracker::close_inherited() {}
+
+#else
+
+void SocketTracker::add(int fd) {
+    struct stat st {};
+    if (fstat(fd, &st) != 0) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    // A reused descriptor number replaces the entry for the closed socket
+    sockets_[fd] = static_cast<unsigned long>(st.st_ino);
+}
+
+void SocketTracker::close_inherited() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& [fd, inode] : sockets_) {
+        struct stat st {};
+        if (fstat(fd, &st) == 0 && S_ISSOCK(st.st_mode) &&
+            static_cast<unsigned long>(st.st_ino) == inode) {
+            ::close(fd);
+        }
+    }
+    sockets_.clear();
+}
+
+#endif // _WIN32
+
+std::vector<std::string> DnsCache::lookup(const std::string& host) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = entries_.find(host);
+        if (it != entries_.end() && Clock::now() - it->second.resolved < ttl_) {
+            return it->second.addresses;
+        }
+    }
+    
+    // Resolve without the lock: getaddrinfo() can block for seconds, and
+    // fork handlers and other hosts' lookups must not wait on it
+    auto now = Clock::now();
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* results = nullptr;
+    if (getaddrinfo(host.c_str(), nullptr, &hints, &results) != 0) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = entries_.find(host);
+        return it != entries_.end() ? it->second.addresses : std::vector<std::string>{};
+    }
+    
+    std::vector<std::string> addresses;
+    for (auto* ai = results; ai; ai = ai->ai_next) {
+        char text[NI_MAXHOST];
+        if (getnameinfo(ai->ai_addr, static_cast<socklen_t>(ai->ai_addrlen), text, sizeof(text),
+                        nullptr, 0, NI_NUMERICHOST) == 0 &&
+            std::find(addresses.begin(), addresses.end(), text) == addresses.end()) {
+            addresses.emplace_back(text);
+        }
+    }
+    freeaddrinfo(results);
+    
+    // Concurrent lookups of one host each resolve; the one started last wins
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& entry = entries_[host];
+    if (entry.resolved <= now) {
+        entry = Entry{addresses, now};
+    }
+    return addresses;
+}
+
+} // namespace detail
+} // namespace pxshot
@@ -0,0 +1,74 @@
+// Pxshot C++ SDK - State that survives fork() (internal)
+//
+// A prefork server builds a client in the parent and forks workers. The
+// children inherit copies of every socket and every TLS session the parent
+// had open; using or shutting those down from a child corrupts the
+// parent's connections. These helpers let a child drop its copies cleanly
+// while keeping what is safe to share, such as resolved API addresses.
+
+#ifndef PXSHOT_FORK_SUPPORT_HPP
+#define PXSHOT_FORK_SUPPORT_HPP
+
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace pxshot {
+namespace detail {
+
+/// Sockets opened on behalf of a client. Entries are keyed by descriptor
+/// and remember the socket's inode, so a descriptor that has since been
+/// closed and reused for something else is never mistaken for ours.
+class SocketTracker {
+public:
+    /// Record a newly opened socket
+    void add(int fd);
+    
+    /// Close this process's descriptors for all recorded sockets that are
+    /// still open. close() without shutdown() leaves the connection itself
+    /// untouched, so the parent's copies keep working.
+    void close_inherited();
+    
+    void lock() { mutex_.lock(); }
+    void unlock() { mutex_.unlock(); }
+
+private:
+    std::mutex mutex_;
+    std::unordered_map<int, unsigned long> sockets_;   // fd -> inode
+};
+
+/// Resolved addresses per host, refreshed after a TTL. Inherited by forked
+/// children, which then connect without resolving again.
+class DnsCache {
+public:
+    using Clock = std::chrono::steady_clock;
+    
+    explicit DnsCache(Clock::duration ttl) : ttl_(ttl) {}
+    
+    /// Numeric addresses for `host`, resolving if missing or stale. If
+    /// resolution fails the previous addresses are kept; with none, the
+    /// result is empty and callers resolve (and report errors) themselves.
+    /// The lock is not held while resolving, so a slow resolver never
+    /// holds up fork().
+    [[nodiscard]] std::vector<std::string> lookup(const std::string& host);
+    
+    void lock() { mutex_.lock(); }
+    void unlock() { mutex_.unlock(); }
+
+private:
+    struct Entry {
+        std::vector<std::string> addresses;
+        Clock::time_point resolved;
+    };
+    
+    Clock::duration ttl_;
+    std::mutex mutex_;
+    std::unordered_map<std::string, Entry> entries_;
+};
+
+} // namespace detail
+} // namespace pxshot
+
+#endif // PXSHOT_FORK_SUPPORT_HPP
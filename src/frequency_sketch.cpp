@@ -0,0 +1,115 @@
+// Pxshot C++ SDK - Request frequency sketch
+
+#include "frequency_sketch.hpp"
+
+#include <algorithm>
+
+namespace pxshot {
+namespace detail {
+
+namespace {
+
+constexpr size_t kMinCapacity = 256;
+constexpr int kDepth = 4;                   // Counters per key, the minimum of which is its count
+constexpr int kProbes = 2;                  // Doorkeeper bits per key
+constexpr uint64_t kMaxCount = 15;
+
+// Each key's counters and doorkeeper bits are picked by its own hash
+// remixed with a per-probe seed (splitmix64's finalizer)
+uint64_t mix(uint64_t hash, int probe) {
+    uint64_t x = hash + static_cast<uint64_t>(probe + 1) * 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+size_t ceil_pow2(size_t n) {
+    size_t p = 1;
+    while (p < n) {
+        p <<= 1;
+    }
+    return p;
+}
+
+/// Grow `words` to `size` by repeating its contents. Counters and bits are
+/// picked by the low bits of a key's mixed hash, so under the wider mask
+/// every key finds the same values it had, and keeps its count.
+void repeat(std::vector<uint64_t>& words, size_t size) {
+    size_t old = words.size();
+    words.resize(size);
+    for (size_t i = old; old > 0 && i < size; ++i) {
+        words[i] = words[i - old];
+    }
+}
+
+} // namespace
+
+void FrequencySketch::ensure_capacity(size_t keys) {
+    size_t wanted = std::max(kMinCapacity, keys);
+    if (wanted <= capacity_) {
+        return;
+    }
+    capacity_ = std::max(ceil_pow2(wanted), capacity_ * 2);
+    // One word per key each: 16 counters shared by the sketch's rows, and
+    // 64 doorkeeper bits, about 2% false positives over a sample
+    repeat(counters_, capacity_);
+    repeat(doorkeeper_, capacity_);
+    sample_size_ = 10 * static_cast<uint64_t>(capacity_);
+}
+
+void FrequencySketch::increment(uint64_t hash) {
+    if (!admitted(hash)) {
+        size_t mask = capacity_ * 64 - 1;
+        for (int probe = 0; probe < kProbes; ++probe) {
+            size_t bit = mix(hash, kDepth + probe) & mask;
+            doorkeeper_[bit >> 6] |= uint64_t{1} << (bit & 63);
+        }
+    } else {
+        size_t mask = capacity_ * 16 - 1;
+        for (int row = 0; row < kDepth; ++row) {
+            size_t counter = mix(hash, row) & mask;
+            uint64_t& word = counters_[counter >> 4];
+            int shift = static_cast<int>(counter & 15) * 4;
+            if (((word >> shift) & kMaxCount) < kMaxCount) {
+                word += uint64_t{1} << shift;
+            }
+        }
+    }
+    if (++additions_ >= sample_size_) {
+        age();
+    }
+}
+
+int FrequencySketch::frequency(uint64_t hash) const {
+    size_t mask = capacity_ * 16 - 1;
+    uint64_t count = kMaxCount;
+    for (int row = 0; row < kDepth; ++row) {
+        size_t counter = mix(hash, row) & mask;
+        count = std::min(count, (counters_[counter >> 4] >> ((counter & 15) * 4)) & kMaxCount);
+    }
+    return static_cast<int>(count) + (admitted(hash) ? 1 : 0);
+}
+
+bool FrequencySketch::admitted(uint64_t hash) const {
+    size_t mask = capacity_ * 64 - 1;
+    for (int probe = 0; probe < kProbes; ++probe) {
+        size_t bit = mix(hash, kDepth + probe) & mask;
+        if (!(doorkeeper_[bit >> 6] & (uint64_t{1} << (bit & 63)))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void FrequencySketch::age() {
+    // Shifting the whole word halves all 16 counters; the mask drops the
+    // bit each one shifts into its neighbour
+    for (auto& word : counters_) {
+        word = (word >> 1) & 0x7777777777777777ULL;
+    }
+    std::fill(doorkeeper_.begin(), doorkeeper_.end(), 0);
+    additions_ /= 2;
+}
+
+} // namespace detail
+} // namespace pxshot
@@ -0,0 +1,51 @@
+// Pxshot C++ SDK - Request frequency sketch (internal)
+
+#ifndef PXSHOT_FREQUENCY_SKETCH_HPP
+#define PXSHOT_FREQUENCY_SKETCH_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace pxshot {
+namespace detail {
+
+/// Approximate recent request counts of keys, for the result cache's
+/// admission policy (TinyLFU). A doorkeeper Bloom filter absorbs each
+/// key's first request, so the many keys requested once never reach the
+/// count-min sketch of 4-bit counters behind it. Counts saturate at 15
+/// plus the doorkeeper's one, and are halved (and the doorkeeper
+/// cleared) every ten requests per key of capacity, so old popularity
+/// fades. Not thread-safe.
+class FrequencySketch {
+public:
+    FrequencySketch() { ensure_capacity(0); }
+    
+    /// Make room for about `keys` distinct keys, doubling capacity at
+    /// least. Counts survive growth, though collisions from before it do
+    /// too until they age out.
+    void ensure_capacity(size_t keys);
+    
+    /// Count a request for the key with hash `hash`
+    void increment(uint64_t hash);
+    
+    /// Requests counted for the key with hash `hash`, 0-16
+    [[nodiscard]] int frequency(uint64_t hash) const;
+
+private:
+    std::vector<uint64_t> counters_;    // 16 4-bit counters per word
+    std::vector<uint64_t> doorkeeper_;  // Bloom filter bits
+    size_t capacity_ = 0;               // Keys sized for, a power of two
+    uint64_t additions_ = 0;            // Since counts were last halved
+    uint64_t sample_size_ = 0;          // Additions between halvings
+    
+    [[nodiscard]] bool admitted(uint64_t hash) const;
+    
+    /// Halve every count and clear the doorkeeper
+    void age();
+};
+
+} // namespace detail
+} // namespace pxshot
+
+#endif // PXSHOT_FREQUENCY_SKETCH_HPP
@@ -0,0 +1,207 @@
+// Pxshot C++ SDK - Per-host performance sketches
+
+#include "host_report.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+namespace pxshot {
+namespace detail {
+
+namespace {
+
+constexpr const char* kOtherHosts = "(other hosts)";
+
+} // namespace
+
+// =============================================================================
+// LogHistogram
+// =============================================================================
+
+size_t LogHistogram::bucket_of(double value) {
+    if (!(value >= 1)) {
+        return 0;   // Below one unit, and NaN
+    }
+    int exponent = 0;
+    double fraction = std::frexp(value, &exponent);     // value = fraction * 2^exponent, fraction in [0.5, 1)
+    if (exponent > kOctaves) {
+        return 1 + kOctaves * kSubBuckets - 1;
+    }
+    auto sub = static_cast<int>((fraction * 2 - 1) * kSubBuckets);
+    return 1 + static_cast<size_t>((exponent - 1) * kSubBuckets + sub);
+}
+
+double LogHistogram::midpoint_of(size_t bucket) {
+    if (bucket == 0) {
+        return 0.5;
+    }
+    auto octave = static_cast<int>((bucket - 1) / kSubBuckets);
+    auto sub = static_cast<int>((bucket - 1) % kSubBuckets);
+    double base = std::ldexp(1.0, octave);
+    return base + base * (sub + 0.5) / kSubBuckets;
+}
+
+void LogHistogram::add(double value) {
+    ++counts_[bucket_of(value)];
+    ++count_;
+    sum_ += value;
+    max_ = std::max(max_, value);
+}
+
+Distribution LogHistogram::summary() const {
+    Distribution d;
+    d.count = count_;
+    if (count_ == 0) {
+        return d;
+    }
+    d.mean = sum_ / static_cast<double>(count_);
+    d.max = max_;
+    
+    auto quantile = [&](double q) {
+        auto rank = static_cast<uint64_t>(std::ceil(q * static_cast<double>(count_)));
+        uint64_t seen = 0;
+        for (size_t i = 0; i < counts_.size(); ++i) {
+            seen += counts_[i];
+            if (seen >= std::max<uint64_t>(rank, 1)) {
+                // The top bucket also holds everything beyond 2^kOctaves
+                return i + 1 == counts_.size() ? max_ : std::min(midpoint_of(i), max_);
+            }
+        }
+        return max_;
+    };
+    d.p50 = quantile(0.5);
+    d.p90 = quantile(0.9);
+    d.p99 = quantile(0.99);
+    return d;
+}
+
+// =============================================================================
+// HostSketches
+// =============================================================================
+
+HostSketches::Host& HostSketches::entry(const std::string& host) {
+    if (auto it = hosts_.find(host); it != hosts_.end()) {
+        return *it->second;
+    }
+    const auto& key = hosts_.size() < kMaxHosts ? host : std::string(kOtherHosts);
+    auto& slot = hosts_[key];
+    if (!slot) {
+        slot = std::make_unique<Host>();
+    }
+    return *slot;
+}
+
+void HostSketches::record_success(const std::string& host, double latency_ms, double bytes) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& h = entry(host);
+    ++h.requests;
+    h.total_ms += latency_ms;
+    h.latency_ms.add(latency_ms);
+    h.bytes.add(bytes);
+}
+
+void HostSketches::record_failure(const std::string& host, double elapsed_ms, const std::string& label) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& h = entry(host);
+    ++h.requests;
+    ++h.failures;
+    h.total_ms += elapsed_ms;
+    h.wasted_ms += elapsed_ms;
+    
+    auto it = std::find_if(h.errors.begin(), h.errors.end(),
+                           [&](const auto& e) { return e.first == label; });
+    if (it == h.errors.end()) {
+        if (h.errors.size() + 1 < kMaxErrorLabels) {
+            it = h.errors.insert(h.errors.end(), {label, 0});
+        } else {
+            it = std::find_if(h.errors.begin(), h.errors.end(),
+                              [](const auto& e) { return e.first == "other"; });
+            if (it == h.errors.end()) {
+                it = h.errors.insert(h.errors.end(), {"other", 0});
+            }
+        }
+    }
+    ++it->second;
+}
+
+void HostSketches::record_retry(const std::string& host) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++entry(host).retries;
+}
+
+HostReport HostSketches::report(bool reset) {
+    HostReport report;
+    std::unordered_map<std::string, std::unique_ptr<Host>> finished;   // Freed outside the lock
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        report.since = since_;
+        for (const auto& [name, h] : hosts_) {
+            HostStats stats;
+            stats.host = name;
+            stats.requests = h->requests;
+            stats.failures = h->failures;
+            stats.retries = h->retries;
+            stats.latency_ms = h->latency_ms.summary();
+            stats.bytes = h->bytes.summary();
+            stats.errors = h->errors;
+            stats.total_ms = h->total_ms;
+            stats.wasted_ms = h->wasted_ms;
+            report.hosts.push_back(std::move(stats));
+        }
+        if (reset) {
+            finished.swap(hosts_);
+            since_ = std::chrono::system_clock::now();
+        }
+    }
+    
+    for (auto& stats : report.hosts) {
+        std::sort(stats.errors.begin(), stats.errors.end(),
+                  [](const auto& a, const auto& b) { return a.second > b.second; });
+    }
+    std::sort(report.hosts.begin(), report.hosts.end(),
+              [](const HostStats& a, const HostStats& b) { return a.total_ms > b.total_ms; });
+    return report;
+}
+
+std::string error_label(std::exception_ptr error) {
+    try {
+        std::rethrow_exception(error);
+    } catch (const ApiError& e) {
+        return "api:" + e.error_code;
+    } catch (const HttpError& e) {
+        return e.status_code > 0 ? "http_" + std::to_string(e.status_code) : "network";
+    } catch (const CancelledError&) {
+        return "cancelled";
+    } catch (const HandoverError&) {
+        return "handover";
+    } catch (...) {
+        return "other";
+    }
+}
+
+} // namespace detail
+
+std::string to_string(const HostReport& report) {
+    std::string text;
+    char line[256];
+    std::snprintf(line, sizeof(line), "%-32s %8s %6s %7s %9s %9s %9s %9s %10s\n", "host", "requests",
+                  "failed", "retries", "p50 ms", "p99 ms", "p50 KB", "p99 KB", "wasted s");
+    text += line;
+    for (const auto& h : report.hosts) {
+        std::snprintf(line, sizeof(line), "%-32.32s %8llu %6llu %7llu %9.0f %9.0f %9.1f %9.1f %10.1f",
+                      h.host.empty() ? "(no host)" : h.host.c_str(),
+                      static_cast<unsigned long long>(h.requests),
+                      static_cast<unsigned long long>(h.failures),
+                      static_cast<unsigned long long>(h.retries), h.latency_ms.p50, h.latency_ms.p99,
+                      h.bytes.p50 / 1024, h.bytes.p99 / 1024, h.wasted_ms / 1000);
+        text += line;
+        for (const auto& [label, count] : h.errors) {
+            text += "  " + label + "=" + std::to_string(count);
+        }
+        text += '\n';
+    }
+    return text;
+}
+
+} // namespace pxshot
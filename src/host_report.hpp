@@ -0,0 +1,100 @@
+// Pxshot C++ SDK - Per-host performance sketches (internal)
+
+#ifndef PXSHOT_HOST_REPORT_HPP
+#define PXSHOT_HOST_REPORT_HPP
+
+#include "pxshot/pxshot.hpp"
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace pxshot {
+namespace detail {
+
+/// Log-linear histogram in the style of HDR Histogram: each power of two
+/// is split into kSubBuckets equal buckets, so any value is stored within
+/// 1/kSubBuckets of itself in a few kilobytes, however many are added.
+class LogHistogram {
+public:
+    void add(double value);
+    
+    [[nodiscard]] uint64_t count() const { return count_; }
+    
+    /// Summary with quantiles read from the bucket midpoints. Values below
+    /// 1 read as 0.5, and those in the top bucket as the maximum.
+    [[nodiscard]] Distribution summary() const;
+
+private:
+    static constexpr int kSubBuckets = 8;
+    static constexpr int kOctaves = 48;         // Values up to 2^48
+    
+    std::array<uint32_t, 1 + kOctaves * kSubBuckets> counts_{};
+    uint64_t count_ = 0;
+    double sum_ = 0;
+    double max_ = 0;
+    
+    [[nodiscard]] static size_t bucket_of(double value);
+    [[nodiscard]] static double midpoint_of(size_t bucket);
+};
+
+/// Streaming per-host statistics for HostReport. Memory is bounded: each
+/// host costs a fixed few kilobytes, hosts beyond kMaxHosts share one
+/// catch-all entry, and each host keeps at most kMaxErrorLabels distinct
+/// error labels.
+class HostSketches {
+public:
+    static constexpr size_t kMaxHosts = 1024;
+    static constexpr size_t kMaxErrorLabels = 16;
+    
+    HostSketches() : since_(std::chrono::system_clock::now()) {}
+    
+    void record_success(const std::string& host, double latency_ms, double bytes);
+    
+    /// A request that produced no result after `elapsed_ms`
+    void record_failure(const std::string& host, double elapsed_ms, const std::string& label);
+    
+    /// A request sent again after an earlier attempt went unanswered
+    void record_retry(const std::string& host);
+    
+    /// Summaries of everything since the last reset, most time spent first
+    [[nodiscard]] HostReport report(bool reset);
+    
+    void lock() { mutex_.lock(); }
+    void unlock() { mutex_.unlock(); }
+
+private:
+    struct Host {
+        uint64_t requests = 0;
+        uint64_t failures = 0;
+        uint64_t retries = 0;
+        double total_ms = 0;
+        double wasted_ms = 0;
+        LogHistogram latency_ms;
+        LogHistogram bytes;
+        std::vector<std::pair<std::string, uint64_t>> errors;
+    };
+    
+    std::mutex mutex_;
+    std::unordered_map<std::string, std::unique_ptr<Host>> hosts_;
+    std::chrono::system_clock::time_point since_;
+    
+    /// Entry for `host`, or the catch-all once the table is full.
+    /// Requires mutex_.
+    Host& entry(const std::string& host);
+};
+
+/// Short label for a failed request's error, e.g. "api:rate_limited",
+/// "http_502", "network", "cancelled"
+[[nodiscard]] std::string error_label(std::exception_ptr error);
+
+} // namespace detail
+} // namespace pxshot
+
+#endif // PXSHOT_HOST_REPORT_HPP
@@ -0,0 +1,625 @@
+// Pxshot C++ SDK - Downsampled image previews
+
+#include "image_preview.hpp"
+
+#ifdef PXSHOT_HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+namespace pxshot {
+namespace detail {
+
+namespace {
+
+// Images beyond these are not decoded, so a corrupt or hostile header
+// cannot make a check allocate or run without bound
+constexpr uint64_t kMaxSourcePixels = uint64_t{1} << 28;
+constexpr size_t kMaxRowBytes = size_t{1} << 26;
+
+uint32_t big_endian(const uint8_t* p, int bytes) {
+    uint32_t value = 0;
+    for (int i = 0; i < bytes; ++i) {
+        value = value << 8 | p[i];
+    }
+    return value;
+}
+
+/// Sampling step that leaves at most about `max_pixels` of a width x height grid
+uint32_t grid_step(uint64_t width, uint64_t height, size_t max_pixels) {
+    double ratio = static_cast<double>(width * height) / static_cast<double>(std::max<size_t>(1, max_pixels));
+    return std::max<uint32_t>(1, static_cast<uint32_t>(std::ceil(std::sqrt(ratio))));
+}
+
+/// Empty preview sized for a width x height grid sampled every `step`
+Preview preview_for(uint32_t width, uint32_t height, uint32_t step) {
+    Preview preview;
+    preview.width = static_cast<int>((width + step - 1) / step);
+    preview.height = static_cast<int>((height + step - 1) / step);
+    size_t pixels = static_cast<size_t>(preview.width) * static_cast<size_t>(preview.height);
+    preview.red.reserve(pixels);
+    preview.green.reserve(pixels);
+    preview.blue.reserve(pixels);
+    return preview;
+}
+
+void push(Preview& preview, uint8_t red, uint8_t green, uint8_t blue) {
+    preview.red.push_back(red);
+    preview.green.push_back(green);
+    preview.blue.push_back(blue);
+}
+
+#ifdef PXSHOT_HAVE_ZLIB
+
+/// Paeth predictor, in the branch-free form libpng uses: the distances
+/// of a + b - c to a, b and c are |b - c|, |a - c| and |a + b - 2c|
+uint8_t paeth(int a, int b, int c) {
+    int pa = std::abs(b - c);
+    int pb = std::abs(a - c);
+    int pc = std::abs(a + b - 2 * c);
+    int nearest = pb < pa ? b : a;
+    int distance = pb < pa ? pb : pa;
+    return static_cast<uint8_t>(pc < distance ? c : nearest);
+}
+
+/// Undo the filter of one PNG row in place, given the unfiltered row above
+bool unfilter(uint8_t filter, uint8_t* row, const uint8_t* above, size_t length, size_t pixel_bytes) {
+    switch (filter) {
+        case 0:
+            return true;
+        case 1:
+            for (size_t i = pixel_bytes; i < length; ++i) {
+                row[i] = static_cast<uint8_t>(row[i] + row[i - pixel_bytes]);
+            }
+            return true;
+        case 2:
+            for (size_t i = 0; i < length; ++i) {
+                row[i] = static_cast<uint8_t>(row[i] + above[i]);
+            }
+            return true;
+        case 3:
+            for (size_t i = 0; i < length; ++i) {
+                int left = i >= pixel_bytes ? row[i - pixel_bytes] : 0;
+                row[i] = static_cast<uint8_t>(row[i] + ((left + above[i]) >> 1));
+            }
+            return true;
+        case 4:
+            for (size_t i = 0; i < pixel_bytes && i < length; ++i) {
+                row[i] = static_cast<uint8_t>(row[i] + above[i]);
+            }
+            for (size_t i = pixel_bytes; i < length; ++i) {
+                row[i] = static_cast<uint8_t>(row[i] + paeth(row[i - pixel_bytes], above[i],
+                                                             above[i - pixel_bytes]));
+            }
+            return true;
+        default:
+            return false;
+    }
+}
+
+std::optional<Preview> png_preview(const uint8_t* p, size_t size, size_t max_pixels) {
+    if (size < 33 || std::memcmp(p + 12, "IHDR", 4) != 0) {
+        return std::nullopt;
+    }
+    uint32_t width = big_endian(p + 16, 4);
+    uint32_t height = big_endian(p + 20, 4);
+    int depth = p[24];
+    int color = p[25];
+    int channels = 0;
+    switch (color) {
+        case 0: channels = 1; break;    // Grey
+        case 2: channels = 3; break;    // RGB
+        case 3: channels = 1; break;    // Palette
+        case 4: channels = 2; break;    // Grey and alpha
+        case 6: channels = 4; break;    // RGBA
+        default: return std::nullopt;
+    }
+    bool interlaced = p[28] != 0;
+    if (width == 0 || height == 0 || uint64_t{width} * height > kMaxSourcePixels || interlaced ||
+        !(depth == 8 || (depth == 16 && color != 3))) {
+        return std::nullopt;
+    }
+    size_t sample_bytes = static_cast<size_t>(depth / 8);
+    size_t pixel_bytes = static_cast<size_t>(channels) * sample_bytes;
+    size_t row_bytes = width * pixel_bytes;
+    if (row_bytes > kMaxRowBytes) {
+        return std::nullopt;
+    }
+    
+    uint32_t step = grid_step(width, height, max_pixels);
+    auto preview = preview_for(width, height, step);
+    std::array<uint8_t, 768> palette{};
+    
+    // Alpha is ignored: pixels count by their colour. 16-bit samples are
+    // big-endian, so their first byte is the 8-bit value.
+    auto sample = [&](const uint8_t* row) {
+        for (uint32_t x = 0; x < width; x += step) {
+            const uint8_t* pixel = row + x * pixel_bytes;
+            if (color == 3) {
+                const uint8_t* entry = palette.data() + 3 * pixel[0];
+                push(preview, entry[0], entry[1], entry[2]);
+            } else if (channels >= 3) {
+                push(preview, pixel[0], pixel[sample_bytes], pixel[2 * sample_bytes]);
+            } else {
+                push(preview, pixel[0], pixel[0], pixel[0]);
+            }
+        }
+    };
+    
+    // Each row is a filter byte and row_bytes of samples; the one above is
+    // zero for the first row
+    std::vector<uint8_t> current(row_bytes + 1);
+    std::vector<uint8_t> above(row_bytes + 1, 0);
+    size_t filled = 0;
+    uint32_t y = 0;
+    
+    z_stream stream{};
+    if (inflateInit(&stream) != Z_OK) {
+        return std::nullopt;
+    }
+    struct InflateEnd {
+        z_stream& stream;
+        ~InflateEnd() { inflateEnd(&stream); }
+    } end{stream};
+    
+    // CRCs are not checked: a corrupt image fails to inflate or yields a
+    // preview that is merely wrong, and the check is advisory
+    size_t i = 8;
+    while (i + 12 <= size && y < height) {
+        uint32_t length = big_endian(p + i, 4);
+        if (length > size - i - 12) {
+            return std::nullopt;
+        }
+        const uint8_t* type = p + i + 4;
+        const uint8_t* data = p + i + 8;
+        if (std::memcmp(type, "PLTE", 4) == 0) {
+            std::memcpy(palette.data(), data, std::min<size_t>(length, palette.size()));
+        } else if (std::memcmp(type, "IDAT", 4) == 0) {
+            stream.next_in = const_cast<Bytef*>(data);
+            stream.avail_in = length;
+            while (stream.avail_in > 0 && y < height) {
+                stream.next_out = current.data() + filled;
+                stream.avail_out = static_cast<uInt>(current.size() - filled);
+                int status = inflate(&stream, Z_NO_FLUSH);
+                if (status != Z_OK && status != Z_STREAM_END) {
+                    return std::nullopt;
+                }
+                filled = current.size() - stream.avail_out;
+                if (filled == current.size()) {
+                    if (!unfilter(current[0], current.data() + 1, above.data() + 1, row_bytes, pixel_bytes)) {
+                        return std::nullopt;
+                    }
+                    if (y % step == 0) {
+                        sample(current.data() + 1);
+                    }
+                    current.swap(above);
+                    filled = 0;
+                    ++y;
+                } else if (status == Z_STREAM_END) {
+                    break;
+                }
+            }
+        } else if (std::memcmp(type, "IEND", 4) == 0) {
+            break;
+        }
+        i += 12 + length;
+    }
+    if (y < height) {
+        return std::nullopt;        // Truncated
+    }
+    return preview;
+}
+
+#endif // PXSHOT_HAVE_ZLIB
+
+/// Canonical Huffman table of a JPEG scan, with a lookup for short codes
+struct Huffman {
+    static constexpr int kFastBits = 9;
+    
+    std::array<uint16_t, 1 << kFastBits> fast{};    // Length << 8 | symbol; 0 for longer codes
+    std::array<int32_t, 17> max_code{};             // Largest code of each length (-1 = none)
+    std::array<int32_t, 17> offset{};               // Index into symbols, less the first code
+    std::array<uint8_t, 256> symbols{};
+    size_t count = 0;
+    bool defined = false;
+};
+
+/// Build `table` from a DHT segment's 16 code counts and its symbols
+bool build(Huffman& table, const uint8_t* counts, const uint8_t* values, size_t total) {
+    table = Huffman{};
+    std::copy(values, values + total, table.symbols.begin());
+    table.count = total;
+    int32_t code = 0;
+    size_t k = 0;
+    for (int length = 1; length <= 16; ++length) {
+        int n = counts[length - 1];
+        if (code + n > 1 << length) {
+            return false;           // More codes than the length allows
+        }
+        table.offset[length] = static_cast<int32_t>(k) - code;
+        table.max_code[length] = n > 0 ? code + n - 1 : -1;
+        for (int j = 0; j < n; ++j, ++k, ++code) {
+            if (length <= Huffman::kFastBits) {
+                int shift = Huffman::kFastBits - length;
+                for (int fill = 0; fill < 1 << shift; ++fill) {
+                    table.fast[static_cast<size_t>(code << shift | fill)] =
+                        static_cast<uint16_t>(length << 8 | values[k]);
+                }
+            }
+        }
+        code <<= 1;
+    }
+    table.defined = true;
+    return true;
+}
+
+/// Bits of an entropy-coded JPEG segment, most significant first, with
+/// stuffed zero bytes removed. Reading stops at the next marker; past it
+/// the reader yields zeros.
+class BitReader {
+public:
+    BitReader(const uint8_t* begin, const uint8_t* end) : p_(begin), end_(end) {}
+    
+    /// Next Huffman symbol, or -1 for a code the table does not have
+    int decode(const Huffman& table) {
+        if (count_ < 16) {
+            fill();
+        }
+        auto entry = table.fast[bits_ >> (64 - Huffman::kFastBits)];
+        if (entry != 0) {
+            consume(entry >> 8);
+            return entry & 0xFF;
+        }
+        for (int length = Huffman::kFastBits + 1; length <= 16; ++length) {
+            auto code = static_cast<int32_t>(bits_ >> (64 - length));
+            if (code <= table.max_code[length]) {
+                auto index = static_cast<size_t>(table.offset[length] + code);
+                if (index >= table.count) {
+                    return -1;
+                }
+                consume(length);
+                return table.symbols[index];
+            }
+        }
+        return -1;
+    }
+    
+    /// Signed value of a `bits`-bit magnitude category
+    int receive(int bits) {
+        if (bits == 0) {
+            return 0;
+        }
+        if (count_ < bits) {
+            fill();
+        }
+        auto value = static_cast<int>(bits_ >> (64 - bits));
+        consume(bits);
+        return value < 1 << (bits - 1) ? value - (1 << bits) + 1 : value;
+    }
+    
+    void skip(int bits) {
+        if (count_ < bits) {
+            fill();
+        }
+        consume(bits);
+    }
+    
+    /// Move past the RSTn marker that ends a restart interval, dropping the
+    /// padding bits before it
+    bool restart() {
+        bits_ = 0;
+        count_ = 0;
+        if (!marker_) {
+            while (p_ + 1 < end_ && !(p_[0] == 0xFF && p_[1] != 0x00)) {
+                ++p_;
+            }
+        }
+        if (p_ + 1 >= end_ || p_[0] != 0xFF || p_[1] < 0xD0 || p_[1] > 0xD7) {
+            return false;
+        }
+        p_ += 2;
+        marker_ = false;
+        return true;
+    }
+
+private:
+    const uint8_t* p_;
+    const uint8_t* end_;
+    uint64_t bits_ = 0;     // Left-aligned
+    int count_ = 0;
+    bool marker_ = false;   // p_ is at a marker
+    
+    void fill() {
+        while (count_ <= 56) {
+            uint64_t byte = 0;
+            if (!marker_ && p_ < end_) {
+                if (*p_ != 0xFF) {
+                    byte = *p_++;
+                } else if (p_ + 1 < end_ && p_[1] == 0x00) {
+                    byte = 0xFF;
+                    p_ += 2;
+                } else {
+                    marker_ = true;
+                }
+            }
+            bits_ |= byte << (56 - count_);
+            count_ += 8;
+        }
+    }
+    
+    void consume(int bits) {
+        bits_ <<= bits;
+        count_ -= bits;
+    }
+};
+
+struct JpegComponent {
+    int id = 0;
+    int h = 1;                  // Sampling factors
+    int v = 1;
+    int quant = 0;              // Table index
+    int dc_table = 0;
+    int ac_table = 0;
+    size_t grid_width = 0;      // Blocks per row of `means`
+    std::vector<uint8_t> means; // Mean of each 8x8 block, level-shifted
+};
+
+std::optional<Preview> jpeg_preview(const uint8_t* p, size_t size, size_t max_pixels) {
+    std::array<int, 4> quant{};             // DC quantizer of each table
+    std::array<Huffman, 4> dc_tables;
+    std::array<Huffman, 4> ac_tables;
+    std::vector<JpegComponent> components;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t restart_interval = 0;
+    int adobe_transform = -1;
+    
+    size_t i = 2;
+    for (;;) {
+        if (i + 4 > size || p[i] != 0xFF) {
+            return std::nullopt;
+        }
+        uint8_t marker = p[i + 1];
+        if (marker == 0xFF) {
+            ++i;        // Fill byte
+            continue;
+        }
+        i += 2;
+        if (marker == 0x01 || (marker >= 0xD0 && marker <= 0xD8)) {
+            continue;
+        }
+        if (marker == 0xD9) {
+            return std::nullopt;    // End of image before a scan
+        }
+        size_t length = big_endian(p + i, 2);
+        if (length < 2 || i + length > size) {
+            return std::nullopt;
+        }
+        const uint8_t* segment = p + i + 2;
+        size_t remaining = length - 2;
+        
+        if (marker == 0xDB) {
+            while (remaining > 0) {
+                int precision = segment[0] >> 4;
+                int table = segment[0] & 15;
+                size_t bytes = precision ? 129 : 65;
+                if (table > 3 || remaining < bytes) {
+                    return std::nullopt;
+                }
+                quant[table] = static_cast<int>(precision ? big_endian(segment + 1, 2) : segment[1]);
+                segment += bytes;
+                remaining -= bytes;
+            }
+        } else if (marker == 0xC4) {
+            while (remaining > 0) {
+                if (remaining < 17) {
+                    return std::nullopt;
+                }
+                int table_class = segment[0] >> 4;
+                int table = segment[0] & 15;
+                size_t total = 0;
+                for (int k = 1; k <= 16; ++k) {
+                    total += segment[k];
+                }
+                if (table_class > 1 || table > 3 || total > 256 || remaining < 17 + total) {
+                    return std::nullopt;
+                }
+                auto& tables = table_class ? ac_tables : dc_tables;
+                if (!build(tables[table], segment + 1, segment + 17, total)) {
+                    return std::nullopt;
+                }
+                segment += 17 + total;
+                remaining -= 17 + total;
+            }
+        } else if (marker == 0xC0 || marker == 0xC1) {
+            if (remaining < 6 || segment[0] != 8) {
+                return std::nullopt;
+            }
+            height = big_endian(segment + 1, 2);
+            width = big_endian(segment + 3, 2);
+            size_t count = segment[5];
+            if ((count != 1 && count != 3) || remaining < 6 + 3 * count || width == 0 || height == 0 ||
+                uint64_t{width} * height > kMaxSourcePixels) {
+                return std::nullopt;
+            }
+            components.resize(count);
+            for (size_t c = 0; c < count; ++c) {
+                const uint8_t* spec = segment + 6 + 3 * c;
+                auto& component = components[c];
+                component.id = spec[0];
+                component.h = count == 1 ? 1 : spec[1] >> 4;
+                component.v = count == 1 ? 1 : spec[1] & 15;
+                component.quant = spec[2];
+                if (component.h < 1 || component.h > 4 || component.v < 1 || component.v > 4 ||
+                    component.quant > 3) {
+                    return std::nullopt;
+                }
+            }
+        } else if ((marker >= 0xC2 && marker <= 0xCF) && marker != 0xC4 && marker != 0xC8 && marker != 0xCC) {
+            return std::nullopt;    // Progressive, lossless or arithmetic coding
+        } else if (marker == 0xDD) {
+            if (remaining < 2) {
+                return std::nullopt;
+            }
+            restart_interval = big_endian(segment, 2);
+        } else if (marker == 0xEE) {
+            if (remaining >= 12 && std::memcmp(segment, "Adobe", 5) == 0) {
+                adobe_transform = segment[11];
+            }
+        } else if (marker == 0xDA) {
+            // Only a single interleaved scan of every component is supported
+            if (components.empty() || remaining < 1 || segment[0] != static_cast<uint8_t>(components.size()) ||
+                remaining < 1 + 2 * components.size()) {
+                return std::nullopt;
+            }
+            for (size_t c = 0; c < components.size(); ++c) {
+                const uint8_t* spec = segment + 1 + 2 * c;
+                auto& component = components[c];
+                component.dc_table = spec[1] >> 4;
+                component.ac_table = spec[1] & 15;
+                if (spec[0] != component.id || component.dc_table > 3 || component.ac_table > 3 ||
+                    !dc_tables[component.dc_table].defined || !ac_tables[component.ac_table].defined) {
+                    return std::nullopt;
+                }
+            }
+            i += length;
+            break;
+        }
+        i += length;
+    }
+    
+    int h_max = 1;
+    int v_max = 1;
+    for (const auto& component : components) {
+        h_max = std::max(h_max, component.h);
+        v_max = std::max(v_max, component.v);
+    }
+    uint32_t mcu_columns = (width + 8 * h_max - 1) / (8 * h_max);
+    uint32_t mcu_rows = (height + 8 * v_max - 1) / (8 * v_max);
+    for (auto& component : components) {
+        component.grid_width = size_t{mcu_columns} * component.h;
+        component.means.resize(component.grid_width * mcu_rows * component.v);
+    }
+    
+    // Entropy-decode every block, keeping only the DC coefficient. The AC
+    // coefficients are decoded just far enough to skip them.
+    BitReader reader(p + i, p + size);
+    std::array<int, 3> predictors{};
+    uint64_t mcu = 0;
+    for (uint32_t mcu_y = 0; mcu_y < mcu_rows; ++mcu_y) {
+        for (uint32_t mcu_x = 0; mcu_x < mcu_columns; ++mcu_x, ++mcu) {
+            if (restart_interval != 0 && mcu != 0 && mcu % restart_interval == 0) {
+                if (!reader.restart()) {
+                    return std::nullopt;
+                }
+                predictors = {};
+            }
+            for (size_t c = 0; c < components.size(); ++c) {
+                auto& component = components[c];
+                const auto& dc = dc_tables[component.dc_table];
+                const auto& ac = ac_tables[component.ac_table];
+                for (int v = 0; v < component.v; ++v) {
+                    for (int h = 0; h < component.h; ++h) {
+                        int category = reader.decode(dc);
+                        if (category < 0 || category > 11) {
+                            return std::nullopt;
+                        }
+                        // Clamped so corrupt data cannot overflow the sum
+                        predictors[c] = std::clamp(predictors[c] + reader.receive(category), -65535, 65535);
+                        for (int k = 1; k < 64;) {
+                            int symbol = reader.decode(ac);
+                            if (symbol < 0) {
+                                return std::nullopt;
+                            }
+                            int run = symbol >> 4;
+                            int bits = symbol & 15;
+                            if (bits == 0) {
+                                if (run != 15) {
+                                    break;      // End of block
+                                }
+                                k += 16;
+                                continue;
+                            }
+                            k += run + 1;
+                            reader.skip(bits);
+                        }
+                        // The DC coefficient is eight times the block's mean.
+                        // Both factors reach 65535, so their product needs
+                        // 64 bits.
+                        int64_t dc = int64_t{predictors[c]} * quant[component.quant];
+                        auto mean = static_cast<int>(std::clamp<int64_t>(128 + dc / 8, 0, 255));
+                        size_t row = size_t{mcu_y} * component.v + v;
+                        size_t column = size_t{mcu_x} * component.h + h;
+                        component.means[row * component.grid_width + column] =
+                            static_cast<uint8_t>(mean);
+                    }
+                }
+            }
+        }
+    }
+    
+    // Preview pixels are 8x8 blocks at full resolution; each component's
+    // block covering one is found by its sampling factors
+    uint32_t blocks_wide = (width + 7) / 8;
+    uint32_t blocks_high = (height + 7) / 8;
+    uint32_t step = grid_step(blocks_wide, blocks_high, max_pixels);
+    auto preview = preview_for(blocks_wide, blocks_high, step);
+    auto mean_at = [&](const JpegComponent& component, uint32_t x, uint32_t y) {
+        size_t row = size_t{y} * component.v / v_max;
+        size_t column = size_t{x} * component.h / h_max;
+        return component.means[row * component.grid_width + column];
+    };
+    bool rgb = components.size() == 3 &&
+               (adobe_transform == 0 ||
+                (components[0].id == 'R' && components[1].id == 'G' && components[2].id == 'B'));
+    for (uint32_t y = 0; y < blocks_high; y += step) {
+        for (uint32_t x = 0; x < blocks_wide; x += step) {
+            uint8_t first = mean_at(components[0], x, y);
+            if (components.size() == 1) {
+                push(preview, first, first, first);
+                continue;
+            }
+            uint8_t second = mean_at(components[1], x, y);
+            uint8_t third = mean_at(components[2], x, y);
+            if (rgb) {
+                push(preview, first, second, third);
+                continue;
+            }
+            double luma = first;
+            double cb = second - 128.0;
+            double cr = third - 128.0;
+            auto channel = [](double value) {
+                return static_cast<uint8_t>(std::clamp(std::lround(value), 0L, 255L));
+            };
+            push(preview, channel(luma + 1.402 * cr), channel(luma - 0.344136 * cb - 0.714136 * cr),
+                 channel(luma + 1.772 * cb));
+        }
+    }
+    return preview;
+}
+
+} // namespace
+
+std::optional<Preview> decode_preview(const std::vector<uint8_t>& image, size_t max_pixels) {
+    const uint8_t* p = image.data();
+    size_t size = image.size();
+    if (size >= 8 && std::memcmp(p, "\x89PNG\r\n\x1a\n", 8) == 0) {
+#ifdef PXSHOT_HAVE_ZLIB
+        return png_preview(p, size, max_pixels);
+#else
+        return std::nullopt;
+#endif
+    }
+    if (size >= 4 && p[0] == 0xFF && p[1] == 0xD8) {
+        return jpeg_preview(p, size, max_pixels);
+    }
+    return std::nullopt;
+}
+
+} // namespace detail
+} // namespace pxshot
@@ -0,0 +1,41 @@
+// Pxshot C++ SDK - Downsampled image previews (internal)
+//
+// Just enough of PNG and baseline JPEG to produce a small RGB preview of a
+// capture for content checks, without depending on an image library. PNG
+// rows are inflated with zlib and unfiltered one at a time, and every
+// step-th pixel of every step-th row is kept. JPEG scans are entropy
+// decoded but never transformed: each 8x8 block's DC coefficient is its
+// mean, so the preview is the image at 1/8 scale. WebP, interlaced PNG and
+// progressive or arithmetic-coded JPEG are not supported.
+
+#ifndef PXSHOT_IMAGE_PREVIEW_HPP
+#define PXSHOT_IMAGE_PREVIEW_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace pxshot {
+namespace detail {
+
+/// RGB pixels in planar rows, so checks can scan each channel with SIMD
+struct Preview {
+    int width = 0;
+    int height = 0;
+    std::vector<uint8_t> red;
+    std::vector<uint8_t> green;
+    std::vector<uint8_t> blue;
+    
+    [[nodiscard]] size_t pixels() const noexcept { return red.size(); }
+};
+
+/// Preview of `image` sampled on an even grid of at most about
+/// `max_pixels`, or empty if the image is malformed or its format is not
+/// supported (PNG is only supported when built with zlib)
+[[nodiscard]] std::optional<Preview> decode_preview(const std::vector<uint8_t>& image, size_t max_pixels);
+
+} // namespace detail
+} // namespace pxshot
+
+#endif // PXSHOT_IMAGE_PREVIEW_HPP
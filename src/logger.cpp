@@ -0,0 +1,342 @@
+// Pxshot C++ SDK - Asynchronous structured logging
+
+#include "logger.hpp"
+#include "cost_model.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <string>
+
+namespace pxshot {
+namespace detail {
+
+namespace {
+
+const char* event_name(LogLevel level) {
+    switch (level) {
+        case LogLevel::Error: return "failed";
+        case LogLevel::Warning: return "slow";
+        default: return "done";
+    }
+}
+
+/// Copy as much of `text` as fits; returns the length copied
+uint16_t copy_truncated(char* out, size_t capacity, std::string_view text) {
+    size_t n = std::min(text.size(), capacity);
+    std::memcpy(out, text.data(), n);
+    return static_cast<uint16_t>(n);
+}
+
+/// Describe a request failure into `out`. Rethrowing may allocate, so
+/// this runs on the formatter thread rather than the caller's.
+uint16_t describe_error(std::exception_ptr error, char* out, size_t capacity, int& status) {
+    int n = 0;
+    try {
+        std::rethrow_exception(error);
+    } catch (const ApiError& e) {
+        n = std::snprintf(out, capacity, "api:%s %s", e.error_code.c_str(), e.what());
+    } catch (const HttpError& e) {
+        status = e.status_code;
+        n = e.status_code > 0 ? std::snprintf(out, capacity, "http_%d %s", e.status_code, e.what())
+                              : std::snprintf(out, capacity, "network %s", e.what());
+    } catch (const CancelledError& e) {
+        n = std::snprintf(out, capacity, "cancelled %s", e.what());
+    } catch (const HandoverError& e) {
+        n = std::snprintf(out, capacity, "handover %s", e.what());
+    } catch (const std::exception& e) {
+        n = std::snprintf(out, capacity, "other %s", e.what());
+    } catch (...) {
+        n = std::snprintf(out, capacity, "other");
+    }
+    return static_cast<uint16_t>(std::clamp<int>(n, 0, static_cast<int>(capacity) - 1));
+}
+
+/// Append `value` to a logfmt line, quoted if it needs to be
+void append_value(std::string& line, std::string_view value) {
+    bool quote = value.empty() || value.find_first_of(" \"=") != std::string_view::npos;
+    if (!quote) {
+        line += value;
+        return;
+    }
+    line += '"';
+    for (char c : value) {
+        if (c == '"' || c == '\\') {
+            line += '\\';
+        }
+        line += c;
+    }
+    line += '"';
+}
+
+} // namespace
+
+AsyncLogger::AsyncLogger(LogConfig config) : config_(std::move(config)) {
+    if (!enabled()) {
+        mask_ = 0;
+        return;
+    }
+    size_t capacity = 2;
+    while (capacity < config_.queue_records) {
+        capacity *= 2;
+    }
+    mask_ = capacity - 1;
+    slots_ = std::make_unique<Slot[]>(capacity);
+    reset();
+    thread_ = std::thread([this] { run(); });
+}
+
+AsyncLogger::~AsyncLogger() {
+    if (!thread_.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_one();
+    thread_.join();
+}
+
+void AsyncLogger::reset() {
+    for (size_t i = 0; i <= mask_; ++i) {
+        slots_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    enqueue_pos_.store(0, std::memory_order_relaxed);
+    dequeue_pos_ = 0;
+}
+
+bool sample_evenly(std::atomic<uint64_t>& counter, double rate) {
+    if (rate >= 1) {
+        return true;
+    }
+    if (!(rate > 0)) {
+        return false;
+    }
+    auto n = static_cast<double>(counter.fetch_add(1, std::memory_order_relaxed));
+    return std::floor((n + 1) * rate) > std::floor(n * rate);
+}
+
+bool AsyncLogger::sample(LogLevel level) {
+    if (level < config_.level) {
+        return false;
+    }
+    double rate = 1.0;
+    switch (level) {
+        case LogLevel::Debug: rate = config_.debug_sample_rate; break;
+        case LogLevel::Info: rate = config_.info_sample_rate; break;
+        default: break;
+    }
+    return sample_evenly(sampled_[static_cast<int>(level)], rate);
+}
+
+template <typename Fill>
+void AsyncLogger::push(LogLevel level, Kind kind, Fill&& fill) {
+    size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+    Slot* slot = nullptr;
+    for (;;) {
+        slot = &slots_[pos & mask_];
+        size_t sequence = slot->sequence.load(std::memory_order_acquire);
+        auto lag = static_cast<std::ptrdiff_t>(sequence - pos);
+        if (lag == 0) {
+            if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (lag < 0) {
+            // The formatter has not freed this slot yet: the ring is full
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        } else {
+            pos = enqueue_pos_.load(std::memory_order_relaxed);
+        }
+    }
+    
+    auto& e = slot->entry;
+    e.time = std::chrono::system_clock::now();
+    e.level = level;
+    e.kind = kind;
+    e.priority = Priority::Interactive;
+    e.status = 0;
+    e.latency_ms = 0;
+    e.timings = RequestTimings{};
+    e.bytes = 0;
+    e.url_length = 0;
+    e.text_length = 0;
+    e.error = nullptr;
+    fill(e);
+    slot->sequence.store(pos + 1, std::memory_order_release);
+    
+    // Pairs with the formatter announcing sleep and then checking the ring
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (sleeping_.load(std::memory_order_relaxed)) {
+        cv_.notify_one();
+    }
+}
+
+void AsyncLogger::request_started(const ScreenshotOptions& options, Priority priority) {
+    if (!enabled() || !sample(LogLevel::Debug)) {
+        return;
+    }
+    push(LogLevel::Debug, Kind::Send, [&](Entry& e) {
+        e.priority = priority;
+        e.url_length = copy_truncated(e.url, kUrlBytes, options.url);
+    });
+}
+
+void AsyncLogger::request_finished(const ScreenshotOptions& options, Priority priority, double latency_ms,
+                                   uint64_t bytes, std::exception_ptr error, const RequestTimings& timings) {
+    if (!enabled()) {
+        return;
+    }
+    bool slow = latency_ms >= static_cast<double>(config_.slow_request.count());
+    auto level = error ? LogLevel::Error : slow ? LogLevel::Warning : LogLevel::Info;
+    if (level == LogLevel::Info && !sample(level)) {
+        return;
+    }
+    push(level, Kind::Done, [&](Entry& e) {
+        e.priority = priority;
+        e.latency_ms = latency_ms;
+        e.timings = timings;
+        e.bytes = bytes;
+        e.url_length = copy_truncated(e.url, kUrlBytes, options.url);
+        // Copying the pointer only bumps a reference count
+        e.error = error;
+        e.status = error ? 0 : 200;
+    });
+}
+
+void AsyncLogger::event(LogLevel level, std::string_view message) {
+    // Rare and worth keeping, so never sampled
+    if (!enabled() || level < config_.level) {
+        return;
+    }
+    push(level, Kind::Event, [&](Entry& e) {
+        e.text_length = copy_truncated(e.text, kTextBytes, message);
+    });
+}
+
+void AsyncLogger::after_fork() {
+    if (!enabled()) {
+        return;
+    }
+    // Deliberately leaked, as the thread it names does not exist here
+    (void)new std::thread(std::move(thread_));
+    stopping_ = false;
+    sleeping_.store(false, std::memory_order_relaxed);
+    reset();
+    thread_ = std::thread([this] { run(); });
+}
+
+void AsyncLogger::run() {
+    // Upper bound on how long a record can wait if a wakeup is missed
+    constexpr auto kIdleWait = std::chrono::milliseconds(100);
+    
+    auto ready = [this] {
+        return slots_[dequeue_pos_ & mask_].sequence.load(std::memory_order_acquire) == dequeue_pos_ + 1;
+    };
+    for (;;) {
+        while (ready()) {
+            auto& slot = slots_[dequeue_pos_ & mask_];
+            deliver(slot.entry, dropped_.exchange(0, std::memory_order_relaxed));
+            slot.entry.error = nullptr;
+            slot.sequence.store(dequeue_pos_ + mask_ + 1, std::memory_order_release);
+            ++dequeue_pos_;
+        }
+        
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (stopping_) {
+            return;
+        }
+        sleeping_.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!ready()) {
+            cv_.wait_for(lock, kIdleWait);
+        }
+        sleeping_.store(false, std::memory_order_relaxed);
+    }
+}
+
+void AsyncLogger::deliver(const Entry& entry, uint64_t dropped) {
+    std::string_view url(entry.url, entry.url_length);
+    std::string_view text(entry.text, entry.text_length);
+    int status = entry.status;
+    char error[kTextBytes];
+    if (entry.error) {
+        text = std::string_view(error, describe_error(entry.error, error, sizeof(error), status));
+    }
+    std::string host = host_of(url);
+    const char* event = entry.kind == Kind::Send ? "send"
+                      : entry.kind == Kind::Event ? "client"
+                                                  : event_name(entry.level);
+    
+    auto time = std::chrono::system_clock::to_time_t(entry.time);
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(entry.time.time_since_epoch()).count() % 1000;
+    std::tm tm{};
+#ifdef _WIN32
+    gmtime_s(&tm, &time);
+#else
+    gmtime_r(&time, &tm);
+#endif
+    char stamp[32];
+    std::strftime(stamp, sizeof(stamp), "%Y-%m-%dT%H:%M:%S", &tm);
+    
+    std::string line;
+    line.reserve(160 + url.size() + text.size());
+    line += "ts=";
+    line += stamp;
+    line += '.' + std::to_string(1000 + ms).substr(1) + 'Z';
+    line += " level=";
+    line += to_string(entry.level);
+    line += " event=";
+    line += event;
+    if (entry.kind != Kind::Event) {
+        line += " host=";
+        append_value(line, host);
+        line += " url=";
+        append_value(line, url);
+        line += entry.priority == Priority::Interactive ? " priority=interactive" : " priority=batch";
+    }
+    if (entry.kind == Kind::Done) {
+        char numbers[96];
+        std::snprintf(numbers, sizeof(numbers), " status=%d latency_ms=%.1f bytes=%llu", status,
+                      entry.latency_ms, static_cast<unsigned long long>(entry.bytes));
+        line += numbers;
+        
+        // Phases that took any time
+        auto append_ms = [&](const char* name, std::chrono::microseconds value) {
+            if (value.count() > 0) {
+                std::snprintf(numbers, sizeof(numbers), " %s=%.1f", name, static_cast<double>(value.count()) / 1000);
+                line += numbers;
+            }
+        };
+        append_ms("proxy_connect_ms", entry.timings.proxy_connect);
+        append_ms("connect_ms", entry.timings.connect);
+        append_ms("tls_ms", entry.timings.tls_handshake);
+        append_ms("first_byte_ms", entry.timings.first_byte);
+        if (const auto& tcp = entry.timings.tcp) {
+            std::snprintf(numbers, sizeof(numbers), " rtt_ms=%.1f cwnd=%u retransmits=%u",
+                          static_cast<double>(tcp->rtt.count()) / 1000, tcp->congestion_window, tcp->retransmits);
+            line += numbers;
+        }
+    }
+    if (!text.empty()) {
+        line += entry.kind == Kind::Event ? " message=" : " error=";
+        append_value(line, text);
+    }
+    if (dropped > 0) {
+        line += " dropped=" + std::to_string(dropped);
+    }
+    
+    LogRecord record{entry.time, entry.level, event, url, host, entry.priority, status,
+                     entry.latency_ms, entry.timings, entry.bytes, text, dropped, line};
+    try {
+        config_.handler(record);
+    } catch (...) {
+        // A failing handler must not take the formatter down
+    }
+}
+
+} // namespace detail
+} // namespace pxshot
@@ -0,0 +1,122 @@
+// Pxshot C++ SDK - Asynchronous structured logging (internal)
+
+#ifndef PXSHOT_LOGGER_HPP
+#define PXSHOT_LOGGER_HPP
+
+#include "pxshot/pxshot.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <thread>
+
+namespace pxshot {
+namespace detail {
+
+/// Whether the event counted by `counter` is kept at `rate` (0 to 1).
+/// Kept events are evenly spaced rather than random: the n-th is kept
+/// when it carries the running total of rate * n past a whole number.
+[[nodiscard]] bool sample_evenly(std::atomic<uint64_t>& counter, double rate);
+
+/// Delivers LogRecords to a LogConfig::handler from a background thread.
+///
+/// Calling threads only decide whether to keep a record (level and
+/// sampling counters) and copy it, truncated, into a fixed-size slot of a
+/// preallocated ring; nothing is allocated or formatted on their side. The
+/// ring is a bounded multi-producer queue in the style of Vyukov's: each
+/// slot carries a sequence number, so producers claim slots with one CAS
+/// and never wait on each other or on the formatter. When the ring is
+/// full, records are dropped and counted.
+class AsyncLogger {
+public:
+    explicit AsyncLogger(LogConfig config);
+    ~AsyncLogger();
+    
+    AsyncLogger(const AsyncLogger&) = delete;
+    AsyncLogger& operator=(const AsyncLogger&) = delete;
+    
+    [[nodiscard]] bool enabled() const { return static_cast<bool>(config_.handler); }
+    
+    /// A request is about to be sent (Debug)
+    void request_started(const ScreenshotOptions& options, Priority priority);
+    
+    /// A request finished; `error` is null on success. Failures are logged
+    /// as Error and slow requests as Warning, both regardless of sampling.
+    void request_finished(const ScreenshotOptions& options, Priority priority, double latency_ms,
+                          uint64_t bytes, std::exception_ptr error, const RequestTimings& timings = {});
+    
+    /// A client event, as recorded in the flight recorder (not sampled)
+    void event(LogLevel level, std::string_view message);
+    
+    /// Discard records a forked child cannot finish delivering and start a
+    /// new formatter thread; the parent's thread does not exist there
+    void after_fork();
+    
+    void lock() { mutex_.lock(); }
+    void unlock() { mutex_.unlock(); }
+
+private:
+    static constexpr size_t kUrlBytes = 256;
+    static constexpr size_t kTextBytes = 192;
+    
+    enum class Kind : uint8_t { Send, Done, Event };
+    
+    struct Entry {
+        std::chrono::system_clock::time_point time;
+        LogLevel level;
+        Kind kind;
+        Priority priority;
+        int status;
+        double latency_ms;
+        RequestTimings timings;
+        uint64_t bytes;
+        uint16_t url_length;
+        uint16_t text_length;
+        char url[kUrlBytes];
+        char text[kTextBytes];      // Event message
+        std::exception_ptr error;   // Described by the formatter, which
+                                    // clears it after delivery
+    };
+    
+    struct Slot {
+        std::atomic<size_t> sequence;
+        Entry entry;
+    };
+    
+    LogConfig config_;
+    size_t mask_;
+    std::unique_ptr<Slot[]> slots_;
+    std::atomic<size_t> enqueue_pos_{0};
+    size_t dequeue_pos_ = 0;                    // Formatter thread only
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<uint64_t> sampled_[4] = {};     // Per-level sampling counters
+    
+    // Wakes the formatter; producers only notify when it is asleep
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::atomic<bool> sleeping_{false};
+    bool stopping_ = false;
+    std::thread thread_;
+    
+    /// Whether a record at `level` survives the level floor and sampling
+    [[nodiscard]] bool sample(LogLevel level);
+    
+    /// Claim a slot, fill it with `fill(Entry&)` and publish it
+    template <typename Fill>
+    void push(LogLevel level, Kind kind, Fill&& fill);
+    
+    void reset();
+    void run();
+    void deliver(const Entry& entry, uint64_t dropped);
+};
+
+} // namespace detail
+} // namespace pxshot
+
+#endif // PXSHOT_LOGGER_HPP
@@ -0,0 +1,262 @@
+// Pxshot C++ SDK - Columnar results manifest
+
+#include "pxshot/pxshot.hpp"
+#include "arrow_ipc.hpp"
+#include "request_json.hpp"
+
+#include <openssl/sha.h>
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+namespace pxshot {
+
+namespace {
+
+// Record batches are cut early when their strings grow this large, so
+// long URLs or options cannot make a batch unbounded
+constexpr size_t kMaxBatchBytes = 64 * 1024 * 1024;
+
+enum Column { kUrl, kOptions, kCapturedAt, kStatus, kError, kLatency, kSize, kHash, kWidth, kHeight };
+
+std::vector<detail::ArrowField> manifest_schema() {
+    using detail::ArrowType;
+    return {
+        {"url", ArrowType::Utf8},
+        {"options", ArrowType::Utf8},
+        {"captured_at", ArrowType::TimestampMs},
+        {"status", ArrowType::Int32},
+        {"error", ArrowType::Utf8, true},
+        {"latency_ms", ArrowType::Float64},
+        {"size_bytes", ArrowType::Int64, true},
+        {"content_hash", ArrowType::FixedBinary, true, 32},
+        {"width", ArrowType::Int32, true},
+        {"height", ArrowType::Int32, true},
+    };
+}
+
+uint32_t big_endian(const uint8_t* p, int bytes) {
+    uint32_t value = 0;
+    for (int i = 0; i < bytes; ++i) {
+        value = value << 8 | p[i];
+    }
+    return value;
+}
+
+uint32_t little_endian(const uint8_t* p, int bytes) {
+    uint32_t value = 0;
+    for (int i = bytes - 1; i >= 0; --i) {
+        value = value << 8 | p[i];
+    }
+    return value;
+}
+
+/// Width and height from a PNG, JPEG or WebP header
+std::optional<std::pair<int, int>> image_dimensions(const std::vector<uint8_t>& image) {
+    const uint8_t* p = image.data();
+    size_t size = image.size();
+    auto starts_with = [&](size_t offset, std::string_view text) {
+        return size >= offset + text.size() && std::memcmp(p + offset, text.data(), text.size()) == 0;
+    };
+    auto pair = [](uint32_t width, uint32_t height) {
+        return std::make_pair(static_cast<int>(width), static_cast<int>(height));
+    };
+    
+    if (starts_with(0, "\x89PNG\r\n\x1a\n") && starts_with(12, "IHDR") && size >= 24) {
+        return pair(big_endian(p + 16, 4), big_endian(p + 20, 4));
+    }
+    
+    if (size >= 4 && p[0] == 0xFF && p[1] == 0xD8) {
+        // Walk the segments to the first start-of-frame
+        size_t i = 2;
+        while (i + 9 <= size && p[i] == 0xFF) {
+            uint8_t marker = p[i + 1];
+            if (marker == 0xFF) {
+                ++i;        // Fill byte
+                continue;
+            }
+            bool frame = marker >= 0xC0 && marker <= 0xCF && marker != 0xC4 && marker != 0xC8 && marker != 0xCC;
+            if (frame) {
+                return pair(big_endian(p + i + 7, 2), big_endian(p + i + 5, 2));
+            }
+            if (marker == 0xD9 || marker == 0xDA) {
+                break;      // End of image or start of scan, with no frame seen
+            }
+            if (marker == 0x01 || (marker >= 0xD0 && marker <= 0xD8)) {
+                i += 2;
+                continue;
+            }
+            i += 2 + big_endian(p + i + 2, 2);
+        }
+        return std::nullopt;
+    }
+    
+    if (starts_with(0, "RIFF") && starts_with(8, "WEBP") && size >= 30) {
+        if (starts_with(12, "VP8 ")) {
+            return pair(little_endian(p + 26, 2) & 0x3FFF, little_endian(p + 28, 2) & 0x3FFF);
+        }
+        if (starts_with(12, "VP8L")) {
+            uint32_t bits = little_endian(p + 21, 4);
+            return pair((bits & 0x3FFF) + 1, (bits >> 14 & 0x3FFF) + 1);
+        }
+        if (starts_with(12, "VP8X")) {
+            return pair(little_endian(p + 24, 3) + 1, little_endian(p + 27, 3) + 1);
+        }
+    }
+    return std::nullopt;
+}
+
+/// Row for `options`, captured now
+ManifestRow row_for(const ScreenshotOptions& options) {
+    ManifestRow row;
+    row.url = options.url;
+    row.options = detail::to_request_body(options).dump();
+    row.captured_at = std::chrono::system_clock::now();
+    return row;
+}
+
+} // namespace
+
+struct ManifestWriter::Impl {
+    detail::ArrowFileWriter file;
+    std::vector<detail::ArrowColumn> columns;
+    size_t rows_per_batch;
+    uint64_t rows = 0;
+    
+    Impl(const std::string& path, size_t batch_rows)
+        : file(path, manifest_schema()), rows_per_batch(std::max<size_t>(1, batch_rows)) {
+        for (auto& field : manifest_schema()) {
+            columns.emplace_back(std::move(field));
+        }
+    }
+    
+    void flush() {
+        if (!file.is_open()) {
+            throw Error("Manifest is closed");
+        }
+        if (columns.front().length() == 0) {
+            return;
+        }
+        file.write_batch(columns);
+        for (auto& column : columns) {
+            column.clear();
+        }
+    }
+    
+    void append(const ManifestRow& row) {
+        if (!file.is_open()) {
+            throw Error("Manifest is closed");
+        }
+        auto optional_int = [](detail::ArrowColumn& column, const auto& value) {
+            if (value) {
+                column.append(static_cast<int64_t>(*value));
+            } else {
+                column.append_null();
+            }
+        };
+        
+        columns[kUrl].append(std::string_view(row.url));
+        columns[kOptions].append(std::string_view(row.options));
+        columns[kCapturedAt].append(static_cast<int64_t>(
+            std::chrono::duration_cast<std::chrono::milliseconds>(row.captured_at.time_since_epoch()).count()));
+        columns[kStatus].append(static_cast<int64_t>(row.status));
+        if (row.error.empty()) {
+            columns[kError].append_null();
+        } else {
+            columns[kError].append(std::string_view(row.error));
+        }
+        columns[kLatency].append(row.latency_ms);
+        optional_int(columns[kSize], row.size_bytes);
+        if (row.content_hash) {
+            columns[kHash].append(std::string_view(reinterpret_cast<const char*>(row.content_hash->data()),
+                                                   row.content_hash->size()));
+        } else {
+            columns[kHash].append_null();
+        }
+        optional_int(columns[kWidth], row.width);
+        optional_int(columns[kHeight], row.height);
+        ++rows;
+        
+        size_t bytes = columns[kUrl].bytes() + columns[kOptions].bytes() + columns[kError].bytes();
+        if (static_cast<size_t>(columns.front().length()) >= rows_per_batch || bytes >= kMaxBatchBytes) {
+            flush();
+        }
+    }
+};
+
+ManifestWriter::ManifestWriter(const std::string& path, size_t rows_per_batch)
+    : impl_(std::make_unique<Impl>(path, rows_per_batch)) {}
+
+ManifestWriter::~ManifestWriter() {
+    if (impl_) {
+        try {
+            close();
+        } catch (...) {
+            // Destructors must not throw; close() explicitly to see errors
+        }
+    }
+}
+
+ManifestWriter::ManifestWriter(ManifestWriter&&) noexcept = default;
+
+ManifestWriter& ManifestWriter::operator=(ManifestWriter&& other) noexcept {
+    if (this != &other) {
+        ManifestWriter closing(std::move(*this));
+        impl_ = std::move(other.impl_);
+    }
+    return *this;
+}
+
+void ManifestWriter::append(const ManifestRow& row) {
+    impl_->append(row);
+}
+
+void ManifestWriter::append(const ScreenshotOptions& options, const ScreenshotResult& result) {
+    auto row = row_for(options);
+    row.status = 200;
+    row.latency_ms = std::chrono::duration<double, std::milli>(result.timings().total).count();
+    if (result.is_stored()) {
+        const auto& stored = result.stored();
+        row.size_bytes = stored.size_bytes;
+        row.width = stored.width;
+        row.height = stored.height;
+    } else {
+        const auto& bytes = result.bytes();
+        row.size_bytes = static_cast<int64_t>(bytes.size());
+        row.content_hash.emplace();
+        SHA256(bytes.data(), bytes.size(), row.content_hash->data());
+        if (auto dimensions = image_dimensions(bytes)) {
+            row.width = dimensions->first;
+            row.height = dimensions->second;
+        }
+    }
+    impl_->append(row);
+}
+
+void ManifestWriter::append(const ScreenshotOptions& options, const std::exception& error) {
+    auto row = row_for(options);
+    if (const auto* http = dynamic_cast<const HttpError*>(&error)) {
+        row.status = http->status_code;
+    }
+    row.error = error.what();
+    impl_->append(row);
+}
+
+void ManifestWriter::flush() {
+    impl_->flush();
+}
+
+void ManifestWriter::close() {
+    if (impl_->file.is_open()) {
+        impl_->flush();
+        impl_->file.close();
+    }
+}
+
+uint64_t ManifestWriter::rows() const noexcept {
+    return impl_->rows;
+}
+
+} // namespace pxshot
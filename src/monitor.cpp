@@ -0,0 +1,290 @@
+// Pxshot C++ SDK - Page monitoring
+
+#include "pxshot/pxshot.hpp"
+#include "recapture.hpp"
+#include "request_json.hpp"
+#include "sigv4.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <set>
+#include <thread>
+
+namespace pxshot {
+
+namespace {
+
+using Clock = std::chrono::system_clock;
+
+// Futures have no completion callback, so captures in flight are polled
+constexpr auto kPollInterval = std::chrono::milliseconds(100);
+
+std::string page_key(const ScreenshotOptions& options) {
+    return detail::to_request_body(options).dump();
+}
+
+} // namespace
+
+struct Monitor::Impl {
+    struct Page {
+        MonitoredPage state;
+        std::future<ScreenshotResult> pending;
+        uint64_t generation = 0;                // Tells a replaced page's captures apart
+    };
+    
+    /// A capture taken off its page to be resolved outside the lock
+    struct Completed {
+        std::string key;
+        uint64_t generation;
+        ScreenshotOptions options;
+        std::future<ScreenshotResult> future;
+        std::optional<ScreenshotResult> result{};
+        std::exception_ptr error{};
+        std::string hash{};                     // Empty = not compared (blank)
+        bool changed = false;
+        std::chrono::seconds next_interval{0};
+        bool reported = false;
+    };
+    
+    Client& client;
+    MonitorConfig config;
+    
+    mutable std::mutex mutex;
+    std::condition_variable wake;
+    bool stopping = false;
+    uint64_t generations = 0;
+    std::map<std::string, Page> pages;
+    std::set<std::pair<Clock::time_point, std::string>> schedule;  // Pages not in flight
+    std::thread thread;
+    
+    Impl(Client& c, MonitorConfig cfg) : client(c), config(std::move(cfg)) {
+        detail::validate(config);
+    }
+    
+    void add(MonitoredPage state) {
+        if (state.options.store.value_or(false) && !config.fingerprint) {
+            throw ValidationError("stored captures cannot be monitored without a fingerprint");
+        }
+        if (state.interval.count() <= 0) {
+            state.interval = config.interval;
+        }
+        auto key = page_key(state.options);
+        
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = pages.find(key);
+        if (it != pages.end()) {
+            schedule.erase({it->second.state.next_capture, key});
+        } else {
+            it = pages.emplace(key, Page{}).first;
+        }
+        schedule.emplace(state.next_capture, key);
+        it->second = Page{std::move(state), {}, ++generations};
+        wake.notify_one();
+    }
+    
+    bool remove(const ScreenshotOptions& options) {
+        auto key = page_key(options);
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = pages.find(key);
+        if (it == pages.end()) {
+            return false;
+        }
+        schedule.erase({it->second.state.next_capture, key});
+        pages.erase(it);
+        return true;
+    }
+    
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_one();
+        thread.join();
+    }
+    
+    void run() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (!stopping) {
+            auto done = collect();
+            lock.unlock();
+            for (auto& capture : done) {
+                resolve(capture);
+            }
+            lock.lock();
+            
+            auto now = Clock::now();
+            for (auto& capture : done) {
+                apply(capture, now);
+            }
+            submit_due(done, now);
+            
+            lock.unlock();
+            if (config.on_capture) {
+                for (const auto& capture : done) {
+                    if (capture.reported) {
+                        report(capture);
+                    }
+                }
+            }
+            lock.lock();
+            
+            if (stopping || !done.empty()) {
+                continue;
+            }
+            bool in_flight = false;
+            for (const auto& [key, page] : pages) {
+                in_flight |= page.pending.valid();
+            }
+            if (in_flight) {
+                wake.wait_for(lock, kPollInterval);
+            } else if (!schedule.empty()) {
+                wake.wait_until(lock, schedule.begin()->first);
+            } else {
+                wake.wait(lock);
+            }
+        }
+    }
+    
+    /// Take the finished captures off their pages
+    std::vector<Completed> collect() {
+        std::vector<Completed> done;
+        for (auto& [key, page] : pages) {
+            if (page.pending.valid() &&
+                page.pending.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+                done.push_back({key, page.generation, page.state.options, std::move(page.pending)});
+            }
+        }
+        return done;
+    }
+    
+    /// Get the capture's result and hash it
+    void resolve(Completed& capture) const {
+        try {
+            capture.result.emplace(capture.future.get());
+            if (capture.result->blank().verdict == BlankVerdict::Blank) {
+                return;
+            }
+            if (config.fingerprint) {
+                capture.hash = config.fingerprint(*capture.result);
+            } else {
+                const auto& bytes = capture.result->bytes();
+                capture.hash = detail::sha256_hex(
+                    std::string_view(reinterpret_cast<const char*>(bytes.data()), bytes.size()));
+            }
+        } catch (...) {
+            capture.result.reset();
+            capture.error = std::current_exception();
+        }
+    }
+    
+    /// Record a resolved capture in its page's state and schedule the next
+    void apply(Completed& capture, Clock::time_point now) {
+        auto it = pages.find(capture.key);
+        if (it == pages.end() || it->second.generation != capture.generation) {
+            return;  // Removed or replaced while in flight
+        }
+        auto& state = it->second.state;
+        ++state.captures;
+        
+        if (capture.error) {
+            ++state.failures;
+        } else if (!capture.hash.empty()) {
+            if (!state.content_hash.empty()) {
+                auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(now - state.last_capture);
+                capture.changed = capture.hash != state.content_hash;
+                state.history.push_back({std::max(elapsed, std::chrono::seconds(1)), capture.changed});
+                if (state.history.size() > config.history) {
+                    state.history.erase(state.history.begin(),
+                                        state.history.end() - static_cast<std::ptrdiff_t>(config.history));
+                }
+                state.changes += capture.changed;
+            }
+            state.content_hash = std::move(capture.hash);
+            state.last_capture = now;
+            
+            // A first capture has nothing to compare with, so says nothing
+            // about the rate yet
+            if (!state.history.empty()) {
+                double rate = detail::change_rate(state.history);
+                state.change_rate = rate * 3600;
+                state.interval = detail::next_interval(config, state.interval, rate);
+            }
+        }
+        
+        state.next_capture = now + state.interval;
+        schedule.emplace(state.next_capture, capture.key);
+        capture.next_interval = state.interval;
+        capture.reported = true;
+    }
+    
+    /// Send the pages that are due; pages the client refuses count as
+    /// failed captures, added to `done` to be reported
+    void submit_due(std::vector<Completed>& done, Clock::time_point now) {
+        while (!schedule.empty() && schedule.begin()->first <= now) {
+            auto key = schedule.begin()->second;
+            schedule.erase(schedule.begin());
+            auto& page = pages.at(key);
+            try {
+                page.pending = client.submit(page.state.options, config.priority);
+            } catch (...) {
+                Completed failed{key, page.generation, page.state.options, {}};
+                failed.error = std::current_exception();
+                apply(failed, now);
+                done.push_back(std::move(failed));
+            }
+        }
+    }
+    
+    void report(const Completed& capture) const {
+        MonitorCapture event{capture.options, capture.result ? &*capture.result : nullptr, capture.error,
+                             capture.changed, capture.next_interval};
+        try {
+            config.on_capture(event);
+        } catch (...) {
+            // A failing handler must not stop the monitor
+        }
+    }
+};
+
+Monitor::Monitor(Client& client, MonitorConfig config)
+    : impl_(std::make_unique<Impl>(client, std::move(config))) {
+    impl_->thread = std::thread([impl = impl_.get()] { impl->run(); });
+}
+
+Monitor::~Monitor() {
+    impl_->stop();
+}
+
+void Monitor::add(ScreenshotOptions options) {
+    MonitoredPage page;
+    page.options = std::move(options);
+    impl_->add(std::move(page));
+}
+
+void Monitor::add(MonitoredPage page) {
+    impl_->add(std::move(page));
+}
+
+bool Monitor::remove(const ScreenshotOptions& options) {
+    return impl_->remove(options);
+}
+
+std::vector<MonitoredPage> Monitor::status() const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    std::vector<MonitoredPage> pages;
+    pages.reserve(impl_->pages.size());
+    for (const auto& [key, page] : impl_->pages) {
+        pages.push_back(page.state);
+    }
+    std::sort(pages.begin(), pages.end(), [](const MonitoredPage& a, const MonitoredPage& b) {
+        return a.next_capture < b.next_capture;
+    });
+    return pages;
+}
+
+} // namespace pxshot
@@ -0,0 +1,444 @@
+// Pxshot C++ SDK - Request preflight checks
+
+#include "preflight.hpp"
+#include "cost_model.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <limits>
+
+namespace pxshot {
+namespace detail {
+
+namespace {
+
+constexpr int kDefaultWidth = 1280;
+constexpr int kDefaultHeight = 720;
+constexpr double kFullPageViewports = 4;
+constexpr double kMaxScaleFactor = 4;
+constexpr double kScaleFactorLimit = 16;
+constexpr int kMaxDimension = 16384;
+
+bool is_alpha(char c) { return std::isalpha(static_cast<unsigned char>(c)) != 0; }
+bool is_digit(char c) { return std::isdigit(static_cast<unsigned char>(c)) != 0; }
+bool is_space(char c) { return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f'; }
+
+bool iequals(std::string_view a, std::string_view b) {
+    return a.size() == b.size() &&
+           std::equal(a.begin(), a.end(), b.begin(), [](char x, char y) {
+               return std::tolower(static_cast<unsigned char>(x)) ==
+                      std::tolower(static_cast<unsigned char>(y));
+           });
+}
+
+bool is_private_host(std::string_view host) {
+    if (iequals(host, "localhost") || host == "[::1]" || host == "0.0.0.0") {
+        return true;
+    }
+    auto starts = [&](std::string_view prefix) { return host.substr(0, prefix.size()) == prefix; };
+    if (starts("127.") || starts("10.") || starts("192.168.") || starts("169.254.")) {
+        return true;
+    }
+    if (starts("172.")) {
+        int second = std::atoi(std::string(host.substr(4, 3)).c_str());
+        return second >= 16 && second <= 31;
+    }
+    return false;
+}
+
+/// Recursive-descent checker for the subset of Selectors Level 4 that
+/// browsers accept in querySelector(). Pseudo-class arguments are only
+/// checked for balance since their grammar depends on the pseudo-class.
+class SelectorChecker {
+public:
+    explicit SelectorChecker(std::string_view s) : s_(s) {}
+    
+    std::optional<std::string> run() {
+        skip_space();
+        if (at_end()) {
+            return fail("selector is empty");
+        }
+        for (;;) {
+            if (auto err = complex()) {
+                return err;
+            }
+            skip_space();
+            if (at_end()) {
+                return std::nullopt;
+            }
+            if (peek() != ',') {
+                return fail(std::string("unexpected '") + peek() + "'");
+            }
+            ++pos_;
+            skip_space();
+            if (at_end() || peek() == ',') {
+                return fail("empty selector in list");
+            }
+        }
+    }
+
+private:
+    std::string_view s_;
+    size_t pos_ = 0;
+    
+    bool at_end() const { return pos_ >= s_.size(); }
+    char peek(size_t ahead = 0) const { return pos_ + ahead < s_.size() ? s_[pos_ + ahead] : '\0'; }
+    
+    void skip_space() {
+        while (!at_end() && is_space(peek())) {
+            ++pos_;
+        }
+    }
+    
+    std::optional<std::string> fail(const std::string& what) const {
+        return what + " at offset " + std::to_string(pos_);
+    }
+    
+    bool ident_start(char c) const {
+        return is_alpha(c) || c == '_' || c == '\\' || static_cast<unsigned char>(c) >= 0x80;
+    }
+    
+    bool ident() {
+        size_t start = pos_;
+        if (peek() == '-') {
+            ++pos_;
+        }
+        if (peek() == '-') {
+            ++pos_;
+        } else if (!ident_start(peek())) {
+            pos_ = start;
+            return false;
+        }
+        while (!at_end()) {
+            char c = peek();
+            if (c == '\\') {
+                pos_ = std::min(pos_ + 2, s_.size());
+            } else if (ident_start(c) || is_digit(c) || c == '-') {
+                ++pos_;
+            } else {
+                break;
+            }
+        }
+        return true;
+    }
+    
+    bool string_literal() {
+        char quote = peek();
+        ++pos_;
+        while (!at_end() && peek() != quote) {
+            pos_ += peek() == '\\' ? 2 : 1;
+        }
+        pos_ = std::min(pos_, s_.size());
+        if (at_end()) {
+            return false;
+        }
+        ++pos_;
+        return true;
+    }
+    
+    std::optional<std::string> complex() {
+        if (auto err = compound()) {
+            return err;
+        }
+        for (;;) {
+            size_t before = pos_;
+            skip_space();
+            if (at_end() || peek() == ',' || peek() == ')') {
+                return std::nullopt;
+            }
+            char c = peek();
+            if (c == '>' || c == '+' || c == '~') {
+                ++pos_;
+                skip_space();
+                if (at_end() || peek() == ',') {
+                    return fail(std::string("dangling combinator '") + c + "'");
+                }
+            } else if (pos_ == before) {
+                return fail(std::string("unexpected '") + c + "'");
+            }
+            if (auto err = compound()) {
+                return err;
+            }
+        }
+    }
+    
+    std::optional<std::string> compound() {
+        size_t start = pos_;
+        if (peek() == '*') {
+            ++pos_;
+        } else {
+            ident();
+        }
+        for (;;) {
+            char c = peek();
+            if (c == '#' || c == '.') {
+                ++pos_;
+                if (!ident()) {
+                    return fail(std::string("expected a name after '") + c + "'");
+                }
+            } else if (c == '[') {
+                if (auto err = attribute()) {
+                    return err;
+                }
+            } else if (c == ':') {
+                if (auto err = pseudo()) {
+                    return err;
+                }
+            } else {
+                break;
+            }
+        }
+        if (pos_ == start) {
+            return at_end() ? fail("expected a selector") : fail(std::string("unexpected '") + peek() + "'");
+        }
+        return std::nullopt;
+    }
+    
+    std::optional<std::string> attribute() {
+        ++pos_;  // '['
+        skip_space();
+        if (!ident()) {
+            return fail("expected an attribute name");
+        }
+        skip_space();
+        if (peek() == ']') {
+            ++pos_;
+            return std::nullopt;
+        }
+        if (peek() != '=') {
+            if (std::string_view("~|^$*").find(peek()) == std::string_view::npos || peek(1) != '=') {
+                return fail("expected an attribute operator");
+            }
+            ++pos_;
+        }
+        ++pos_;
+        skip_space();
+        if (peek() == '"' || peek() == '\'') {
+            if (!string_literal()) {
+                return fail("unterminated string");
+            }
+        } else if (!ident()) {
+            // Unquoted values must be identifiers (e.g. [data-id=1] is invalid)
+            return fail("attribute value must be quoted");
+        }
+        skip_space();
+        if (peek() == 'i' || peek() == 'I' || peek() == 's' || peek() == 'S') {
+            ++pos_;
+            skip_space();
+        }
+        if (peek() != ']') {
+            return fail("expected ']'");
+        }
+        ++pos_;
+        return std::nullopt;
+    }
+    
+    std::optional<std::string> pseudo() {
+        ++pos_;  // ':'
+        if (peek() == ':') {
+            ++pos_;
+        }
+        if (!ident()) {
+            return fail("expected a pseudo-class name");
+        }
+        if (peek() != '(') {
+            return std::nullopt;
+        }
+        ++pos_;
+        int depth = 1;
+        while (!at_end() && depth > 0) {
+            char c = peek();
+            if (c == '"' || c == '\'') {
+                if (!string_literal()) {
+                    return fail("unterminated string");
+                }
+                continue;
+            }
+            if (c == '(') {
+                ++depth;
+            } else if (c == ')') {
+                --depth;
+            } else if (c == '\\') {
+                ++pos_;
+            }
+            ++pos_;
+        }
+        if (depth > 0) {
+            return fail("unbalanced '('");
+        }
+        return std::nullopt;
+    }
+};
+
+} // namespace
+
+double estimate_pixels(const ScreenshotOptions& options) {
+    double scale = options.device_scale_factor.value_or(1.0);
+    double pixels = static_cast<double>(options.width.value_or(kDefaultWidth)) *
+                    options.height.value_or(kDefaultHeight) * scale * scale;
+    if (options.full_page.value_or(false)) {
+        pixels *= kFullPageViewports;
+    }
+    return pixels;
+}
+
+int64_t saturate_estimate(double estimate) {
+    constexpr auto kMax = std::numeric_limits<int64_t>::max();
+    if (!(estimate > 0)) {
+        return 0;
+    }
+    return estimate >= static_cast<double>(kMax) ? kMax : static_cast<int64_t>(estimate);
+}
+
+std::optional<std::string> check_url(std::string_view url) {
+    auto scheme_end = url.find("://");
+    if (scheme_end == std::string_view::npos) {
+        return std::string("URL must be absolute (http:// or https://)");
+    }
+    auto scheme = url.substr(0, scheme_end);
+    if (!iequals(scheme, "http") && !iequals(scheme, "https")) {
+        return "Unsupported URL scheme '" + std::string(scheme) + "'";
+    }
+    for (char c : url) {
+        if (static_cast<unsigned char>(c) <= 0x20 || c == 0x7f) {
+            return std::string("URL contains whitespace or control characters");
+        }
+    }
+    
+    auto rest = url.substr(scheme_end + 3);
+    auto authority = rest.substr(0, rest.find_first_of("/?#"));
+    if (auto at = authority.rfind('@'); at != std::string_view::npos) {
+        authority = authority.substr(at + 1);
+    }
+    
+    std::string_view host = authority;
+    std::string_view port;
+    if (!authority.empty() && authority.front() == '[') {
+        auto close = authority.find(']');
+        if (close == std::string_view::npos) {
+            return std::string("Unterminated IPv6 address in URL");
+        }
+        host = authority.substr(0, close + 1);
+        auto after = authority.substr(close + 1);
+        if (!after.empty()) {
+            if (after.front() != ':') {
+                return std::string("Malformed URL authority");
+            }
+            port = after.substr(1);
+        }
+    } else if (auto colon = authority.find(':'); colon != std::string_view::npos) {
+        host = authority.substr(0, colon);
+        port = authority.substr(colon + 1);
+    }
+    
+    if (host.empty()) {
+        return std::string("URL has no host");
+    }
+    if (host.front() != '[') {
+        if (host.front() == '.' || host.front() == '-' || host.find("..") != std::string_view::npos) {
+            return "Malformed host '" + std::string(host) + "'";
+        }
+        for (char c : host) {
+            if (!is_alpha(c) && !is_digit(c) && c != '-' && c != '.' && c != '_' &&
+                static_cast<unsigned char>(c) < 0x80) {
+                return "Invalid character in host '" + std::string(host) + "'";
+            }
+        }
+    }
+    if (!port.empty()) {
+        if (port.size() > 5 || !std::all_of(port.begin(), port.end(), is_digit) ||
+            std::stoi(std::string(port)) == 0 || std::stoi(std::string(port)) > 65535) {
+            return "Invalid port '" + std::string(port) + "'";
+        }
+    }
+    return std::nullopt;
+}
+
+std::optional<std::string> check_selector(std::string_view selector) {
+    return SelectorChecker(selector).run();
+}
+
+PreflightReport preflight(const ScreenshotOptions& options,
+                          const ClientConfig& config,
+                          const CostModel& cost) {
+    PreflightReport report{};
+    auto error = [&](std::string message) { report.errors.push_back(std::move(message)); };
+    auto warn = [&](std::string message) { report.warnings.push_back(std::move(message)); };
+    
+    if (options.url.empty()) {
+        error("URL is required");
+    } else if (auto problem = check_url(options.url)) {
+        error(*problem);
+    } else if (is_private_host(host_of(options.url))) {
+        warn("URL points at a private or loopback host the renderer cannot reach");
+    }
+    
+    if (options.quality && (*options.quality < 0 || *options.quality > 100)) {
+        error("Quality must be between 0 and 100");
+    }
+    if (options.quality && options.format.value_or(Format::PNG) == Format::PNG) {
+        warn("Quality is ignored for PNG output");
+    }
+    
+    if (options.width && *options.width <= 0) {
+        error("Width must be positive");
+    } else if (options.width && *options.width > kMaxDimension) {
+        warn("Width is larger than " + std::to_string(kMaxDimension) + " pixels");
+    }
+    
+    if (options.height && *options.height <= 0) {
+        error("Height must be positive");
+    } else if (options.height && *options.height > kMaxDimension) {
+        warn("Height is larger than " + std::to_string(kMaxDimension) + " pixels");
+    }
+    
+    if (options.device_scale_factor) {
+        double scale = *options.device_scale_factor;
+        if (!std::isfinite(scale) || scale <= 0) {
+            error("Device scale factor must be positive");
+        } else if (scale > kScaleFactorLimit) {
+            error("Device scale factor must not exceed " + std::to_string(static_cast<int>(kScaleFactorLimit)));
+        } else if (scale > kMaxScaleFactor) {
+            warn("Device scale factor above " + std::to_string(static_cast<int>(kMaxScaleFactor)) +
+                 " multiplies output size by " + std::to_string(static_cast<int>(scale * scale)));
+        }
+    }
+    
+    if (options.wait_for_timeout) {
+        if (*options.wait_for_timeout < 0) {
+            error("Wait timeout must not be negative");
+        } else if (*options.wait_for_timeout >= config.timeout_seconds * 1000) {
+            error("Wait timeout exceeds the client timeout; the request would time out");
+        }
+    }
+    
+    if (options.wait_for_selector) {
+        if (auto problem = check_selector(*options.wait_for_selector)) {
+            error("Invalid wait_for_selector: " + *problem);
+        }
+    }
+    
+    double pixels = estimate_pixels(options);
+    report.estimated_pixels = saturate_estimate(pixels);
+    report.estimated_bytes = saturate_estimate(cost.estimate(options).bytes);
+    
+    if (config.max_output_pixels > 0 && pixels > static_cast<double>(config.max_output_pixels)) {
+        error("Estimated output of " + std::to_string(report.estimated_pixels) +
+              " pixels exceeds the limit of " + std::to_string(config.max_output_pixels));
+    } else if (config.max_output_pixels > 0 && pixels * 2 > static_cast<double>(config.max_output_pixels)) {
+        warn("Estimated output of " + std::to_string(report.estimated_pixels) +
+             " pixels is close to the limit");
+    }
+    
+    if (config.strict_preflight) {
+        for (auto& warning : report.warnings) {
+            report.errors.push_back(std::move(warning));
+        }
+        report.warnings.clear();
+    }
+    return report;
+}
+
+} // namespace detail
+} // namespace pxshot
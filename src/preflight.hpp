@@ -0,0 +1,39 @@
+// Pxshot C++ SDK - Request preflight checks (internal)
+
+#ifndef PXSHOT_PREFLIGHT_HPP
+#define PXSHOT_PREFLIGHT_HPP
+
+#include "pxshot/pxshot.hpp"
+
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace pxshot {
+namespace detail {
+
+class CostModel;
+
+/// Pixels the capture will produce: viewport x scale², with full-page
+/// captures assumed to be several viewports tall
+[[nodiscard]] double estimate_pixels(const ScreenshotOptions& options);
+
+/// Round an estimate down to int64_t, saturating: estimates grow with the
+/// square of the scale factor and can leave its range, or be NaN (as 0)
+[[nodiscard]] int64_t saturate_estimate(double estimate);
+
+/// Describe what is wrong with an absolute http(s) URL, if anything
+[[nodiscard]] std::optional<std::string> check_url(std::string_view url);
+
+/// Describe what is wrong with a CSS selector list, if anything
+[[nodiscard]] std::optional<std::string> check_selector(std::string_view selector);
+
+/// Run every local check and estimate the output size
+[[nodiscard]] PreflightReport preflight(const ScreenshotOptions& options,
+                                        const ClientConfig& config,
+                                        const CostModel& cost);
+
+} // namespace detail
+} // namespace pxshot
+
+#endif // PXSHOT_PREFLIGHT_HPP
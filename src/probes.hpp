@@ -0,0 +1,37 @@
+// Pxshot C++ SDK - USDT static tracepoints (internal)
+//
+// PXSHOT_PROBE(name, args...) marks a point that perf, bpftrace or
+// SystemTap can attach to in a running process, under the provider
+// "pxshot". With <sys/sdt.h> each probe compiles to a single nop plus a
+// note in the ELF .note.stapsdt section; a tracer patches the nop when it
+// attaches. Without the header, or when built with PXSHOT_ENABLE_PROBES
+// off, probes expand to nothing.
+//
+// Arguments are evaluated even when no tracer is attached, so pass only
+// values already at hand: integers, and pointers to existing strings.
+
+#ifndef PXSHOT_PROBES_HPP
+#define PXSHOT_PROBES_HPP
+
+#if !defined(PXSHOT_NO_PROBES) && defined(__has_include)
+#if __has_include(<sys/sdt.h>)
+#include <sys/sdt.h>
+#define PXSHOT_HAVE_PROBES 1
+#endif
+#endif
+
+#ifdef PXSHOT_HAVE_PROBES
+
+// Pick DTRACE_PROBEn by argument count (0 to 4)
+#define PXSHOT_PROBE_PICK(_0, _1, _2, _3, _4, macro, ...) macro
+#define PXSHOT_PROBE(...)                                                       \
+    PXSHOT_PROBE_PICK(__VA_ARGS__, DTRACE_PROBE4, DTRACE_PROBE3, DTRACE_PROBE2, \
+                      DTRACE_PROBE1, DTRACE_PROBE, unused)(pxshot, __VA_ARGS__)
+
+#else
+
+#define PXSHOT_PROBE(...) static_cast<void>(0)
+
+#endif
+
+#endif // PXSHOT_PROBES_HPP
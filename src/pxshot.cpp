@@ -1,38 +1,432 @@
 // Pxshot C++ SDK - Implementation
 
 #include "pxshot/pxshot.hpp"
+#include "bandwidth.hpp"
+#include "blank_detection.hpp"
+#include "buffer_pool.hpp"
+#include "cost_model.hpp"
+#include "degradation.hpp"
+#include "flight_recorder.hpp"
+#include "fork_support.hpp"
+#include "host_report.hpp"
+#include "logger.hpp"
+#include "preflight.hpp"
+#include "probes.hpp"
+#include "raw_connection.hpp"
+#include "request_json.hpp"
+#include "result_cache.hpp"
+#include "tcp_info.hpp"
 
 #define CPPHTTPLIB_OPENSSL_SUPPORT
 #include <httplib.h>
 #include <nlohmann/json.hpp>
+#include <openssl/ssl.h>
 
 #include <sstream>
 #include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <unordered_map>
+
+#ifndef _WIN32
+#include <pthread.h>
+#endif
+#ifdef __linux__
+#include <sched.h>
+#endif
 
 namespace pxshot {
 
 using json = nlohmann::json;
 
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int kHandoverVersion = 1;
+
+/// Connection setup seen on the calling thread during one request.
+/// cpp-httplib opens connections inside send(), on the sending thread, so
+/// its socket hook and the TLS handshake callback mark the phases here.
+struct ConnectPhases {
+    Clock::time_point opened;           // Socket created, connect starting
+    Clock::time_point tls_started;
+    Clock::time_point tls_done;
+};
+
+thread_local ConnectPhases connect_phases;
+
+std::chrono::microseconds micros(Clock::duration d) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(d);
+}
+
+void on_tls_info([[maybe_unused]] const SSL* ssl, int where, int) {
+    if (where & SSL_CB_HANDSHAKE_START) {
+        connect_phases.tls_started = Clock::now();
+    } else if (where & SSL_CB_HANDSHAKE_DONE) {
+        connect_phases.tls_done = Clock::now();
+        PXSHOT_PROBE(tls_done, SSL_get_fd(ssl),
+                     static_cast<long long>(micros(connect_phases.tls_done - connect_phases.tls_started).count()));
+    }
+}
+
+json handover_entry(const ScreenshotOptions& options, Priority priority) {
+    return json{
+        {"priority", priority == Priority::Interactive ? "interactive" : "batch"},
+        {"request", detail::to_request_body(options)}
+    };
+}
+
+std::vector<std::pair<ScreenshotOptions, Priority>> parse_handover(std::string_view text) {
+    std::vector<std::pair<ScreenshotOptions, Priority>> entries;
+    try {
+        auto doc = json::parse(text);
+        if (doc.at("version").get<int>() != kHandoverVersion) {
+            throw ValidationError("Unsupported handover version");
+        }
+        for (const auto& entry : doc.at("requests")) {
+            auto priority = entry.at("priority").get<std::string>() == "batch" ? Priority::Batch
+                                                                               : Priority::Interactive;
+            entries.emplace_back(detail::from_request_body(entry.at("request")), priority);
+        }
+    } catch (const json::exception& e) {
+        throw ValidationError(std::string("Malformed handover: ") + e.what());
+    }
+    return entries;
+}
+
+std::string describe(const BandwidthLimit& limit) {
+    std::ostringstream out;
+    out << limit.bytes_per_second << " B/s (interactive " << limit.interactive_share
+        << ", batch " << limit.batch_share << ")";
+    return out.str();
+}
+
+bool operator!=(const BandwidthLimit& a, const BandwidthLimit& b) {
+    return a.bytes_per_second != b.bytes_per_second || a.interactive_share != b.interactive_share ||
+           a.batch_share != b.batch_share;
+}
+
+json degradation_json(const DegradationPolicy& policy) {
+    auto rules = json::array();
+    for (const auto& rule : policy.rules) {
+        rules.push_back(json{
+            rule.queue_wait.count(), rule.error_rate,
+            rule.max_device_scale_factor ? json(*rule.max_device_scale_factor) : json(nullptr),
+            rule.disable_full_page,
+            rule.wait_until ? json(to_string(*rule.wait_until)) : json(nullptr),
+            rule.max_wait_for_timeout ? json(*rule.max_wait_for_timeout) : json(nullptr)
+        });
+    }
+    return json{rules, policy.error_window};
+}
+
+json blank_detection_json(const BlankDetection& detection) {
+    return json{detection.enabled, detection.max_variance, detection.min_dominant_share,
+                detection.tolerance, to_string(detection.action), detection.retries};
+}
+
+/// Identity of a configuration for Client::shared(): every field but the
+/// log handler, which cannot be compared
+std::string shared_key(const ClientConfig& config) {
+    const auto& log = config.log;
+    return json{
+        config.api_key, config.base_url, config.timeout_seconds,
+        config.user_agent ? json(*config.user_agent) : json(nullptr),
+        config.max_concurrency, config.adaptive_timeouts, config.max_output_pixels,
+        config.strict_preflight, config.memory_budget_bytes, config.pipeline_depth,
+        config.bandwidth.bytes_per_second, config.bandwidth.interactive_share,
+        config.bandwidth.batch_share, config.buffer_pool_bytes, config.result_cache_bytes,
+        config.result_cache_ttl.count(), to_string(config.result_cache_policy), config.proxy,
+        config.tcp_info_sample_rate, degradation_json(config.degradation),
+        blank_detection_json(config.blank_detection), config.tcp_fast_open, config.tls_early_data, config.tuning_file,
+        static_cast<int>(log.level), log.debug_sample_rate, log.info_sample_rate,
+        log.slow_request.count(), log.queue_records, config.handle_fork
+    }.dump();
+}
+
+void check_tuning(const Tuning& changes) {
+    if (changes.max_concurrency && *changes.max_concurrency < 1) {
+        throw ValidationError("max_concurrency must be at least 1");
+    }
+    auto non_negative = [](const std::optional<int64_t>& value, const char* name) {
+        if (value && *value < 0) {
+            throw ValidationError(std::string(name) + " must not be negative");
+        }
+    };
+    non_negative(changes.memory_budget_bytes, "memory_budget_bytes");
+    non_negative(changes.buffer_pool_bytes, "buffer_pool_bytes");
+    non_negative(changes.result_cache_bytes, "result_cache_bytes");
+    if (changes.bandwidth) {
+        non_negative(changes.bandwidth->bytes_per_second, "bandwidth.bytes_per_second");
+    }
+}
+
+} // namespace
+
 // =============================================================================
 // Implementation Details
 // =============================================================================
 
 struct Client::Impl {
-    ClientConfig config;
-    std::unique_ptr<httplib::Client> http;
+    /// A queued submit() request
+    struct Job {
+        ScreenshotOptions options;
+        Priority priority;
+        std::promise<ScreenshotResult> promise;
+        Clock::time_point enqueued;
+        double expected_ms;
+        int64_t expected_bytes;
+        int node;                               // NUMA node of the submitting thread
+        std::atomic<bool> handed_over{false};  // Included in a drain() handover
+    };
     
-    explicit Impl(ClientConfig cfg) : config(std::move(cfg)) {
-        // Parse base URL to extract host and scheme
-        std::string url = config.base_url;
+    /// What a worker is currently doing, for completion estimates. The
+    /// worker holds `mutex` while it takes jobs from the shards, so a job is
+    /// always either queued in a shard or listed here.
+    struct Running {
+        std::mutex mutex;
+        Clock::time_point started;
+        double expected_ms = 0;
+        int64_t expected_bytes = 0;
+        bool busy = false;
         
-        // Create HTTP client
-        http = std::make_unique<httplib::Client>(url);
-        http->set_connection_timeout(config.timeout_seconds);
-        http->set_read_timeout(config.timeout_seconds);
-        http->set_write_timeout(config.timeout_seconds);
+        // What drain() needs to hand over and cut off the work
+        std::vector<Job*> jobs;
+        httplib::Client* http = nullptr;
+        detail::RawConnection* pipe = nullptr;
+    };
+    
+    /// One submission queue. Submitting threads push to the shard of the
+    /// CPU they run on, so they rarely meet on the same lock; workers look
+    /// at every shard and take the best job among them. Jobs are kept in
+    /// arrival order.
+    struct alignas(64) Shard {
+        std::mutex mutex;
+        std::vector<std::unique_ptr<Job>> jobs;
+        std::atomic<int> interactive{0};        // Queued jobs per class, read without the lock
+        std::atomic<int> batch{0};
+    };
+    
+    /// Polls ClientConfig::tuning_file
+    struct Watcher {
+        std::thread thread;
+        std::mutex mutex;
+        std::condition_variable cv;
+        bool stopping = false;
+    };
+    
+    ClientConfig config;                    // Tunable fields guarded by queue_mutex
+    detail::CostModel cost;
+    detail::HostSketches sketches;
+    detail::BandwidthLimiter bandwidth;
+    detail::BufferPool buffers;
+    detail::ResultCache cache;
+    detail::FlightRecorder recorder{256};
+    detail::AsyncLogger logger;
+    
+    // Prepared once and shared by every connection, including those of
+    // forked children
+    detail::Endpoint endpoint;              // Empty host if base_url has no scheme
+    httplib::Headers request_headers;
+    httplib::Headers usage_headers;
+    detail::DnsCache dns{std::chrono::minutes(1)};
+    detail::SocketTracker sockets;          // Every socket opened, for after_fork()
+    std::optional<detail::Proxy> proxy;
+    std::atomic<uint64_t> connections_opened{0};
+    detail::TcpSampler tcp_sampler{config.tcp_info_sample_rate};
+    detail::Degrader degrader{config.degradation};
+    detail::BlankDetector blank{config.blank_detection};
+    
+    // Raw connections: TLS for pipelining and usage()
+    std::unique_ptr<detail::TlsContext> tls;
+    std::atomic<uint64_t> fast_open_attempts{0};
+    std::atomic<uint64_t> fast_open_accepted{0};
+    std::atomic<uint64_t> early_data_attempts{0};
+    std::atomic<uint64_t> early_data_accepted{0};
+    
+    // Connections for the synchronous calls. Each call checks one out, so
+    // concurrent callers of a shared client do not queue on one socket.
+    std::mutex http_mutex;                  // Guards idle_http, never held across I/O
+    std::vector<std::unique_ptr<httplib::Client>> idle_http;
+    
+    // usage() over a raw connection, with TCP Fast Open or TLS early data
+    std::string usage_request;              // Empty = usage() goes through httplib
+    std::mutex usage_mutex;                 // Guards usage_connection, never held across I/O
+    std::unique_ptr<detail::RawConnection> usage_connection;
+    
+    // Pipelining (stored-mode submit() jobs only)
+    std::string pipeline_head;              // Request line and headers
+    std::atomic<int> pipeline_failures{0};
+    std::atomic<bool> pipelining_disabled{false};
+    
+    // Dispatcher. Jobs wait in per-CPU shards. queue_mutex guards the worker
+    // pool, the tunable config fields and sleeping workers; submitting and
+    // taking jobs do not touch it unless a worker has to be woken.
+    std::mutex queue_mutex;
+    std::condition_variable queue_cv;
+    std::unique_ptr<Shard[]> shards;
+    size_t shard_count = 1;
+    std::vector<std::unique_ptr<Running>> running;
+    std::vector<std::thread> workers;
+    std::atomic<size_t> worker_count{0};
+    std::atomic<bool> workers_started{false};
+    std::atomic<int> idle_workers{0};       // Waiting on queue_cv
+    std::atomic<size_t> worker_cap{1};      // config.max_concurrency, read without the lock
+    std::atomic<int64_t> memory_budget{0};  // config.memory_budget_bytes, likewise
+    std::atomic<int64_t> in_flight_bytes{0};
+    std::atomic<bool> stopping{false};
+    uint64_t tuning_changes = 0;
+    std::atomic<bool> draining{false};      // drain() called: reject new work
+    std::atomic<bool> abandoning{false};    // drain() deadline passed: cut off in-flight work
+    
+    // Runtime tuning from a file
+    std::unique_ptr<Watcher> watcher;
+    std::string tuning_text;                // Last file contents seen
+    
+    explicit Impl(ClientConfig cfg)
+        : config(std::move(cfg)), bandwidth(config.bandwidth),
+          buffers(static_cast<size_t>(std::max<int64_t>(0, config.buffer_pool_bytes))),
+          cache(static_cast<size_t>(std::max<int64_t>(0, config.result_cache_bytes)),
+                config.result_cache_ttl, config.result_cache_policy),
+          logger(config.log) {
+        shard_count = std::max(1u, std::thread::hardware_concurrency());
+        shards = std::make_unique<Shard[]>(shard_count);
+        worker_cap.store(static_cast<size_t>(std::max(1, config.max_concurrency)), std::memory_order_relaxed);
+        memory_budget.store(config.memory_budget_bytes, std::memory_order_relaxed);
+        try {
+            endpoint = detail::parse_endpoint(config.base_url);
+        } catch (const Error&) {
+            // httplib also takes "host[:port]"; only pipelining needs more
+            if (config.pipeline_depth > 1) {
+                throw;
+            }
+        }
+        if (!config.proxy.empty()) {
+            try {
+                proxy = detail::parse_proxy(config.proxy);
+            } catch (const Error& e) {
+                throw ValidationError(std::string("Invalid proxy: ") + e.what());
+            }
+        }
+        request_headers = make_headers();
+        usage_headers = make_headers(false);
+        if ((config.tcp_fast_open || config.tls_early_data) && !endpoint.host.empty()) {
+            usage_request = "GET /v1/usage HTTP/1.1\r\nHost: " + endpoint.authority() + "\r\n";
+            for (const auto& [name, value] : usage_headers) {
+                usage_request += name + ": " + value + "\r\n";
+            }
+            usage_request += "\r\n";
+        }
+        if (endpoint.tls() && (config.pipeline_depth > 1 || !usage_request.empty())) {
+            tls = std::make_unique<detail::TlsContext>();
+        }
+        if (config.pipeline_depth > 1) {
+            pipeline_head = "POST /v1/screenshot HTTP/1.1\r\nHost: " + endpoint.authority() + "\r\n";
+            for (const auto& [name, value] : request_headers) {
+                pipeline_head += name + ": " + value + "\r\n";
+            }
+        }
+        idle_http.push_back(make_http());
+        if (!config.tuning_file.empty()) {
+            // Limits from the file apply before the first request
+            reload_tuning_file();
+            start_watcher();
+        }
+        if (config.handle_fork) {
+            register_fork_handlers(this);
+        }
+    }
+    
+    ~Impl() {
+        if (config.handle_fork) {
+            unregister_fork_handlers(this);
+        }
+        if (watcher) {
+            {
+                std::lock_guard<std::mutex> lock(watcher->mutex);
+                watcher->stopping = true;
+            }
+            watcher->cv.notify_all();
+            watcher->thread.join();
+        }
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex);
+            stopping = true;
+        }
+        queue_cv.notify_all();
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        for (size_t i = 0; i < shard_count; ++i) {
+            for (auto& job : shards[i].jobs) {
+                job->promise.set_exception(std::make_exception_ptr(
+                    Error("Client was destroyed before the request was sent")));
+            }
+        }
+    }
+    
+    [[nodiscard]] std::unique_ptr<httplib::Client> make_http() {
+        auto client = std::make_unique<httplib::Client>(config.base_url);
+        client->set_socket_options([this](httplib::socket_t sock) {
+            httplib::default_socket_options(sock);
+            sockets.add(static_cast<int>(sock));
+            connections_opened.fetch_add(1, std::memory_order_relaxed);
+            connect_phases.opened = Clock::now();
+            PXSHOT_PROBE(connection_acquire, static_cast<int>(sock), 1);
+        });
+        if (auto* ctx = client->ssl_context()) {
+            SSL_CTX_set_info_callback(ctx, on_tls_info);
+        }
+        if (proxy) {
+            // https goes through a CONNECT tunnel that lives as long as the
+            // kept-alive connection; plain http is forwarded by the proxy
+            client->set_proxy(proxy->endpoint.host, proxy->endpoint.port);
+            if (!proxy->username.empty()) {
+                client->set_proxy_basic_auth(proxy->username, proxy->password);
+            }
+        }
+        client->set_connection_timeout(config.timeout_seconds);
+        client->set_read_timeout(config.timeout_seconds);
+        client->set_write_timeout(config.timeout_seconds);
         
         // Enable following redirects
-        http->set_follow_location(true);
+        client->set_follow_location(true);
+        
+        // Reuse the connection across requests
+        client->set_keep_alive(true);
+        return client;
+    }
+    
+    /// Connection for a synchronous call. Concurrent calls each get their
+    /// own, so the call may change its settings, such as the read timeout.
+    [[nodiscard]] std::unique_ptr<httplib::Client> acquire_http() {
+        {
+            std::lock_guard<std::mutex> lock(http_mutex);
+            if (!idle_http.empty()) {
+                auto client = std::move(idle_http.back());
+                idle_http.pop_back();
+                return client;
+            }
+        }
+        return make_http();
+    }
+    
+    /// Keep `client` for the next synchronous call. A call that failed does
+    /// not return its connection, so the next one starts afresh.
+    void release_http(std::unique_ptr<httplib::Client> client) {
+        constexpr size_t kMaxIdle = 8;
+        
+        std::lock_guard<std::mutex> lock(http_mutex);
+        if (idle_http.size() < kMaxIdle) {
+            idle_http.push_back(std::move(client));
+        }
     }
     
     [[nodiscard]] httplib::Headers make_headers(bool json_content = true) const {
@@ -56,115 +450,421 @@ struct Client::Impl {
             throw HttpError(0, context + ": " + httplib::to_string(res.error()));
         }
         
-        if (res->status >= 400) {
+        check_status(res->status, res->body, context);
+    }
+    
+    void check_status(int status, const std::string& body_text, const std::string& context) {
+        if (status >= 400) {
             // Try to parse error response
             try {
-                auto body = json::parse(res->body);
+                auto body = json::parse(body_text);
                 std::string code = body.value("code", "unknown");
-                std::string message = body.value("message", res->body);
+                std::string message = body.value("message", body_text);
                 throw ApiError(code, message);
             } catch (const json::exception&) {
-                throw HttpError(res->status, context + ": HTTP " + std::to_string(res->status));
+                throw HttpError(status, context + ": HTTP " + std::to_string(status));
             }
         }
     }
-};
-
-// =============================================================================
-// Client Implementation
-// =============================================================================
-
-Client::Client(std::string_view api_key) 
-    : Client(ClientConfig{std::string(api_key)}) {}
-
-Client::Client(ClientConfig config) {
-    if (config.api_key.empty()) {
-        throw ValidationError("API key is required");
-    }
-    impl_ = std::make_unique<Impl>(std::move(config));
-}
-
-Client::~Client() = default;
-
-Client::Client(Client&&) noexcept = default;
-Client& Client::operator=(Client&&) noexcept = default;
-
-ScreenshotResult Client::screenshot(const ScreenshotOptions& options) {
-    // Validate
-    if (options.url.empty()) {
-        throw ValidationError("URL is required");
-    }
     
-    if (options.quality && (*options.quality < 0 || *options.quality > 100)) {
-        throw ValidationError("Quality must be between 0 and 100");
+    /// Read timeout for a request: the configured timeout, or with adaptive
+    /// timeouts a generous bound on the latency learned for its host.
+    [[nodiscard]] int read_timeout_for(const detail::CostModel::Estimate& expected) const {
+        constexpr int kMinSamples = 5;
+        constexpr int kFloorSeconds = 10;
+        
+        if (!config.adaptive_timeouts || expected.samples < kMinSamples) {
+            return config.timeout_seconds;
+        }
+        double bound_ms = std::max(2 * expected.latency_ms,
+                                   expected.latency_ms + 4 * expected.stddev_ms);
+        int seconds = static_cast<int>(bound_ms / 1000) + 1;
+        return std::clamp(seconds, std::min(kFloorSeconds, config.timeout_seconds),
+                          config.timeout_seconds);
     }
     
-    if (options.width && *options.width <= 0) {
-        throw ValidationError("Width must be positive");
+    void reject_if_draining() const {
+        if (draining.load(std::memory_order_relaxed)) {
+            throw Error("Client is shutting down");
+        }
     }
     
-    if (options.height && *options.height <= 0) {
-        throw ValidationError("Height must be positive");
+    /// Throw the first preflight error, if any
+    void validate(const ScreenshotOptions& options) const {
+        auto report = detail::preflight(options, config, cost);
+        if (!report.ok()) {
+            throw ValidationError(report.errors.front());
+        }
     }
     
-    // Build request body
-    json body;
-    body["url"] = options.url;
-    
-    if (options.format) {
-        body["format"] = to_string(*options.format);
-    }
-    if (options.quality) {
-        body["quality"] = *options.quality;
-    }
-    if (options.width) {
-        body["width"] = *options.width;
+    /// Result of an identical earlier request, if cached
+    [[nodiscard]] std::optional<ScreenshotResult> cached(const ScreenshotOptions& options) {
+        if (!cache.enabled()) {
+            return std::nullopt;
+        }
+        auto hit = cache.find(detail::to_request_body(options).dump());
+        if (hit) {
+            PXSHOT_PROBE(cache_hit, options.url.c_str());
+            hit->timings_ = RequestTimings{};
+            hit->degradation_ = Degradation{};
+        } else {
+            PXSHOT_PROBE(cache_miss, options.url.c_str());
+        }
+        return hit;
     }
-    if (options.height) {
-        body["height"] = *options.height;
+    
+    /// Record a client event in the flight recorder and the log
+    void note(LogLevel level, std::string message) {
+        logger.event(level, message);
+        recorder.record(std::move(message));
     }
-    if (options.full_page) {
-        body["full_page"] = *options.full_page;
+    
+    /// Image size of a result, for the host report
+    [[nodiscard]] static double result_bytes(const ScreenshotResult& result) {
+        return result.is_stored() ? static_cast<double>(result.size_bytes())
+                                  : static_cast<double>(result.bytes().size());
     }
-    if (options.wait_until) {
-        body["wait_until"] = to_string(*options.wait_until);
+    
+    [[nodiscard]] static double result_bytes(uint64_t streamed) {
+        return static_cast<double>(streamed);
     }
-    if (options.wait_for_selector) {
-        body["wait_for_selector"] = *options.wait_for_selector;
+    
+    [[nodiscard]] static RequestTimings timings_of(const ScreenshotResult& result) {
+        return result.timings();
     }
-    if (options.wait_for_timeout) {
-        body["wait_for_timeout"] = *options.wait_for_timeout;
+    
+    [[nodiscard]] static RequestTimings timings_of(uint64_t) {
+        return {};
     }
-    if (options.device_scale_factor) {
-        body["device_scale_factor"] = *options.device_scale_factor;
+    
+    /// Phases of a request sent with cpp-httplib, from connect_phases
+    [[nodiscard]] RequestTimings httplib_timings(Clock::time_point started,
+                                                 Clock::time_point first_byte) const {
+        auto now = Clock::now();
+        RequestTimings timings;
+        timings.first_byte = micros(first_byte - started);
+        timings.total = micros(now - started);
+        const auto& phases = connect_phases;
+        timings.reused_connection = phases.opened == Clock::time_point{};
+        if (!timings.reused_connection && phases.tls_done != Clock::time_point{}) {
+            // Without TLS there is no mark between connecting and the response
+            auto setup = micros(phases.tls_started - phases.opened);
+            (proxy ? timings.proxy_connect : timings.connect) = setup;
+            timings.tls_handshake = micros(phases.tls_done - phases.tls_started);
+        }
+        return timings;
     }
-    if (options.store) {
-        body["store"] = *options.store;
+    
+    /// Count a failed request in the host report and the error rate that
+    /// degradation watches
+    void record_failure(const ScreenshotOptions& options, double ms, std::exception_ptr error) {
+        auto label = detail::error_label(error);
+        sketches.record_failure(detail::host_of(options.url), ms, label);
+        if (label != "cancelled" && label != "handover") {
+            degrader.record_outcome(true);
+        }
     }
-    if (options.block_ads) {
-        body["block_ads"] = *options.block_ads;
+    
+    /// `options` relaxed by the degradation rules in force, if any apply.
+    /// Rules coming into or out of force are noted.
+    [[nodiscard]] std::optional<ScreenshotOptions> degrade(const ScreenshotOptions& options,
+                                                           Degradation& applied) {
+        if (!degrader.enabled()) {
+            return std::nullopt;
+        }
+        auto rules = degrader.triggered();
+        if (auto previous = degrader.enter(rules); previous != rules) {
+            if (rules == 0) {
+                note(LogLevel::Info, "degradation ended");
+            } else {
+                std::string message = "degradation rules in force:";
+                for (size_t i = 0; i < detail::Degrader::kMaxRules; ++i) {
+                    if (rules & uint64_t{1} << i) {
+                        message += " " + std::to_string(i);
+                    }
+                }
+                note(LogLevel::Warning, std::move(message));
+            }
+        }
+        return degrader.relax(options, rules, applied);
     }
     
-    // Make request
-    auto res = impl_->http->Post(
-        "/v1/screenshot",
-        impl_->make_headers(),
-        body.dump(),
-        "application/json"
-    );
+    /// Run `send` for a request and record how it went in the host report
+    /// and the log
+    template <typename Send>
+    auto tracked(const ScreenshotOptions& options, Priority priority, Send&& send) {
+        auto started = Clock::now();
+        auto elapsed_ms = [&] {
+            return std::chrono::duration<double, std::milli>(Clock::now() - started).count();
+        };
+        logger.request_started(options, priority);
+        PXSHOT_PROBE(request_start, options.url.c_str(), static_cast<int>(priority));
+        try {
+            auto result = send();
+            double ms = elapsed_ms();
+            double bytes = result_bytes(result);
+            sketches.record_success(detail::host_of(options.url), ms, bytes);
+            degrader.record_outcome(false);
+            logger.request_finished(options, priority, ms, static_cast<uint64_t>(bytes), nullptr,
+                                    timings_of(result));
+            return result;
+        } catch (...) {
+            double ms = elapsed_ms();
+            record_failure(options, ms, std::current_exception());
+            logger.request_finished(options, priority, ms, 0, std::current_exception());
+            throw;
+        }
+    }
     
-    impl_->check_response(res, "Screenshot request failed");
+    ScreenshotResult perform(httplib::Client& client, const ScreenshotOptions& options,
+                             Priority priority, int node, const ProgressHandler& on_progress = {},
+                             size_t granularity = 0) {
+        Degradation degradation;
+        auto relaxed = degrade(options, degradation);
+        const auto& sent = relaxed ? *relaxed : options;
+        auto capture = [&] {
+            return tracked(sent, priority, [&] {
+                return send_screenshot(client, sent, priority, node, on_progress, granularity);
+            });
+        };
+        auto result = capture();
+        for (int retries = 0; blank.retry_due(result.blank_, retries); ++retries) {
+            blank.count_retry();
+            PXSHOT_PROBE(retry, sent.url.c_str(), "blank_page");
+            result = capture();
+        }
+        result.degradation_ = degradation;
+        return result;
+    }
     
-    // Check if response is JSON (stored) or binary (image bytes)
-    bool store_mode = options.store.value_or(false);
+    /// Send a screenshot request and pass the body to `sink` as it arrives.
+    /// Returns the number of bytes written. The sink is aborted if the
+    /// transfer fails after begin(); a sink error cancels the transfer.
+    uint64_t stream_screenshot(httplib::Client& client, const ScreenshotOptions& options,
+                               ResultSink& sink) {
+        auto expected = cost.estimate(options);
+        client.set_read_timeout(read_timeout_for(expected));
+        
+        httplib::Request req;
+        req.method = "POST";
+        req.path = "/v1/screenshot";
+        req.headers = request_headers;
+        req.body = detail::to_request_body(options).dump();
+        
+        int status = 0;
+        bool begun = false;
+        uint64_t written = 0;
+        std::string error_body;
+        std::exception_ptr sink_error;
+        auto started = Clock::now();
+        
+        req.response_handler = [&](const httplib::Response& response) {
+            status = response.status;
+            if (status >= 400) {
+                return true;
+            }
+            std::optional<uint64_t> content_length;
+            auto length = response.get_header_value("Content-Length");
+            if (!length.empty()) {
+                try {
+                    content_length = std::stoull(length);
+                } catch (const std::exception&) {
+                    // Malformed length; the sink copes without one
+                }
+            }
+            try {
+                sink.begin(response.get_header_value("Content-Type"), content_length);
+                begun = true;
+                return true;
+            } catch (...) {
+                sink_error = std::current_exception();
+                return false;
+            }
+        };
+        
+        req.content_receiver = [&](const char* data, size_t length, uint64_t, uint64_t) {
+            bandwidth.consume(Priority::Interactive, length);
+            if (status >= 400) {
+                error_body.append(data, length);
+                return true;
+            }
+            try {
+                sink.write(reinterpret_cast<const uint8_t*>(data), length);
+                written += length;
+                return true;
+            } catch (...) {
+                sink_error = std::current_exception();
+                return false;
+            }
+        };
+        
+        auto res = client.send(req);
+        if (sink_error || !res || status >= 400) {
+            if (begun) {
+                sink.abort();
+            }
+            if (sink_error) {
+                std::rethrow_exception(sink_error);
+            }
+            if (!res) {
+                throw HttpError(0, "Screenshot request failed: " + httplib::to_string(res.error()));
+            }
+            check_status(status, error_body, "Screenshot request failed");
+        }
+        sink.finish();
+        
+        double elapsed_ms = std::chrono::duration<double, std::milli>(Clock::now() - started).count();
+        cost.record(options, elapsed_ms, static_cast<double>(written));
+        return written;
+    }
     
-    // Also check content-type header
-    auto content_type = res->get_header_value("Content-Type");
-    bool is_json = content_type.find("application/json") != std::string::npos;
+    /// Send a screenshot request, receiving the body straight into a byte
+    /// buffer, pooled and placed on `node` if large. `on_progress` runs on the receive path every `granularity`
+    /// bytes; returning false aborts the transfer, which closes the
+    /// connection (the unread remainder makes it unusable) so the next
+    /// request on this client reconnects.
+    ScreenshotResult send_screenshot(httplib::Client& client, const ScreenshotOptions& options,
+                                     Priority priority, int node, const ProgressHandler& on_progress,
+                                     size_t granularity) {
+        if (abandoning.load(std::memory_order_relaxed)) {
+            throw HandoverError("Request was handed over by drain()");
+        }
+        constexpr uint64_t kMaxReserve = 256 * 1024 * 1024;
+        
+        auto expected = cost.estimate(options);
+        client.set_read_timeout(read_timeout_for(expected));
+        
+        httplib::Request req;
+        req.method = "POST";
+        req.path = "/v1/screenshot";
+        req.headers = request_headers;
+        req.body = detail::to_request_body(options).dump();
+        
+        int status = 0;
+        std::string content_type;
+        std::optional<uint64_t> content_length;
+        std::vector<uint8_t> body;
+        uint64_t reported = 0;
+        Clock::time_point first_byte;
+        auto started = Clock::now();
+        
+        // Read once the body is in, while this request still owns the
+        // connection
+        bool sample_tcp = tcp_sampler.due();
+        std::optional<TcpInfo> tcp_info;
+        auto sample = [&] {
+            if (sample_tcp && !tcp_info) {
+                tcp_info = tcp_sampler.sample(client.socket());
+            }
+        };
+        
+        auto progress = [&] {
+            auto now = Clock::now();
+            double seconds = std::chrono::duration<double>(now - first_byte).count();
+            TransferProgress p;
+            p.bytes_received = body.size();
+            p.expected_bytes = content_length;
+            p.bytes_per_second = seconds > 0 ? static_cast<double>(body.size()) / seconds : 0;
+            p.elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - started);
+            reported = body.size();
+            return p;
+        };
+        
+        Clock::time_point headers_at;
+        req.response_handler = [&](const httplib::Response& response) {
+            headers_at = Clock::now();
+            status = response.status;
+            PXSHOT_PROBE(first_byte, status, static_cast<long long>(micros(headers_at - started).count()));
+            content_type = response.get_header_value("Content-Type");
+            auto length = response.get_header_value("Content-Length");
+            if (!length.empty()) {
+                try {
+                    content_length = std::stoull(length);
+                    auto reserve = static_cast<size_t>(std::min(*content_length, kMaxReserve));
+                    if (buffers.enabled() && reserve >= detail::BufferPool::kMinPooled) {
+                        body = buffers.acquire(reserve, node);
+                    } else {
+                        body.reserve(reserve);
+                    }
+                } catch (const std::exception&) {
+                    // Malformed length; grow as data arrives
+                }
+            }
+            if (content_length.value_or(0) == 0) {
+                sample();       // No telling when the body ends
+            }
+            return true;
+        };
+        
+        req.content_receiver = [&](const char* data, size_t length, uint64_t, uint64_t) {
+            if (body.empty()) {
+                first_byte = Clock::now();
+            }
+            // Sleeping here stops reading the socket, so TCP flow control
+            // slows the sender down to the shaped rate
+            bandwidth.consume(priority, length);
+            body.insert(body.end(), data, data + length);
+            if (content_length && body.size() >= *content_length) {
+                sample();
+            }
+            if (on_progress && status < 400 && body.size() - reported >= granularity) {
+                return on_progress(progress());
+            }
+            return true;
+        };
+        
+        connect_phases = {};
+        if (client.socket() != INVALID_SOCKET) {
+            // The kept-alive connection; if it has gone stale, httplib
+            // reconnects and the socket hook reports a fresh one as well
+            PXSHOT_PROBE(connection_acquire, static_cast<int>(client.socket()), 0);
+        }
+        auto res = client.send(req);
+        if (!res) {
+            if (res.error() == httplib::Error::Canceled) {
+                throw CancelledError("Screenshot transfer cancelled after " +
+                                     std::to_string(body.size()) + " bytes");
+            }
+            throw HttpError(0, "Screenshot request failed: " + httplib::to_string(res.error()));
+        }
+        
+        if (status >= 400) {
+            check_status(status, std::string(body.begin(), body.end()), "Screenshot request failed");
+        }
+        if (on_progress && body.size() != reported) {
+            // Final report; the transfer is complete so the return value is moot
+            on_progress(progress());
+        }
+        
+        auto finished = Clock::now();
+        PXSHOT_PROBE(body_complete, status, static_cast<unsigned long long>(body.size()),
+                     static_cast<long long>(micros(finished - started).count()));
+        double elapsed_ms = std::chrono::duration<double, std::milli>(finished - started).count();
+        cost.record(options, elapsed_ms, static_cast<double>(body.size()));
+        
+        // Check if response is JSON (stored) or binary (image bytes)
+        bool store_mode = options.store.value_or(false);
+        
+        // Also check content-type header
+        bool is_json = content_type.find("application/json") != std::string::npos;
+        
+        auto text = reinterpret_cast<const char*>(body.data());
+        auto result = store_mode || is_json ? parse_stored(text, text + body.size())
+                                            : ScreenshotResult(std::move(body));
+        result.timings_ = httplib_timings(started, headers_at);
+        result.timings_.tcp = tcp_info;
+        if (blank.enabled() && result.is_bytes()) {
+            result.blank_ = blank.check(result.bytes());
+        }
+        if (cache.enabled() && result.blank_.verdict != BlankVerdict::Blank) {
+            cache.insert(req.body, result);
+        }
+        return result;
+    }
     
-    if (store_mode || is_json) {
+    [[nodiscard]] static ScreenshotResult parse_stored(const char* begin, const char* end) {
         try {
-            auto response = json::parse(res->body);
+            auto response = json::parse(begin, end);
             
             StoredScreenshot stored;
             stored.url = response.at("url").get<std::string>();
@@ -177,20 +877,1211 @@ ScreenshotResult Client::screenshot(const ScreenshotOptions& options) {
         } catch (const json::exception& e) {
             throw Error(std::string("Failed to parse stored screenshot response: ") + e.what());
         }
-    } else {
-        // Binary image data
-        std::vector<uint8_t> bytes(res->body.begin(), res->body.end());
-        return ScreenshotResult(std::move(bytes));
     }
+    
+    // -------------------------------------------------------------------------
+    // Pipelining
+    // -------------------------------------------------------------------------
+    
+    /// Whether a job may share a pipelined write with others
+    [[nodiscard]] bool pipelinable(const Job& job) const {
+        return config.pipeline_depth > 1 && !pipelining_disabled.load(std::memory_order_relaxed) &&
+               job.options.store.value_or(false);
+    }
+    
+    [[nodiscard]] std::string serialize_request(const std::string& body) const {
+        std::string wire = pipeline_head;
+        wire += "Content-Length: " + std::to_string(body.size()) + "\r\n\r\n";
+        wire += body;
+        return wire;
+    }
+    
+    /// Open a raw connection to the API, recorded for after_fork(), counting
+    /// early data sent with it
+    [[nodiscard]] std::unique_ptr<detail::RawConnection> open_raw(const detail::FastConnect& fast) {
+        // Through a proxy only the proxy's address is looked up
+        const auto& peer = proxy ? proxy->endpoint : endpoint;
+        auto connection = std::make_unique<detail::RawConnection>(
+            endpoint, config.timeout_seconds, tls.get(), dns.lookup(peer.host), proxy ? &*proxy : nullptr,
+            fast);
+        sockets.add(connection->fd());
+        connections_opened.fetch_add(1, std::memory_order_relaxed);
+        if (connection->early_data() != detail::EarlyData::NotSent) {
+            early_data_attempts.fetch_add(1, std::memory_order_relaxed);
+            if (connection->early_data() == detail::EarlyData::Accepted) {
+                early_data_accepted.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+        return connection;
+    }
+    
+    /// Count a new connection's TCP Fast Open use, once the server has
+    /// answered the SYN
+    void count_fast_open(const detail::RawConnection& connection) {
+        if (connection.fast_open()) {
+            fast_open_attempts.fetch_add(1, std::memory_order_relaxed);
+            if (connection.fast_open_accepted()) {
+                fast_open_accepted.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    }
+    
+    /// GET /v1/usage on a raw connection kept for it. The request is
+    /// read-only, so a new connection may carry it as TLS early data, or
+    /// for plain http in the SYN, and a stale one may be retried.
+    [[nodiscard]] detail::RawResponse fetch_usage() {
+        constexpr int kTooEarly = 425;
+        
+        std::unique_ptr<detail::RawConnection> connection;
+        {
+            std::lock_guard<std::mutex> lock(usage_mutex);
+            connection = std::move(usage_connection);
+        }
+        for (int attempt = 0;; ++attempt) {
+            bool reused = connection != nullptr;
+            try {
+                if (!connection) {
+                    detail::FastConnect fast;
+                    fast.tcp_fast_open = config.tcp_fast_open;
+                    if (config.tls_early_data) {
+                        fast.early_data = usage_request;
+                    }
+                    connection = open_raw(fast);
+                }
+                bool early = !reused && connection->early_data() == detail::EarlyData::Accepted;
+                if (!early) {
+                    connection->write(usage_request);
+                }
+                auto response = connection->read_response();
+                if (!reused) {
+                    count_fast_open(*connection);
+                }
+                if (early && response.status == kTooEarly && !response.close) {
+                    // The server wants it again now that the handshake is done
+                    connection->write(usage_request);
+                    response = connection->read_response();
+                }
+                if (!response.close) {
+                    std::lock_guard<std::mutex> lock(usage_mutex);
+                    if (!usage_connection) {
+                        usage_connection = std::move(connection);
+                    }
+                }
+                return response;
+            } catch (const HttpError&) {
+                connection.reset();
+                if (!reused || attempt > 0) {
+                    throw;
+                }
+                // The kept-alive connection had gone stale; try a fresh one
+            }
+        }
+    }
+    
+    /// Write all requests back-to-back on `pipe`, then read the responses in
+    /// order. If the server closes the connection part-way (an explicit
+    /// Connection: close or a dropped socket), the unanswered requests are
+    /// sent again one at a time on the regular connection; repeated
+    /// mid-pipeline closes switch pipelining off for this client.
+    void perform_pipelined(Running& slot, httplib::Client& client,
+                           std::unique_ptr<detail::RawConnection>& pipe,
+                           std::vector<std::unique_ptr<Job>>& jobs) {
+        constexpr int kMaxPipelineFailures = 3;
+        
+        auto dispatched = Clock::now();
+        std::string wire;
+        std::vector<ScreenshotOptions> sent_options;   // After degradation, as recorded
+        std::vector<std::string> bodies;        // Cache keys, as sent
+        std::vector<Degradation> degradations(jobs.size());
+        for (size_t i = 0; i < jobs.size(); ++i) {
+            const auto& job = jobs[i];
+            auto relaxed = degrade(job->options, degradations[i]);
+            sent_options.push_back(relaxed ? std::move(*relaxed) : job->options);
+            bodies.push_back(detail::to_request_body(sent_options.back()).dump());
+            wire += serialize_request(bodies.back());
+            logger.request_started(sent_options.back(), job->priority);
+            PXSHOT_PROBE(request_start, job->options.url.c_str(), static_cast<int>(job->priority));
+        }
+        
+        size_t answered = 0;
+        for (int attempt = 0; attempt < 2; ++attempt) {
+            bool reused = pipe != nullptr;
+            try {
+                if (!pipe) {
+                    // Requests are not replay-safe, so the SYN may only
+                    // carry a TLS ClientHello or a proxy CONNECT
+                    detail::FastConnect fast;
+                    fast.tcp_fast_open = config.tcp_fast_open && (endpoint.tls() || proxy);
+                    auto fresh = open_raw(fast);
+                    count_fast_open(*fresh);
+                    replace_pipe(slot, pipe, std::move(fresh));
+                }
+                PXSHOT_PROBE(connection_acquire, pipe->fd(), reused ? 0 : 1);
+                pipe->write(wire);
+                
+                auto sent = Clock::now();
+                auto last = sent;
+                while (answered < jobs.size()) {
+                    auto response = pipe->read_response();
+                    auto now = Clock::now();
+                    auto& job = *jobs[answered];
+                    const auto& options = sent_options[answered++];
+                    PXSHOT_PROBE(body_complete, response.status, static_cast<unsigned long long>(response.body.size()),
+                                 static_cast<long long>(micros(now - sent).count()));
+                    bandwidth.consume(job.priority, response.body.size());
+                    // Time since the previous response approximates this request's render
+                    double render_ms = std::chrono::duration<double, std::milli>(now - last).count();
+                    try {
+                        check_status(response.status, response.body, "Screenshot request failed");
+                        auto text = response.body.data();
+                        auto result = parse_stored(text, text + response.body.size());
+                        result.timings_.total = micros(now - sent);
+                        result.timings_.reused_connection = reused || answered > 1;
+                        if (tcp_sampler.due()) {
+                            result.timings_.tcp = tcp_sampler.sample(pipe->fd());
+                        }
+                        if (!result.timings_.reused_connection) {
+                            // The first response on a new connection paid for it
+                            const auto& setup = pipe->timings();
+                            result.timings_.proxy_connect = setup.proxy_connect;
+                            result.timings_.connect = setup.connect;
+                            result.timings_.tls_handshake = setup.tls_handshake;
+                        }
+                        cost.record(options, render_ms, static_cast<double>(response.body.size()));
+                        sketches.record_success(detail::host_of(options.url), render_ms,
+                                                result_bytes(result));
+                        degrader.record_outcome(false);
+                        logger.request_finished(options, job.priority, render_ms,
+                                                static_cast<uint64_t>(result_bytes(result)), nullptr,
+                                                result.timings());
+                        if (cache.enabled()) {
+                            cache.insert(bodies[answered - 1], result);
+                        }
+                        result.timings_.queued = micros(dispatched - job.enqueued);
+                        result.degradation_ = degradations[answered - 1];
+                        job.promise.set_value(std::move(result));
+                    } catch (...) {
+                        record_failure(options, render_ms, std::current_exception());
+                        logger.request_finished(options, job.priority, render_ms, 0,
+                                                std::current_exception());
+                        fail(job, std::current_exception());
+                    }
+                    last = now;
+                    if (response.close) {
+                        replace_pipe(slot, pipe, nullptr);
+                        break;
+                    }
+                }
+            } catch (const Error&) {
+                replace_pipe(slot, pipe, nullptr);
+                if (reused && answered == 0 && !abandoning.load(std::memory_order_relaxed)) {
+                    // The idle keep-alive connection had gone stale; that
+                    // says nothing about pipelining, so try a fresh one
+                    PXSHOT_PROBE(retry, jobs.front()->options.url.c_str(), "stale_connection");
+                    continue;
+                }
+            }
+            break;
+        }
+        
+        if (answered == jobs.size()) {
+            pipeline_failures.store(0, std::memory_order_relaxed);
+            return;
+        }
+        
+        if (pipeline_failures.fetch_add(1, std::memory_order_relaxed) + 1 >= kMaxPipelineFailures &&
+            !pipelining_disabled.exchange(true, std::memory_order_relaxed)) {
+            note(LogLevel::Warning, "pipelining switched off after " + std::to_string(kMaxPipelineFailures) +
+                            " mid-pipeline closes");
+        }
+        for (size_t i = answered; i < jobs.size(); ++i) {
+            sketches.record_retry(detail::host_of(jobs[i]->options.url));
+            PXSHOT_PROBE(retry, jobs[i]->options.url.c_str(), "pipeline_closed");
+            try {
+                jobs[i]->promise.set_value(
+                    perform(client, jobs[i]->options, jobs[i]->priority, jobs[i]->node));
+            } catch (...) {
+                fail(*jobs[i], std::current_exception());
+            }
+        }
+    }
+    
+    /// Swap a worker's pipelined connection, keeping the one drain() would
+    /// interrupt up to date. The old connection is closed outside the lock.
+    void replace_pipe(Running& slot, std::unique_ptr<detail::RawConnection>& pipe,
+                      std::unique_ptr<detail::RawConnection> next) {
+        auto old = std::move(pipe);
+        std::lock_guard<std::mutex> lock(slot.mutex);
+        slot.pipe = next.get();
+        pipe = std::move(next);
+        if (pipe && abandoning.load(std::memory_order_relaxed)) {
+            pipe->interrupt();
+        }
+    }
+    
+    // -------------------------------------------------------------------------
+    // Dispatcher
+    // -------------------------------------------------------------------------
+    
+    /// Connect a worker's next connection to the cached API addresses. Only
+    /// worker connections are pinned: each belongs to a single thread, so
+    /// the mapping can be refreshed as the cache turns over.
+    void use_cached_addresses(httplib::Client& client) {
+        if (endpoint.host.empty() || proxy) {
+            return;     // The proxy resolves the API host
+        }
+        auto addresses = dns.lookup(endpoint.host);
+        if (!addresses.empty()) {
+            client.set_hostname_addr_map({{endpoint.host, addresses.front()}});
+        }
+    }
+    
+    /// Workers allowed to take jobs
+    [[nodiscard]] size_t worker_limit() const {
+        return worker_cap.load(std::memory_order_relaxed);
+    }
+    
+    /// Start workers up to the limit; the pool starts on first use and
+    /// grows when tuned up. Workers beyond a lowered limit are kept, parked.
+    /// Requires queue_mutex.
+    void ensure_workers() {
+        size_t count = worker_limit();
+        if (workers.size() < count) {
+            while (running.size() < count) {
+                running.push_back(std::make_unique<Running>());
+            }
+            for (size_t i = workers.size(); i < count; ++i) {
+                workers.emplace_back([this, i, slot = running[i].get()] { worker_loop(i, *slot); });
+            }
+            worker_count.store(workers.size(), std::memory_order_relaxed);
+        }
+        workers_started.store(true, std::memory_order_release);
+    }
+    
+    /// Shard for the calling thread: that of the CPU it is running on where
+    /// the platform says, so threads on one core share a queue
+    [[nodiscard]] size_t submit_shard() const {
+#ifdef __linux__
+        int cpu = sched_getcpu();
+        if (cpu >= 0) {
+            return static_cast<size_t>(cpu) % shard_count;
+        }
+#endif
+        static std::atomic<size_t> next_thread{0};
+        thread_local size_t thread_shard = next_thread.fetch_add(1, std::memory_order_relaxed);
+        return thread_shard % shard_count;
+    }
+    
+    void enqueue(std::vector<std::unique_ptr<Job>> jobs) {
+        // Repeats of cached requests complete without being queued
+        if (cache.enabled()) {
+            reject_if_draining();
+            auto served = [&](std::unique_ptr<Job>& job) {
+                auto hit = cached(job->options);
+                if (hit) {
+                    job->promise.set_value(std::move(*hit));
+                }
+                return hit.has_value();
+            };
+            jobs.erase(std::remove_if(jobs.begin(), jobs.end(), served), jobs.end());
+            if (jobs.empty()) {
+                return;
+            }
+        }
+        
+        if (!workers_started.load(std::memory_order_acquire)) {
+            std::lock_guard<std::mutex> lock(queue_mutex);
+            ensure_workers();
+        }
+        
+        size_t count = jobs.size();
+        auto& shard = shards[submit_shard()];
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            // Checked under the shard lock, so drain() either sees these
+            // jobs or they are refused
+            if (stopping.load(std::memory_order_relaxed) || draining.load(std::memory_order_relaxed)) {
+                throw Error("Client is shutting down");
+            }
+            for (auto& job : jobs) {
+                auto& queued = job->priority == Priority::Interactive ? shard.interactive : shard.batch;
+                queued.fetch_add(1, std::memory_order_relaxed);
+                shard.jobs.push_back(std::move(job));
+            }
+        }
+        wake(count);
+    }
+    
+    /// Wake workers for `count` new jobs. Submitters publish jobs before
+    /// looking for idle workers and workers count themselves idle before
+    /// their last look at the shards, so one side always sees the other.
+    void wake(size_t count) {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (idle_workers.load(std::memory_order_relaxed) == 0) {
+            return;
+        }
+        {
+            // An idle worker is either waiting or about to look again
+            std::lock_guard<std::mutex> lock(queue_mutex);
+        }
+        // A parked worker would swallow a single notification
+        if (count == 1 && worker_count.load(std::memory_order_relaxed) <= worker_limit()) {
+            queue_cv.notify_one();
+        } else {
+            queue_cv.notify_all();
+        }
+    }
+    
+    /// Whether starting `job` keeps expected in-flight bytes within budget.
+    /// A job always fits when nothing else is running.
+    [[nodiscard]] bool fits_budget(int64_t in_flight, int64_t expected_bytes) const {
+        int64_t budget = memory_budget.load(std::memory_order_relaxed);
+        return budget <= 0 || in_flight <= 0 || in_flight + expected_bytes <= budget;
+    }
+    
+    /// Count `expected_bytes` in flight if they fit the budget
+    [[nodiscard]] bool reserve_budget(int64_t expected_bytes) {
+        auto in_flight = in_flight_bytes.load(std::memory_order_relaxed);
+        do {
+            if (!fits_budget(in_flight, expected_bytes)) {
+                return false;
+            }
+        } while (!in_flight_bytes.compare_exchange_weak(in_flight, in_flight + expected_bytes,
+                                                        std::memory_order_relaxed));
+        return true;
+    }
+    
+    /// Where `job` stands in the order jobs are run: interactive before
+    /// batch, then by find_next()'s score, or for batch work by age. Lower
+    /// goes first.
+    [[nodiscard]] static std::pair<int, double> rank(const Job& job, Clock::time_point now) {
+        double waited_ms = std::chrono::duration<double, std::milli>(now - job.enqueued).count();
+        if (job.priority == Priority::Interactive) {
+            return {0, job.expected_ms - waited_ms};
+        }
+        return {1, -waited_ms};
+    }
+    
+    /// Find the next job to run from `shard`. Interactive work goes first,
+    /// cheapest expected job first; time already spent waiting counts
+    /// against the cost so that an expensive job cannot starve behind a
+    /// stream of cheap ones. Batch work is served in arrival order. Jobs
+    /// that would overrun the memory budget are skipped until enough work
+    /// completes. Requires the shard's mutex.
+    [[nodiscard]] std::vector<std::unique_ptr<Job>>::iterator find_next(Shard& shard) const {
+        auto now = Clock::now();
+        auto in_flight = in_flight_bytes.load(std::memory_order_relaxed);
+        auto& queue = shard.jobs;
+        auto best = queue.end();
+        auto first_batch = queue.end();
+        std::pair<int, double> best_rank;
+        for (auto it = queue.begin(); it != queue.end(); ++it) {
+            if (!fits_budget(in_flight, (*it)->expected_bytes)) {
+                continue;
+            }
+            if ((*it)->priority != Priority::Interactive) {
+                if (first_batch == queue.end()) {
+                    first_batch = it;
+                }
+                continue;
+            }
+            auto r = rank(**it, now);
+            if (best == queue.end() || r < best_rank) {
+                best = it;
+                best_rank = r;
+            }
+        }
+        return best != queue.end() ? best : first_batch;
+    }
+    
+    /// Move worker `index`'s next jobs into `jobs` and list them in its
+    /// slot. The next job of every shard is compared by rank() and the
+    /// best taken, so the cheapest-first and FIFO orders hold across
+    /// shards as they do within one; the worker's home shard wins ties.
+    /// Stored-mode jobs the chosen shard would hand out next ride along in
+    /// one pipelined write.
+    bool take_jobs(size_t index, Running& slot, std::vector<std::unique_ptr<Job>>& jobs) {
+        std::lock_guard<std::mutex> running_lock(slot.mutex);
+        for (;;) {
+            auto now = Clock::now();
+            Shard* chosen = nullptr;
+            std::pair<int, double> chosen_rank;
+            for (size_t k = 0; k < shard_count; ++k) {
+                auto& shard = shards[(index + k) % shard_count];
+                if (shard.interactive.load(std::memory_order_relaxed) == 0 &&
+                    shard.batch.load(std::memory_order_relaxed) == 0) {
+                    continue;
+                }
+                std::lock_guard<std::mutex> lock(shard.mutex);
+                auto next = find_next(shard);
+                if (next == shard.jobs.end()) {
+                    continue;
+                }
+                auto r = rank(**next, now);
+                if (!chosen || r < chosen_rank) {
+                    chosen = &shard;
+                    chosen_rank = r;
+                }
+            }
+            if (!chosen) {
+                return false;
+            }
+            
+            auto& shard = *chosen;
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            auto next = find_next(shard);
+            if (next == shard.jobs.end() || !reserve_budget((*next)->expected_bytes)) {
+                continue;       // Another worker got there first; look again
+            }
+            double expected_ms = 0;
+            int64_t expected_bytes = 0;
+            for (;;) {
+                auto& queued = (*next)->priority == Priority::Interactive ? shard.interactive : shard.batch;
+                queued.fetch_sub(1, std::memory_order_relaxed);
+                expected_ms += (*next)->expected_ms;
+                expected_bytes += (*next)->expected_bytes;
+                jobs.push_back(std::move(*next));
+                shard.jobs.erase(next);
+                
+                if (!pipelinable(*jobs.front()) ||
+                    jobs.size() >= static_cast<size_t>(config.pipeline_depth) ||
+                    (next = find_next(shard)) == shard.jobs.end() || !pipelinable(**next) ||
+                    !reserve_budget((*next)->expected_bytes)) {
+                    break;
+                }
+            }
+            
+            slot.started = Clock::now();
+            if (degrader.enabled()) {
+                degrader.record_queue_wait(micros(slot.started - jobs.front()->enqueued));
+            }
+            slot.expected_ms = expected_ms;
+            slot.expected_bytes = expected_bytes;
+            slot.busy = true;
+            slot.jobs.clear();
+            for (auto& job : jobs) {
+                slot.jobs.push_back(job.get());
+            }
+            return true;
+        }
+    }
+    
+    /// Whether no submit() request is queued, read without the shard locks
+    [[nodiscard]] bool queue_empty() const {
+        for (size_t i = 0; i < shard_count; ++i) {
+            if (shards[i].interactive.load(std::memory_order_relaxed) != 0 ||
+                shards[i].batch.load(std::memory_order_relaxed) != 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+    
+    void worker_loop(size_t index, Running& slot) {
+        auto client = make_http();
+        std::unique_ptr<detail::RawConnection> pipe;
+        {
+            std::lock_guard<std::mutex> lock(slot.mutex);
+            slot.http = client.get();
+        }
+        for (;;) {
+            std::vector<std::unique_ptr<Job>> jobs;
+            if (stopping.load(std::memory_order_relaxed)) {
+                return;
+            }
+            if (index >= worker_limit() || !take_jobs(index, slot, jobs)) {
+                if (degrader.enabled() && queue_empty()) {
+                    degrader.record_queue_wait(std::chrono::microseconds(0));
+                }
+                std::unique_lock<std::mutex> lock(queue_mutex);
+                idle_workers.fetch_add(1, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                queue_cv.wait(lock, [&] {
+                    return stopping.load(std::memory_order_relaxed) ||
+                           (index < worker_limit() && take_jobs(index, slot, jobs));
+                });
+                idle_workers.fetch_sub(1, std::memory_order_relaxed);
+                if (jobs.empty()) {
+                    return;     // Stopping
+                }
+            }
+            
+            use_cached_addresses(*client);
+            if (jobs.size() > 1) {
+                perform_pipelined(slot, *client, pipe, jobs);
+            } else {
+                try {
+                    auto& job = *jobs.front();
+                    auto queued = micros(Clock::now() - job.enqueued);
+                    auto result = perform(*client, job.options, job.priority, job.node);
+                    result.timings_.queued = queued;
+                    job.promise.set_value(std::move(result));
+                } catch (...) {
+                    fail(*jobs.front(), std::current_exception());
+                }
+            }
+            
+            int64_t expected_bytes = 0;
+            {
+                std::lock_guard<std::mutex> lock(slot.mutex);
+                slot.busy = false;
+                slot.jobs.clear();
+                expected_bytes = slot.expected_bytes;
+            }
+            in_flight_bytes.fetch_sub(expected_bytes, std::memory_order_relaxed);
+            if (memory_budget.load(std::memory_order_relaxed) > 0 || draining.load(std::memory_order_relaxed)) {
+                // Freed budget may unblock jobs other workers skipped, and
+                // drain() waits for in-flight work to finish
+                {
+                    std::lock_guard<std::mutex> lock(queue_mutex);
+                }
+                queue_cv.notify_all();
+            }
+        }
+    }
+    
+    /// Fail a job, reporting a handover instead if drain() took it over
+    static void fail(Job& job, std::exception_ptr error) {
+        if (job.handed_over.load(std::memory_order_relaxed)) {
+            error = std::make_exception_ptr(HandoverError("Request was handed over by drain()"));
+        }
+        job.promise.set_exception(std::move(error));
+    }
+    
+    DrainResult drain(Clock::time_point deadline) {
+        DrainResult result;
+        json requests = json::array();
+        std::vector<std::unique_ptr<Job>> queued;
+        {
+            std::unique_lock<std::mutex> lock(queue_mutex);
+            draining.store(true, std::memory_order_relaxed);
+            for (size_t i = 0; i < shard_count; ++i) {
+                auto& shard = shards[i];
+                std::lock_guard<std::mutex> shard_lock(shard.mutex);
+                std::move(shard.jobs.begin(), shard.jobs.end(), std::back_inserter(queued));
+                shard.jobs.clear();
+                shard.interactive.store(0, std::memory_order_relaxed);
+                shard.batch.store(0, std::memory_order_relaxed);
+            }
+            
+            auto in_flight = [&] {
+                int count = 0;
+                for (const auto& slot : running) {
+                    std::lock_guard<std::mutex> slot_lock(slot->mutex);
+                    count += slot->busy ? static_cast<int>(slot->jobs.size()) : 0;
+                }
+                return count;
+            };
+            int started = in_flight();
+            queue_cv.wait_until(lock, deadline, [&] { return in_flight() == 0; });
+            
+            // Whatever is still running is cut off and handed over. Workers
+            // only release their jobs under the slot lock, so the pointers
+            // are live.
+            abandoning.store(true, std::memory_order_relaxed);
+            for (auto& slot : running) {
+                std::lock_guard<std::mutex> slot_lock(slot->mutex);
+                if (!slot->busy) {
+                    continue;
+                }
+                for (auto* job : slot->jobs) {
+                    job->handed_over.store(true, std::memory_order_relaxed);
+                    requests.push_back(handover_entry(job->options, job->priority));
+                    ++result.interrupted;
+                }
+                slot->http->stop();
+                if (slot->pipe) {
+                    slot->pipe->interrupt();
+                }
+            }
+            result.completed = started - result.interrupted;
+        }
+        
+        for (auto& job : queued) {
+            requests.push_back(handover_entry(job->options, job->priority));
+            job->promise.set_exception(std::make_exception_ptr(
+                HandoverError("Request was handed over by drain()")));
+        }
+        result.handed_over = static_cast<int>(requests.size());
+        result.handover = json{{"version", kHandoverVersion}, {"requests", std::move(requests)}}.dump();
+        note(LogLevel::Info, "drain(): " + std::to_string(result.completed) + " completed, " +
+                        std::to_string(result.interrupted) + " interrupted, " +
+                        std::to_string(result.handed_over) + " handed over");
+        return result;
+    }
+    
+    // -------------------------------------------------------------------------
+    // Runtime tuning
+    // -------------------------------------------------------------------------
+    
+    /// Apply `changes` in one step under the scheduler lock, logging each
+    /// value that actually changes as coming from `source`
+    void tune(const Tuning& changes, const std::string& source) {
+        check_tuning(changes);
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex);
+            bool changed = false;
+            auto log = [&](const char* name, const auto& from, const auto& to) {
+                std::ostringstream out;
+                out << source << ": " << name << " " << from << " -> " << to;
+                note(LogLevel::Info, out.str());
+                changed = true;
+            };
+            
+            if (changes.max_concurrency && *changes.max_concurrency != config.max_concurrency) {
+                log("max_concurrency", config.max_concurrency, *changes.max_concurrency);
+                config.max_concurrency = *changes.max_concurrency;
+                worker_cap.store(static_cast<size_t>(config.max_concurrency), std::memory_order_relaxed);
+                if (!workers.empty()) {
+                    ensure_workers();
+                }
+            }
+            if (changes.memory_budget_bytes && *changes.memory_budget_bytes != config.memory_budget_bytes) {
+                log("memory_budget_bytes", config.memory_budget_bytes, *changes.memory_budget_bytes);
+                config.memory_budget_bytes = *changes.memory_budget_bytes;
+                memory_budget.store(config.memory_budget_bytes, std::memory_order_relaxed);
+            }
+            if (changes.bandwidth && *changes.bandwidth != config.bandwidth) {
+                log("bandwidth", describe(config.bandwidth), describe(*changes.bandwidth));
+                config.bandwidth = *changes.bandwidth;
+                bandwidth.configure(config.bandwidth);
+            }
+            if (changes.buffer_pool_bytes && *changes.buffer_pool_bytes != config.buffer_pool_bytes) {
+                log("buffer_pool_bytes", config.buffer_pool_bytes, *changes.buffer_pool_bytes);
+                config.buffer_pool_bytes = *changes.buffer_pool_bytes;
+                buffers.set_max_idle_bytes(static_cast<size_t>(config.buffer_pool_bytes));
+            }
+            if (changes.result_cache_bytes && *changes.result_cache_bytes != config.result_cache_bytes) {
+                log("result_cache_bytes", config.result_cache_bytes, *changes.result_cache_bytes);
+                config.result_cache_bytes = *changes.result_cache_bytes;
+                cache.set_max_bytes(static_cast<size_t>(config.result_cache_bytes));
+            }
+            if (!changed) {
+                return;
+            }
+            ++tuning_changes;
+        }
+        // Raised limits may let parked workers or skipped jobs go
+        queue_cv.notify_all();
+    }
+    
+    /// Apply ClientConfig::tuning_file if its contents changed. A missing
+    /// file keeps the current limits; an invalid one is logged and ignored.
+    void reload_tuning_file() {
+        std::ifstream in(config.tuning_file, std::ios::binary);
+        if (!in) {
+            return;
+        }
+        std::string text{std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+        if (text == tuning_text) {
+            return;
+        }
+        tuning_text = std::move(text);
+        try {
+            tune(detail::tuning_from_json(json::parse(tuning_text)), "tuning file");
+        } catch (const std::exception& e) {
+            note(LogLevel::Warning, std::string("tuning file rejected: ") + e.what());
+        }
+    }
+    
+    void start_watcher() {
+        watcher = std::make_unique<Watcher>();
+        watcher->thread = std::thread([this, w = watcher.get()] {
+            constexpr auto kPollInterval = std::chrono::seconds(1);
+            std::unique_lock<std::mutex> lock(w->mutex);
+            while (!w->cv.wait_for(lock, kPollInterval, [w] { return w->stopping; })) {
+                lock.unlock();
+                reload_tuning_file();
+                lock.lock();
+            }
+        });
+    }
+    
+    [[nodiscard]] ClientStats stats() {
+        ClientStats stats;
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex);
+            stats.max_concurrency = config.max_concurrency;
+            stats.memory_budget_bytes = config.memory_budget_bytes;
+            stats.bandwidth = config.bandwidth;
+            stats.buffer_pool_bytes = config.buffer_pool_bytes;
+            stats.result_cache_bytes = config.result_cache_bytes;
+            stats.tuning_changes = tuning_changes;
+            for (size_t i = 0; i < shard_count; ++i) {
+                stats.queued += shards[i].interactive.load(std::memory_order_relaxed) +
+                                shards[i].batch.load(std::memory_order_relaxed);
+            }
+            for (const auto& slot : running) {
+                std::lock_guard<std::mutex> slot_lock(slot->mutex);
+                stats.in_flight += slot->busy ? static_cast<int>(slot->jobs.size()) : 0;
+            }
+            stats.in_flight_bytes = in_flight_bytes.load(std::memory_order_relaxed);
+        }
+        stats.pipelining_disabled = pipelining_disabled.load(std::memory_order_relaxed);
+        
+        auto cached = cache.stats();
+        stats.cache_hits = cached.hits;
+        stats.cache_misses = cached.misses;
+        stats.cache_bytes = static_cast<int64_t>(cached.bytes);
+        stats.cache_rejected = cached.rejected;
+        auto pooled = buffers.stats();
+        stats.buffer_pool_hits = pooled.hits;
+        stats.buffer_pool_misses = pooled.misses;
+        stats.buffer_pool_idle_bytes = static_cast<int64_t>(pooled.idle_bytes);
+        stats.connections_opened = connections_opened.load(std::memory_order_relaxed);
+        stats.fast_open_attempts = fast_open_attempts.load(std::memory_order_relaxed);
+        stats.fast_open_accepted = fast_open_accepted.load(std::memory_order_relaxed);
+        stats.early_data_attempts = early_data_attempts.load(std::memory_order_relaxed);
+        stats.early_data_accepted = early_data_accepted.load(std::memory_order_relaxed);
+        tcp_sampler.fill(stats);
+        degrader.fill(stats);
+        blank.fill(stats);
+        return stats;
+    }
+    
+    // -------------------------------------------------------------------------
+    // Fork handling
+    // -------------------------------------------------------------------------
+    
+    /// Reset a client copied into a child process by fork(). Only the forking
+    /// thread exists in the child: worker threads, their connections and the
+    /// queue belong to the parent. They are abandoned without being touched,
+    /// since destroying them would shut down TLS sessions the parent still
+    /// uses or wait on threads that do not exist. Learned costs, cached
+    /// addresses and prepared requests carry over.
+    ///
+    /// Queued requests stay the parent's to run, so their futures in the
+    /// child fail with HandoverError. Nothing but the queue can reach a
+    /// queued job's promise, which was locked across fork(); the promises
+    /// of running jobs may have been mid-update by a worker that does not
+    /// exist here, and are left alone.
+    void after_fork() {
+        sockets.close_inherited();
+        
+        // Deliberately leaked
+        for (auto& client : idle_http) {
+            (void)client.release();
+        }
+        idle_http.clear();
+        (void)usage_connection.release();
+        for (auto& worker : workers) {
+            (void)new std::thread(std::move(worker));
+        }
+        auto forked = std::make_exception_ptr(HandoverError("Request was queued in the parent before fork()"));
+        for (size_t i = 0; i < shard_count; ++i) {
+            for (auto& job : shards[i].jobs) {
+                job->promise.set_exception(forked);
+            }
+            shards[i].jobs.clear();
+            shards[i].interactive.store(0, std::memory_order_relaxed);
+            shards[i].batch.store(0, std::memory_order_relaxed);
+        }
+        workers.clear();
+        running.clear();
+        worker_count.store(0, std::memory_order_relaxed);
+        workers_started.store(false, std::memory_order_relaxed);
+        idle_workers.store(0, std::memory_order_relaxed);
+        in_flight_bytes.store(0, std::memory_order_relaxed);
+        
+        if (watcher) {
+            (void)watcher.release();
+            start_watcher();
+        }
+        logger.after_fork();
+        note(LogLevel::Info, "after_fork(): connections and queue reset");
+    }
+    
+    /// Take every lock a worker might hold, so fork() copies consistent
+    /// state. Always in this order, which matches normal use. Components
+    /// with internal locks (sockets, cost model, cache, buffer pool and the
+    /// rest) expose lock()/unlock() for this alone; a component with none
+    /// never blocks fork() and is left out.
+    void lock_for_fork() {
+        queue_mutex.lock();
+        for (auto& slot : running) {
+            slot->mutex.lock();
+        }
+        for (size_t i = 0; i < shard_count; ++i) {
+            shards[i].mutex.lock();
+        }
+        cost.lock();
+        sketches.lock();
+        bandwidth.lock();
+        dns.lock();
+        http_mutex.lock();
+        usage_mutex.lock();
+        if (tls) {
+            tls->lock();
+        }
+        sockets.lock();
+        buffers.lock();
+        cache.lock();
+        recorder.lock();
+        logger.lock();
+        if (watcher) {
+            watcher->mutex.lock();
+        }
+    }
+    
+    void unlock_after_fork() {
+        if (watcher) {
+            watcher->mutex.unlock();
+        }
+        logger.unlock();
+        recorder.unlock();
+        cache.unlock();
+        buffers.unlock();
+        sockets.unlock();
+        if (tls) {
+            tls->unlock();
+        }
+        usage_mutex.unlock();
+        http_mutex.unlock();
+        dns.unlock();
+        bandwidth.unlock();
+        sketches.unlock();
+        cost.unlock();
+        for (size_t i = shard_count; i-- > 0;) {
+            shards[i].mutex.unlock();
+        }
+        for (auto it = running.rbegin(); it != running.rend(); ++it) {
+            (*it)->mutex.unlock();
+        }
+        queue_mutex.unlock();
+    }
+    
+    // Clients handed out by Client::shared(), by shared_key(). Expired
+    // entries are swept on the next lookup.
+    static std::mutex& shared_registry_mutex() {
+        static std::mutex mutex;
+        return mutex;
+    }
+    
+    static std::unordered_map<std::string, std::weak_ptr<Client>>& shared_registry() {
+        static std::unordered_map<std::string, std::weak_ptr<Client>> clients;
+        return clients;
+    }
+    
+    // Clients with handle_fork set
+    static std::mutex& fork_registry_mutex() {
+        static std::mutex mutex;
+        return mutex;
+    }
+    
+    static std::vector<Impl*>& fork_registry() {
+        static std::vector<Impl*> clients;
+        return clients;
+    }
+    
+    static void register_fork_handlers(Impl* impl) {
+#ifndef _WIN32
+        static std::once_flag installed;
+        std::call_once(installed, [] {
+            pthread_atfork(&Impl::prepare_fork, &Impl::parent_after_fork, &Impl::child_after_fork);
+        });
+#endif
+        std::lock_guard<std::mutex> lock(fork_registry_mutex());
+        fork_registry().push_back(impl);
+    }
+    
+    static void unregister_fork_handlers(Impl* impl) {
+        std::lock_guard<std::mutex> lock(fork_registry_mutex());
+        auto& clients = fork_registry();
+        clients.erase(std::remove(clients.begin(), clients.end(), impl), clients.end());
+    }
+    
+    // The shared registry constructs clients, and so registers them for
+    // fork handling, under its lock; it is taken first.
+    static void prepare_fork() {
+        shared_registry_mutex().lock();
+        fork_registry_mutex().lock();
+        for (auto* impl : fork_registry()) {
+            impl->lock_for_fork();
+        }
+    }
+    
+    static void parent_after_fork() {
+        for (auto* impl : fork_registry()) {
+            impl->unlock_after_fork();
+        }
+        fork_registry_mutex().unlock();
+        shared_registry_mutex().unlock();
+    }
+    
+    static void child_after_fork() {
+        for (auto* impl : fork_registry()) {
+            impl->unlock_after_fork();
+            impl->after_fork();
+        }
+        fork_registry_mutex().unlock();
+        shared_registry_mutex().unlock();
+    }
+    
+    [[nodiscard]] std::unique_ptr<Job> make_job(ScreenshotOptions options, Priority priority) const {
+        auto report = detail::preflight(options, config, cost);
+        if (!report.ok()) {
+            throw ValidationError(report.errors.front());
+        }
+        auto job = std::make_unique<Job>();
+        job->expected_ms = cost.estimate(options).latency_ms;
+        job->expected_bytes = report.estimated_bytes;
+        job->options = std::move(options);
+        job->priority = priority;
+        job->node = detail::BufferPool::current_node();
+        job->enqueued = Clock::now();
+        return job;
+    }
+    
+    /// Simulate list scheduling of the current backlog plus `batch` over the
+    /// worker pool and return when the last entry of `batch` would finish.
+    /// Queued jobs from all shards run in take_jobs()' order: interactive
+    /// cheapest first, then batch oldest first. Ageing and the memory
+    /// budget are left out.
+    std::chrono::milliseconds estimate_completion(const std::vector<ScreenshotOptions>& batch,
+                                                  Priority priority) {
+        struct Entry {
+            double cost_ms;
+            Clock::time_point enqueued;
+            bool is_new;
+        };
+        std::vector<Entry> interactive;
+        std::vector<Entry> fifo;
+        
+        auto& incoming = priority == Priority::Interactive ? interactive : fifo;
+        auto submitted = Clock::time_point::max();
+        for (const auto& options : batch) {
+            incoming.push_back({cost.estimate(options).latency_ms, submitted, true});
+        }
+        
+        std::priority_queue<double, std::vector<double>, std::greater<double>> free_at;
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex);
+            auto now = Clock::now();
+            size_t slots = worker_limit();
+            for (size_t i = 0; i < slots; ++i) {
+                double remaining = 0;
+                if (i < running.size()) {
+                    std::lock_guard<std::mutex> slot_lock(running[i]->mutex);
+                    if (running[i]->busy) {
+                        double elapsed = std::chrono::duration<double, std::milli>(now - running[i]->started).count();
+                        remaining = std::max(0.0, running[i]->expected_ms - elapsed);
+                    }
+                }
+                free_at.push(remaining);
+            }
+            for (size_t i = 0; i < shard_count; ++i) {
+                std::lock_guard<std::mutex> shard_lock(shards[i].mutex);
+                for (const auto& job : shards[i].jobs) {
+                    auto& bucket = job->priority == Priority::Interactive ? interactive : fifo;
+                    bucket.push_back({job->expected_ms, job->enqueued, false});
+                }
+            }
+        }
+        
+        std::stable_sort(interactive.begin(), interactive.end(),
+                         [](const Entry& a, const Entry& b) { return a.cost_ms < b.cost_ms; });
+        std::stable_sort(fifo.begin(), fifo.end(),
+                         [](const Entry& a, const Entry& b) { return a.enqueued < b.enqueued; });
+        
+        double finish_ms = 0;
+        auto schedule = [&](const Entry& entry) {
+            double start = free_at.top();
+            free_at.pop();
+            free_at.push(start + entry.cost_ms);
+            if (entry.is_new) {
+                finish_ms = std::max(finish_ms, start + entry.cost_ms);
+            }
+        };
+        std::for_each(interactive.begin(), interactive.end(), schedule);
+        std::for_each(fifo.begin(), fifo.end(), schedule);
+        
+        return std::chrono::milliseconds(static_cast<int64_t>(finish_ms));
+    }
+};
+
+// =============================================================================
+// Client Implementation
+// =============================================================================
+
+Client::Client(std::string_view api_key)
+    : Client(ClientConfig{std::string(api_key)}) {}
+
+Client::Client(ClientConfig config) {
+    if (config.api_key.empty()) {
+        throw ValidationError("API key is required");
+    }
+    impl_ = std::make_unique<Impl>(std::move(config));
 }
 
-Usage Client::usage() {
-    auto res = impl_->http->Get("/v1/usage", impl_->make_headers(false));
+Client::~Client() = default;
+
+std::shared_ptr<Client> Client::shared(const ClientConfig& config) {
+    auto key = shared_key(config);
+    std::lock_guard<std::mutex> lock(Impl::shared_registry_mutex());
+    auto& clients = Impl::shared_registry();
+    for (auto it = clients.begin(); it != clients.end();) {
+        it = it->second.expired() ? clients.erase(it) : std::next(it);
+    }
+    if (auto it = clients.find(key); it != clients.end()) {
+        if (auto client = it->second.lock()) {
+            return client;
+        }
+    }
+    auto client = std::make_shared<Client>(config);
+    clients[key] = client;
+    return client;
+}
+
+Client::Client(Client&&) noexcept = default;
+Client& Client::operator=(Client&&) noexcept = default;
+
+ScreenshotResult Client::screenshot(const ScreenshotOptions& options) {
+    impl_->reject_if_draining();
+    impl_->validate(options);
+    if (auto hit = impl_->cached(options)) {
+        return std::move(*hit);
+    }
+    auto http = impl_->acquire_http();
+    auto result = impl_->perform(*http, options, Priority::Interactive, detail::BufferPool::current_node());
+    impl_->release_http(std::move(http));
+    return result;
+}
+
+ScreenshotResult Client::screenshot(const ScreenshotOptions& options,
+                                    const ProgressHandler& on_progress,
+                                    size_t granularity_bytes) {
+    impl_->reject_if_draining();
+    impl_->validate(options);
+    if (auto hit = impl_->cached(options)) {
+        return std::move(*hit);     // Nothing is transferred, so no progress is reported
+    }
+    auto http = impl_->acquire_http();
+    auto result = impl_->perform(*http, options, Priority::Interactive, detail::BufferPool::current_node(),
+                                 on_progress, granularity_bytes);
+    impl_->release_http(std::move(http));
+    return result;
+}
+
+uint64_t Client::screenshot_to(const ScreenshotOptions& options, ResultSink& sink) {
+    impl_->reject_if_draining();
+    if (options.store.value_or(false)) {
+        throw ValidationError("screenshot_to() streams the image itself; store must not be set");
+    }
+    impl_->validate(options);
+    auto http = impl_->acquire_http();
+    auto written = impl_->tracked(options, Priority::Interactive,
+                                  [&] { return impl_->stream_screenshot(*http, options, sink); });
+    impl_->release_http(std::move(http));
+    return written;
+}
+
+std::future<ScreenshotResult> Client::submit(ScreenshotOptions options, Priority priority) {
+    auto job = impl_->make_job(std::move(options), priority);
+    auto future = job->promise.get_future();
+    
+    std::vector<std::unique_ptr<Impl::Job>> jobs;
+    jobs.push_back(std::move(job));
+    impl_->enqueue(std::move(jobs));
+    return future;
+}
+
+std::vector<std::future<ScreenshotResult>> Client::submit_batch(
+    std::vector<ScreenshotOptions> batch, Priority priority) {
+    std::vector<std::unique_ptr<Impl::Job>> jobs;
+    std::vector<std::future<ScreenshotResult>> futures;
+    jobs.reserve(batch.size());
+    futures.reserve(batch.size());
     
-    impl_->check_response(res, "Usage request failed");
+    for (auto& options : batch) {
+        jobs.push_back(impl_->make_job(std::move(options), priority));
+        futures.push_back(jobs.back()->promise.get_future());
+    }
+    impl_->enqueue(std::move(jobs));
+    return futures;
+}
+
+DrainResult Client::drain(std::chrono::steady_clock::time_point deadline) {
+    return impl_->drain(deadline);
+}
+
+std::vector<std::future<ScreenshotResult>> Client::resume(std::string_view handover) {
+    std::vector<std::unique_ptr<Impl::Job>> jobs;
+    std::vector<std::future<ScreenshotResult>> futures;
+    for (auto& [options, priority] : parse_handover(handover)) {
+        jobs.push_back(impl_->make_job(std::move(options), priority));
+        futures.push_back(jobs.back()->promise.get_future());
+    }
+    if (!jobs.empty()) {
+        impl_->enqueue(std::move(jobs));
+    }
+    return futures;
+}
+
+void Client::recycle(std::vector<uint8_t> buffer) {
+    impl_->buffers.release(std::move(buffer));
+}
+
+void Client::recycle(ScreenshotResult result) {
+    if (result.bytes_ && result.bytes_.use_count() == 1) {
+        impl_->buffers.release(result.take_bytes());
+    }
+}
+
+void Client::tune(const Tuning& changes) {
+    impl_->tune(changes, "tune()");
+}
+
+ClientStats Client::stats() const {
+    return impl_->stats();
+}
+
+HostReport Client::host_report(bool reset) {
+    return impl_->sketches.report(reset);
+}
+
+std::vector<FlightEvent> Client::flight_recorder() const {
+    return impl_->recorder.events();
+}
+
+void Client::after_fork() {
+    impl_->after_fork();
+}
+
+PreflightReport Client::preflight(const ScreenshotOptions& options) const {
+    return detail::preflight(options, impl_->config, impl_->cost);
+}
+
+CostEstimate Client::estimate(const ScreenshotOptions& options) const {
+    auto e = impl_->cost.estimate(options);
+    return CostEstimate{
+        std::chrono::milliseconds(static_cast<int64_t>(e.latency_ms)),
+        std::chrono::milliseconds(static_cast<int64_t>(e.stddev_ms)),
+        detail::saturate_estimate(e.bytes),
+        e.samples
+    };
+}
+
+std::chrono::milliseconds Client::estimate_batch(
+    const std::vector<ScreenshotOptions>& batch, Priority priority) const {
+    return impl_->estimate_completion(batch, priority);
+}
+
+Usage Client::usage() {
+    std::string body;
+    if (impl_->usage_request.empty()) {
+        auto http = impl_->acquire_http();
+        auto res = http->Get("/v1/usage", impl_->usage_headers);
+        impl_->check_response(res, "Usage request failed");
+        impl_->release_http(std::move(http));
+        body = std::move(res->body);
+    } else {
+        auto res = impl_->fetch_usage();
+        impl_->check_status(res.status, res.body, "Usage request failed");
+        body = std::move(res.body);
+    }
     
     try {
-        auto response = json::parse(res->body);
+        auto response = json::parse(body);
         
         Usage usage;
         usage.screenshots_taken = response.at("screenshots_taken").get<int>();
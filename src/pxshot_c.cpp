@@ -0,0 +1,359 @@
+// Pxshot C++ SDK - C interface
+
+#include "pxshot/pxshot.h"
+#include "pxshot/pxshot.hpp"
+#include "request_json.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <memory>
+#include <new>
+#include <string>
+
+using json = nlohmann::json;
+
+struct pxshot_client {
+    std::shared_ptr<pxshot::Client> client;
+};
+
+struct pxshot_request {
+    std::future<pxshot::ScreenshotResult> future;
+    bool delivered = false;
+};
+
+struct pxshot_result {
+    pxshot::ScreenshotResult result;
+};
+
+namespace {
+
+thread_local std::string last_error;
+
+pxshot_status fail(pxshot_status status, const char* message) noexcept {
+    try {
+        last_error = message;
+    } catch (...) {
+        last_error.clear();
+    }
+    return status;
+}
+
+/// Run `body`, translating any exception into a status and last error
+template <typename F>
+pxshot_status guarded(F&& body) noexcept {
+    try {
+        last_error.clear();
+        return body();
+    } catch (const pxshot::ValidationError& e) {
+        return fail(PXSHOT_ERROR_VALIDATION, e.what());
+    } catch (const pxshot::CancelledError& e) {
+        return fail(PXSHOT_ERROR_CANCELLED, e.what());
+    } catch (const pxshot::HandoverError& e) {
+        return fail(PXSHOT_ERROR_HANDOVER, e.what());
+    } catch (const pxshot::ApiError& e) {
+        try {
+            return fail(PXSHOT_ERROR_API, (e.error_code + ": " + e.what()).c_str());
+        } catch (...) {
+            return fail(PXSHOT_ERROR_API, e.what());
+        }
+    } catch (const pxshot::HttpError& e) {
+        return fail(PXSHOT_ERROR_HTTP, e.what());
+    } catch (const json::exception& e) {
+        return fail(PXSHOT_ERROR_INVALID_ARGUMENT, e.what());
+    } catch (const std::bad_alloc&) {
+        return fail(PXSHOT_ERROR_OUT_OF_MEMORY, "Out of memory");
+    } catch (const std::exception& e) {
+        return fail(PXSHOT_ERROR, e.what());
+    } catch (...) {
+        return fail(PXSHOT_ERROR, "Unknown error");
+    }
+}
+
+pxshot::ScreenshotOptions parse_options(const char* options_json) {
+    auto body = json::parse(options_json);
+    if (!body.is_object()) {
+        throw pxshot::ValidationError("Screenshot options must be a JSON object");
+    }
+    return pxshot::detail::from_request_body(body);
+}
+
+pxshot::ClientConfig parse_config(const char* config_json) {
+    auto doc = json::parse(config_json);
+    if (!doc.is_object()) {
+        throw pxshot::ValidationError("Client configuration must be a JSON object");
+    }
+    
+    pxshot::ClientConfig config;
+    config.api_key = doc.at("api_key").get<std::string>();
+    config.base_url = doc.value("base_url", config.base_url);
+    config.timeout_seconds = doc.value("timeout_seconds", config.timeout_seconds);
+    if (auto it = doc.find("user_agent"); it != doc.end()) {
+        config.user_agent = it->get<std::string>();
+    }
+    config.max_concurrency = doc.value("max_concurrency", config.max_concurrency);
+    config.adaptive_timeouts = doc.value("adaptive_timeouts", config.adaptive_timeouts);
+    config.max_output_pixels = doc.value("max_output_pixels", config.max_output_pixels);
+    config.strict_preflight = doc.value("strict_preflight", config.strict_preflight);
+    config.memory_budget_bytes = doc.value("memory_budget_bytes", config.memory_budget_bytes);
+    config.pipeline_depth = doc.value("pipeline_depth", config.pipeline_depth);
+    if (auto it = doc.find("bandwidth"); it != doc.end()) {
+        config.bandwidth = pxshot::detail::bandwidth_from_json(*it);
+    }
+    config.buffer_pool_bytes = doc.value("buffer_pool_bytes", config.buffer_pool_bytes);
+    config.result_cache_bytes = doc.value("result_cache_bytes", config.result_cache_bytes);
+    if (auto it = doc.find("result_cache_ttl"); it != doc.end()) {
+        config.result_cache_ttl = std::chrono::seconds(it->get<int64_t>());
+    }
+    if (auto it = doc.find("result_cache_policy"); it != doc.end()) {
+        config.result_cache_policy = pxshot::detail::cache_policy_from_json(*it);
+    }
+    config.proxy = doc.value("proxy", config.proxy);
+    config.tcp_info_sample_rate = doc.value("tcp_info_sample_rate", config.tcp_info_sample_rate);
+    config.tcp_fast_open = doc.value("tcp_fast_open", config.tcp_fast_open);
+    config.tls_early_data = doc.value("tls_early_data", config.tls_early_data);
+    if (auto it = doc.find("degradation"); it != doc.end()) {
+        config.degradation = pxshot::detail::degradation_from_json(*it);
+    }
+    if (auto it = doc.find("blank_detection"); it != doc.end()) {
+        config.blank_detection = pxshot::detail::blank_detection_from_json(*it);
+    }
+    config.tuning_file = doc.value("tuning_file", config.tuning_file);
+    config.handle_fork = doc.value("handle_fork", config.handle_fork);
+    return config;
+}
+
+pxshot_status deliver(pxshot_request* request, pxshot_result** out) {
+    request->delivered = true;
+    *out = new pxshot_result{request->future.get()};
+    return PXSHOT_OK;
+}
+
+void release_buffer(pxshot_buffer* buffer) {
+    if (!buffer) {
+        return;
+    }
+    delete static_cast<std::shared_ptr<const std::vector<uint8_t>>*>(buffer->owner);
+    buffer->data = nullptr;
+    buffer->size = 0;
+    buffer->owner = nullptr;
+}
+
+} // namespace
+
+extern "C" {
+
+// =============================================================================
+// Library
+// =============================================================================
+
+uint32_t pxshot_abi_version(void) {
+    return PXSHOT_ABI_VERSION;
+}
+
+const char* pxshot_version(void) {
+    return pxshot::VERSION;
+}
+
+const char* pxshot_last_error(void) {
+    return last_error.c_str();
+}
+
+// =============================================================================
+// Client
+// =============================================================================
+
+pxshot_status pxshot_client_new(const char* api_key, pxshot_client** out) {
+    return guarded([&] {
+        if (!api_key || !out) {
+            return fail(PXSHOT_ERROR_INVALID_ARGUMENT, "Null argument");
+        }
+        *out = new pxshot_client{std::make_shared<pxshot::Client>(api_key)};
+        return PXSHOT_OK;
+    });
+}
+
+pxshot_status pxshot_client_new_with_config(const char* config_json, pxshot_client** out) {
+    return guarded([&] {
+        if (!config_json || !out) {
+            return fail(PXSHOT_ERROR_INVALID_ARGUMENT, "Null argument");
+        }
+        *out = new pxshot_client{std::make_shared<pxshot::Client>(parse_config(config_json))};
+        return PXSHOT_OK;
+    });
+}
+
+pxshot_status pxshot_client_new_shared(const char* config_json, pxshot_client** out) {
+    return guarded([&] {
+        if (!config_json || !out) {
+            return fail(PXSHOT_ERROR_INVALID_ARGUMENT, "Null argument");
+        }
+        *out = new pxshot_client{pxshot::Client::shared(parse_config(config_json))};
+        return PXSHOT_OK;
+    });
+}
+
+void pxshot_client_free(pxshot_client* client) {
+    delete client;
+}
+
+void pxshot_client_after_fork(pxshot_client* client) {
+    if (client) {
+        (void)guarded([&] {
+            client->client->after_fork();
+            return PXSHOT_OK;
+        });
+    }
+}
+
+pxshot_status pxshot_client_tune(pxshot_client* client, const char* tuning_json) {
+    return guarded([&] {
+        if (!client || !tuning_json) {
+            return fail(PXSHOT_ERROR_INVALID_ARGUMENT, "Null argument");
+        }
+        client->client->tune(pxshot::detail::tuning_from_json(json::parse(tuning_json)));
+        return PXSHOT_OK;
+    });
+}
+
+pxshot_status pxshot_client_screenshot(pxshot_client* client, const char* options_json,
+                                       pxshot_result** out) {
+    return guarded([&] {
+        if (!client || !options_json || !out) {
+            return fail(PXSHOT_ERROR_INVALID_ARGUMENT, "Null argument");
+        }
+        *out = new pxshot_result{client->client->screenshot(parse_options(options_json))};
+        return PXSHOT_OK;
+    });
+}
+
+pxshot_status pxshot_client_submit(pxshot_client* client, const char* options_json,
+                                   pxshot_priority priority, pxshot_request** out) {
+    return guarded([&] {
+        if (!client || !options_json || !out) {
+            return fail(PXSHOT_ERROR_INVALID_ARGUMENT, "Null argument");
+        }
+        auto p = priority == PXSHOT_PRIORITY_BATCH ? pxshot::Priority::Batch
+                                                   : pxshot::Priority::Interactive;
+        auto future = client->client->submit(parse_options(options_json), p);
+        *out = new pxshot_request{std::move(future)};
+        return PXSHOT_OK;
+    });
+}
+
+// =============================================================================
+// Requests
+// =============================================================================
+
+pxshot_status pxshot_request_poll(pxshot_request* request, pxshot_result** out) {
+    return pxshot_request_wait(request, 0, out);
+}
+
+pxshot_status pxshot_request_wait(pxshot_request* request, int64_t timeout_ms,
+                                  pxshot_result** out) {
+    return guarded([&] {
+        if (!request || !out) {
+            return fail(PXSHOT_ERROR_INVALID_ARGUMENT, "Null argument");
+        }
+        if (request->delivered) {
+            return fail(PXSHOT_ERROR_INVALID_ARGUMENT, "Request outcome was already delivered");
+        }
+        if (timeout_ms < 0) {
+            request->future.wait();
+        } else if (request->future.wait_for(std::chrono::milliseconds(timeout_ms)) !=
+                   std::future_status::ready) {
+            return PXSHOT_PENDING;
+        }
+        return deliver(request, out);
+    });
+}
+
+void pxshot_request_free(pxshot_request* request) {
+    delete request;
+}
+
+// =============================================================================
+// Results
+// =============================================================================
+
+int pxshot_result_is_stored(const pxshot_result* result) {
+    return result && result->result.is_stored() ? 1 : 0;
+}
+
+uint32_t pxshot_result_degradation(const pxshot_result* result) {
+    if (!result) {
+        return 0;
+    }
+    const auto& degradation = result->result.degradation();
+    return (degradation.device_scale_factor ? PXSHOT_DEGRADED_DEVICE_SCALE_FACTOR : 0u) |
+           (degradation.full_page ? PXSHOT_DEGRADED_FULL_PAGE : 0u) |
+           (degradation.wait_until ? PXSHOT_DEGRADED_WAIT_UNTIL : 0u) |
+           (degradation.wait_for_timeout ? PXSHOT_DEGRADED_WAIT_FOR_TIMEOUT : 0u);
+}
+
+pxshot_blank_verdict pxshot_result_blank(const pxshot_result* result) {
+    if (!result) {
+        return PXSHOT_BLANK_NOT_CHECKED;
+    }
+    switch (result->result.blank().verdict) {
+        case pxshot::BlankVerdict::NotChecked: return PXSHOT_BLANK_NOT_CHECKED;
+        case pxshot::BlankVerdict::Content: return PXSHOT_BLANK_CONTENT;
+        case pxshot::BlankVerdict::Blank: return PXSHOT_BLANK_BLANK;
+    }
+    return PXSHOT_BLANK_NOT_CHECKED;
+}
+
+pxshot_status pxshot_result_stored(const pxshot_result* result, pxshot_stored* out) {
+    return guarded([&] {
+        if (!result || !out) {
+            return fail(PXSHOT_ERROR_INVALID_ARGUMENT, "Null argument");
+        }
+        if (!result->result.is_stored()) {
+            return fail(PXSHOT_ERROR_INVALID_ARGUMENT, "Screenshot was not stored");
+        }
+        const auto& stored = result->result.stored();
+        *out = pxshot_stored{stored.url.c_str(), stored.expires_at.c_str(), stored.width,
+                             stored.height, stored.size_bytes};
+        return PXSHOT_OK;
+    });
+}
+
+pxshot_status pxshot_result_bytes(const pxshot_result* result, const uint8_t** data, size_t* size) {
+    return guarded([&] {
+        if (!result || !data || !size) {
+            return fail(PXSHOT_ERROR_INVALID_ARGUMENT, "Null argument");
+        }
+        if (result->result.is_stored()) {
+            return fail(PXSHOT_ERROR_INVALID_ARGUMENT, "Screenshot was stored");
+        }
+        const auto& bytes = result->result.bytes();
+        *data = bytes.data();
+        *size = bytes.size();
+        return PXSHOT_OK;
+    });
+}
+
+pxshot_status pxshot_result_export(pxshot_result* result, pxshot_buffer* out) {
+    return guarded([&] {
+        if (!result || !out) {
+            return fail(PXSHOT_ERROR_INVALID_ARGUMENT, "Null argument");
+        }
+        if (result->result.is_stored()) {
+            return fail(PXSHOT_ERROR_INVALID_ARGUMENT, "Screenshot was stored");
+        }
+        // The buffer gains a reference and the result gives up its own; no
+        // bytes move, even if a cached copy of the result shares them
+        auto* owner = new std::shared_ptr<const std::vector<uint8_t>>(result->result.shared_bytes());
+        {
+            auto emptied = std::move(result->result);
+        }
+        const auto* bytes = owner->get();
+        *out = pxshot_buffer{bytes ? bytes->data() : nullptr, bytes ? bytes->size() : 0, &release_buffer, owner};
+        return PXSHOT_OK;
+    });
+}
+
+void pxshot_result_free(pxshot_result* result) {
+    delete result;
+}
+
+} // extern "C"
@@ -0,0 +1,592 @@
+// Pxshot C++ SDK - Minimal HTTP/1.1 connection
+
+#include "raw_connection.hpp"
+#include "pxshot/pxshot.hpp"
+#include "probes.hpp"
+
+#include <openssl/err.h>
+#include <openssl/evp.h>
+#include <openssl/ssl.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+
+#ifndef _WIN32
+#include <csignal>
+#include <fcntl.h>
+#include <pthread.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#endif
+
+namespace pxshot {
+namespace detail {
+
+namespace {
+
+constexpr size_t kMaxHeaderBytes = 64 * 1024;
+
+using Clock = std::chrono::steady_clock;
+
+std::chrono::microseconds since(Clock::time_point start) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start);
+}
+
+std::string lower(std::string s) {
+    std::transform(s.begin(), s.end(), s.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return s;
+}
+
+std::string trim(std::string_view s) {
+    while (!s.empty() && (s.front() == ' ' || s.front() == '\t')) {
+        s.remove_prefix(1);
+    }
+    while (!s.empty() && (s.back() == ' ' || s.back() == '\t' || s.back() == '\r')) {
+        s.remove_suffix(1);
+    }
+    return std::string(s);
+}
+
+/// Leading number of `text` in `base`, which must be followed by nothing
+/// or by one of `terminators`. Throws HttpError naming `what` otherwise,
+/// so a malformed response cannot escape as std::invalid_argument.
+size_t parse_size(std::string_view text, int base, std::string_view terminators, const char* what) {
+    size_t value = 0;
+    auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value, base);
+    bool complete = end == text.data() + text.size() || terminators.find(*end) != std::string_view::npos;
+    if (error != std::errc() || end == text.data() || !complete) {
+        throw HttpError(0, std::string("Malformed ") + what);
+    }
+    return value;
+}
+
+std::string ssl_error_string() {
+    char buf[256];
+    unsigned long code = ERR_get_error();
+    if (code == 0) {
+        return "unknown TLS error";
+    }
+    ERR_error_string_n(code, buf, sizeof(buf));
+    return buf;
+}
+
+#ifndef _WIN32
+/// OpenSSL writes through write(2), which raises SIGPIPE when the peer has
+/// gone away. Block it for the current thread and swallow any instance the
+/// guarded write generated, leaving the process disposition untouched.
+class SigpipeGuard {
+public:
+    SigpipeGuard() {
+        sigset_t pipe_set;
+        sigemptyset(&pipe_set);
+        sigaddset(&pipe_set, SIGPIPE);
+        sigset_t pending;
+        sigpending(&pending);
+        was_pending_ = sigismember(&pending, SIGPIPE) == 1;
+        pthread_sigmask(SIG_BLOCK, &pipe_set, &old_mask_);
+    }
+    
+    ~SigpipeGuard() {
+        if (!was_pending_) {
+            sigset_t pipe_set;
+            sigemptyset(&pipe_set);
+            sigaddset(&pipe_set, SIGPIPE);
+            timespec zero{};
+            while (sigtimedwait(&pipe_set, nullptr, &zero) == SIGPIPE) {
+            }
+        }
+        pthread_sigmask(SIG_SETMASK, &old_mask_, nullptr);
+    }
+    
+    SigpipeGuard(const SigpipeGuard&) = delete;
+    SigpipeGuard& operator=(const SigpipeGuard&) = delete;
+
+private:
+    sigset_t old_mask_;
+    bool was_pending_ = false;
+};
+#endif
+
+} // namespace
+
+std::string Endpoint::authority() const {
+    bool default_port = (tls() && port == 443) || (!tls() && port == 80);
+    return default_port ? host : host + ":" + std::to_string(port);
+}
+
+Endpoint parse_endpoint(std::string_view base_url) {
+    auto scheme_end = base_url.find("://");
+    if (scheme_end == std::string_view::npos) {
+        throw Error("Base URL must include a scheme: " + std::string(base_url));
+    }
+    
+    Endpoint endpoint;
+    endpoint.scheme = lower(std::string(base_url.substr(0, scheme_end)));
+    if (endpoint.scheme != "http" && endpoint.scheme != "https") {
+        throw Error("Unsupported base URL scheme: " + endpoint.scheme);
+    }
+    
+    auto authority = base_url.substr(scheme_end + 3);
+    authority = authority.substr(0, authority.find('/'));
+    auto colon = authority.rfind(':');
+    if (colon != std::string_view::npos && authority.find(']', colon) == std::string_view::npos) {
+        endpoint.host = std::string(authority.substr(0, colon));
+        try {
+            endpoint.port = std::stoi(std::string(authority.substr(colon + 1)));
+        } catch (const std::exception&) {
+            throw Error("Invalid port in base URL: " + std::string(base_url));
+        }
+    } else {
+        endpoint.host = std::string(authority);
+        endpoint.port = endpoint.tls() ? 443 : 80;
+    }
+    if (endpoint.host.size() > 2 && endpoint.host.front() == '[') {
+        endpoint.host = endpoint.host.substr(1, endpoint.host.size() - 2);
+    }
+    if (endpoint.host.empty()) {
+        throw Error("Base URL has no host: " + std::string(base_url));
+    }
+    return endpoint;
+}
+
+std::string Proxy::authorization() const {
+    if (username.empty()) {
+        return {};
+    }
+    auto credentials = username + ":" + password;
+    std::string encoded(4 * ((credentials.size() + 2) / 3) + 1, '\0');
+    int n = EVP_EncodeBlock(reinterpret_cast<unsigned char*>(encoded.data()),
+                            reinterpret_cast<const unsigned char*>(credentials.data()),
+                            static_cast<int>(credentials.size()));
+    encoded.resize(static_cast<size_t>(n));
+    return "Basic " + encoded;
+}
+
+Proxy parse_proxy(std::string_view url) {
+    Proxy proxy;
+    auto scheme_end = url.find("://");
+    auto authority_start = scheme_end == std::string_view::npos ? 0 : scheme_end + 3;
+    auto at = url.substr(0, url.find('/', authority_start)).rfind('@');
+    std::string without_credentials(url);
+    if (at != std::string_view::npos && at > authority_start) {
+        auto userinfo = url.substr(authority_start, at - authority_start);
+        auto colon = userinfo.find(':');
+        proxy.username = std::string(userinfo.substr(0, colon));
+        if (colon != std::string_view::npos) {
+            proxy.password = std::string(userinfo.substr(colon + 1));
+        }
+        without_credentials = std::string(url.substr(0, authority_start)) + std::string(url.substr(at + 1));
+    }
+    proxy.endpoint = parse_endpoint(without_credentials);
+    if (proxy.endpoint.tls()) {
+        throw Error("Proxy must be an http:// URL; tunnels to https servers are encrypted end to end");
+    }
+    return proxy;
+}
+
+TlsContext::TlsContext() {
+    ctx_ = SSL_CTX_new(TLS_client_method());
+    if (!ctx_) {
+        throw HttpError(0, "TLS setup failed: " + ssl_error_string());
+    }
+    SSL_CTX_set_min_proto_version(ctx_, TLS1_2_VERSION);
+    SSL_CTX_set_default_verify_paths(ctx_);
+    SSL_CTX_set_verify(ctx_, SSL_VERIFY_PEER, nullptr);
+    
+    // Clients look sessions up themselves, so OpenSSL's own store is unused
+    SSL_CTX_set_session_cache_mode(ctx_, SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL_STORE);
+    SSL_CTX_sess_set_new_cb(ctx_, &TlsContext::on_new_session);
+    SSL_CTX_set_app_data(ctx_, this);
+}
+
+TlsContext::~TlsContext() {
+    SSL_SESSION_free(session_);
+    SSL_CTX_free(ctx_);
+}
+
+SSL_SESSION* TlsContext::session() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (session_) {
+        SSL_SESSION_up_ref(session_);
+    }
+    return session_;
+}
+
+int TlsContext::on_new_session(SSL* ssl, SSL_SESSION* session) {
+    auto* self = static_cast<TlsContext*>(SSL_CTX_get_app_data(SSL_get_SSL_CTX(ssl)));
+    SSL_SESSION* replaced = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(self->mutex_);
+        replaced = self->session_;
+        self->session_ = session;
+    }
+    SSL_SESSION_free(replaced);
+    return 1;       // The reference OpenSSL passed in is kept
+}
+
+#ifdef _WIN32
+
+RawConnection::RawConnection(const Endpoint&, int, const TlsContext*, const std::vector<std::string>&,
+                             const Proxy*, const FastConnect&) {
+    throw Error("HTTP pipelining is not supported on this platform");
+}
+
+RawConnection::~RawConnection() = default;
+
+void RawConnection::write(std::string_view) {}
+
+size_t RawConnection::read_some(char*, size_t) { return 0; }
+
+void RawConnection::interrupt() {}
+
+bool RawConnection::fast_open_accepted() const { return false; }
+
+void RawConnection::open_tunnel(const Endpoint&, const Proxy&) {}
+
+#else
+
+RawConnection::RawConnection(const Endpoint& endpoint, int timeout_seconds, const TlsContext* tls,
+                             const std::vector<std::string>& addresses, const Proxy* proxy,
+                             const FastConnect& fast) {
+    if (endpoint.tls() && !tls) {
+        throw Error("TLS context required for " + endpoint.authority());
+    }
+    const Endpoint& peer = proxy ? proxy->endpoint : endpoint;
+    auto started = Clock::now();
+    
+    auto try_connect = [&](const addrinfo* ai) {
+        int fd = ::socket(ai->ai_family, ai->ai_socktype | SOCK_CLOEXEC, ai->ai_protocol);
+        if (fd < 0) {
+            return;
+        }
+
+#ifdef TCP_FASTOPEN_CONNECT
+        if (fast.tcp_fast_open) {
+            // connect() returns at once and the SYN leaves with the first write
+            int one = 1;
+            fast_open_ = setsockopt(fd, IPPROTO_TCP, TCP_FASTOPEN_CONNECT, &one, sizeof(one)) == 0;
+        }
+#endif
+
+        // Non-blocking connect so the connect timeout applies
+        int flags = fcntl(fd, F_GETFL, 0);
+        fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+        int rc = ::connect(fd, ai->ai_addr, ai->ai_addrlen);
+        if (rc < 0 && errno == EINPROGRESS) {
+            pollfd pfd{fd, POLLOUT, 0};
+            int err = 0;
+            socklen_t len = sizeof(err);
+            if (poll(&pfd, 1, timeout_seconds * 1000) == 1 &&
+                getsockopt(fd, SOL_SOCKET, SO_ERROR, &err, &len) == 0 && err == 0) {
+                rc = 0;
+            }
+        }
+        if (rc != 0) {
+            ::close(fd);
+            return;
+        }
+        fcntl(fd, F_SETFL, flags);
+        fd_ = fd;
+    };
+    
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    auto port = std::to_string(peer.port);
+    
+    // Cached numeric addresses skip the resolver
+    for (size_t i = 0; i < addresses.size() && fd_ < 0; ++i) {
+        hints.ai_flags = AI_NUMERICHOST;
+        addrinfo* numeric = nullptr;
+        if (getaddrinfo(addresses[i].c_str(), port.c_str(), &hints, &numeric) == 0) {
+            try_connect(numeric);
+            freeaddrinfo(numeric);
+        }
+    }
+    
+    // Resolve if there were none, or none of them answered
+    if (fd_ < 0) {
+        hints.ai_flags = 0;
+        addrinfo* resolved = nullptr;
+        if (int rc = getaddrinfo(peer.host.c_str(), port.c_str(), &hints, &resolved); rc != 0) {
+            throw HttpError(0, "Failed to resolve " + peer.host + ": " + gai_strerror(rc));
+        }
+        for (auto* ai = resolved; ai && fd_ < 0; ai = ai->ai_next) {
+            try_connect(ai);
+        }
+        freeaddrinfo(resolved);
+    }
+    
+    if (fd_ < 0) {
+        throw HttpError(0, "Failed to connect to " + peer.authority());
+    }
+    
+    int one = 1;
+    setsockopt(fd_, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    timeval tv{};
+    tv.tv_sec = timeout_seconds;
+    setsockopt(fd_, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    setsockopt(fd_, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+    
+    if (proxy) {
+        try {
+            open_tunnel(endpoint, *proxy);
+        } catch (...) {
+            ::close(fd_);
+            throw;
+        }
+        timings_.proxy_connect = since(started);
+    } else {
+        timings_.connect = since(started);
+    }
+    
+    if (!endpoint.tls()) {
+        return;
+    }
+    
+    auto handshake_started = Clock::now();
+    ssl_ = SSL_new(tls->get());
+    SSL_set_fd(ssl_, fd_);
+    SSL_set_tlsext_host_name(ssl_, endpoint.host.c_str());
+    SSL_set1_host(ssl_, endpoint.host.c_str());
+    auto fail = [&] {
+        auto reason = ssl_error_string();
+        SSL_free(ssl_);
+        ::close(fd_);
+        throw HttpError(0, "TLS handshake with " + endpoint.host + " failed: " + reason);
+    };
+    
+    if (auto* session = tls->session()) {
+        SSL_set_session(ssl_, session);
+        bool early = !fast.early_data.empty() &&
+                     SSL_SESSION_get_max_early_data(session) >= fast.early_data.size();
+        SSL_SESSION_free(session);
+        if (early) {
+            SigpipeGuard guard;
+            size_t written = 0;
+            if (SSL_write_early_data(ssl_, fast.early_data.data(), fast.early_data.size(), &written) != 1) {
+                fail();
+            }
+            early_data_ = EarlyData::Rejected;      // Until the server says otherwise
+        }
+    }
+    if (SSL_connect(ssl_) != 1) {
+        fail();
+    }
+    if (early_data_ == EarlyData::Rejected && SSL_get_early_data_status(ssl_) == SSL_EARLY_DATA_ACCEPTED) {
+        early_data_ = EarlyData::Accepted;
+    }
+    timings_.tls_handshake = since(handshake_started);
+    PXSHOT_PROBE(tls_done, fd_, static_cast<long long>(timings_.tls_handshake.count()));
+}
+
+void RawConnection::open_tunnel(const Endpoint& endpoint, const Proxy& proxy) {
+    // The port is always given: CONNECT takes host:port
+    auto target = endpoint.host.find(':') != std::string::npos ? "[" + endpoint.host + "]" : endpoint.host;
+    target += ":" + std::to_string(endpoint.port);
+    
+    std::string request = "CONNECT " + target + " HTTP/1.1\r\nHost: " + target + "\r\n";
+    if (auto authorization = proxy.authorization(); !authorization.empty()) {
+        request += "Proxy-Authorization: " + authorization + "\r\n";
+    }
+    request += "\r\n";
+    write(request);
+    
+    // A successful reply has no body; the tunnel starts after the headers
+    auto status_line = read_line();
+    int status = status_line.size() >= 12 ? std::atoi(status_line.c_str() + 9) : 0;
+    while (!read_line().empty()) {
+    }
+    if (status / 100 != 2) {
+        throw HttpError(status, "Proxy " + proxy.endpoint.authority() + " refused CONNECT to " + target +
+                                    ": " + (status ? "HTTP " + std::to_string(status) : status_line));
+    }
+}
+
+RawConnection::~RawConnection() {
+    if (ssl_) {
+        SigpipeGuard guard;
+        SSL_shutdown(ssl_);
+        SSL_free(ssl_);
+    }
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+}
+
+void RawConnection::write(std::string_view data) {
+    SigpipeGuard guard;
+    while (!data.empty()) {
+        long n = ssl_ ? SSL_write(ssl_, data.data(), static_cast<int>(data.size()))
+                      : ::send(fd_, data.data(), data.size(), MSG_NOSIGNAL);
+        if (n <= 0) {
+            if (!ssl_ && n < 0 && errno == EINTR) {
+                continue;
+            }
+            throw HttpError(0, "Connection write failed");
+        }
+        data.remove_prefix(static_cast<size_t>(n));
+    }
+}
+
+size_t RawConnection::read_some(char* out, size_t capacity) {
+    for (;;) {
+        long n = ssl_ ? SSL_read(ssl_, out, static_cast<int>(capacity))
+                      : ::recv(fd_, out, capacity, 0);
+        if (n > 0) {
+            return static_cast<size_t>(n);
+        }
+        if (!ssl_ && n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n == 0 || (ssl_ && SSL_get_error(ssl_, static_cast<int>(n)) == SSL_ERROR_ZERO_RETURN)) {
+            throw HttpError(0, "Connection closed by server");
+        }
+        throw HttpError(0, "Connection read failed");
+    }
+}
+
+void RawConnection::interrupt() {
+    // Shutting down (not closing) keeps the descriptor valid for the owner
+    ::shutdown(fd_, SHUT_RDWR);
+}
+
+bool RawConnection::fast_open_accepted() const {
+#if defined(__linux__) && defined(TCPI_OPT_SYN_DATA)
+    tcp_info info{};
+    socklen_t length = sizeof(info);
+    return fast_open_ && getsockopt(fd_, IPPROTO_TCP, TCP_INFO, &info, &length) == 0 &&
+           (info.tcpi_options & TCPI_OPT_SYN_DATA) != 0;
+#else
+    return false;
+#endif
+}
+
+#endif // _WIN32
+
+void RawConnection::fill() {
+    char chunk[16 * 1024];
+    size_t n = read_some(chunk, sizeof(chunk));
+    buffer_.append(chunk, n);
+}
+
+std::string RawConnection::read_line() {
+    for (;;) {
+        auto end = buffer_.find("\r\n");
+        if (end != std::string::npos) {
+            auto line = buffer_.substr(0, end);
+            buffer_.erase(0, end + 2);
+            return line;
+        }
+        if (buffer_.size() > kMaxHeaderBytes) {
+            throw HttpError(0, "Response header too large");
+        }
+        fill();
+    }
+}
+
+std::string RawConnection::read_exact(size_t length) {
+    while (buffer_.size() < length) {
+        fill();
+    }
+    auto data = buffer_.substr(0, length);
+    buffer_.erase(0, length);
+    return data;
+}
+
+std::string RawConnection::read_chunked() {
+    std::string body;
+    for (;;) {
+        // Chunk extensions follow the size after a semicolon
+        size_t size = parse_size(trim(read_line()), 16, "; \t", "chunked encoding");
+        if (size == 0) {
+            // Skip trailers
+            while (!read_line().empty()) {
+            }
+            return body;
+        }
+        body += read_exact(size);
+        read_line();
+    }
+}
+
+RawResponse RawConnection::read_response() {
+    RawResponse response;
+    
+    std::string status_line;
+    for (;;) {
+        status_line = read_line();
+        if (status_line.compare(0, 5, "HTTP/") != 0 || status_line.size() < 12) {
+            throw HttpError(0, "Malformed status line");
+        }
+        size_t status = parse_size(std::string_view(status_line).substr(9), 10, " ", "status line");
+        if (status > 999) {
+            throw HttpError(0, "Malformed status line");
+        }
+        response.status = static_cast<int>(status);
+        // Interim responses (100 Continue, 103 Early Hints) have headers
+        // but no body and precede the real one. 101 switches protocols,
+        // so it is final.
+        if (response.status < 100 || response.status >= 200 || response.status == 101) {
+            break;
+        }
+        while (!read_line().empty()) {
+        }
+    }
+    response.close = status_line.compare(0, 8, "HTTP/1.0") == 0;
+    
+    std::optional<size_t> content_length;
+    bool chunked = false;
+    for (auto line = read_line(); !line.empty(); line = read_line()) {
+        auto colon = line.find(':');
+        if (colon == std::string::npos) {
+            continue;
+        }
+        auto name = lower(line.substr(0, colon));
+        auto value = trim(std::string_view(line).substr(colon + 1));
+        if (name == "content-length") {
+            content_length = parse_size(value, 10, "", "Content-Length");
+        } else if (name == "transfer-encoding") {
+            chunked = lower(value).find("chunked") != std::string::npos;
+        } else if (name == "content-type") {
+            response.content_type = value;
+        } else if (name == "connection") {
+            auto token = lower(value);
+            if (token.find("close") != std::string::npos) {
+                response.close = true;
+            } else if (token.find("keep-alive") != std::string::npos) {
+                response.close = false;
+            }
+        }
+    }
+    
+    if (chunked) {
+        response.body = read_chunked();
+    } else if (content_length) {
+        response.body = read_exact(*content_length);
+    } else if (response.status >= 200 && response.status != 204 && response.status != 304) {
+        // Body delimited by close: nothing can follow it on this connection
+        response.close = true;
+        try {
+            for (;;) {
+                fill();
+            }
+        } catch (const HttpError&) {
+            response.body = std::move(buffer_);
+            buffer_.clear();
+        }
+    }
+    return response;
+}
+
+} // namespace detail
+} // namespace pxshot
@@ -0,0 +1,173 @@
+// Pxshot C++ SDK - Minimal HTTP/1.1 connection (internal)
+//
+// cpp-httplib strictly alternates request and response on a connection.
+// This is a small keep-alive connection that can write several requests
+// before reading their responses in order (HTTP/1.1 pipelining).
+
+#ifndef PXSHOT_RAW_CONNECTION_HPP
+#define PXSHOT_RAW_CONNECTION_HPP
+
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+typedef struct ssl_ctx_st SSL_CTX;
+typedef struct ssl_st SSL;
+typedef struct ssl_session_st SSL_SESSION;
+
+namespace pxshot {
+namespace detail {
+
+/// Scheme, host and port of an API base URL
+struct Endpoint {
+    std::string scheme;
+    std::string host;
+    int port = 0;
+    
+    [[nodiscard]] bool tls() const { return scheme == "https"; }
+    
+    /// Value for the Host header
+    [[nodiscard]] std::string authority() const;
+};
+
+/// Parse "scheme://host[:port]"; throws Error if malformed
+[[nodiscard]] Endpoint parse_endpoint(std::string_view base_url);
+
+/// An HTTP proxy that tunnels connections with CONNECT
+struct Proxy {
+    Endpoint endpoint;
+    std::string username;
+    std::string password;
+    
+    /// Proxy-Authorization header value ("" without credentials)
+    [[nodiscard]] std::string authorization() const;
+};
+
+/// Parse "http://[user:password@]host[:port]"; throws Error if malformed
+[[nodiscard]] Proxy parse_proxy(std::string_view url);
+
+/// Time spent setting up a connection
+struct ConnectTimings {
+    std::chrono::microseconds proxy_connect{0};     // TCP to the proxy and its CONNECT reply
+    std::chrono::microseconds connect{0};           // TCP to the server, when direct
+    std::chrono::microseconds tls_handshake{0};
+};
+
+/// Ways to save round trips when opening a connection. Data sent this way
+/// can be replayed by the network, so both are for replay-safe data only.
+struct FastConnect {
+    bool tcp_fast_open = false;     // Carry the first flight in the SYN (Linux). Also means
+                                    // connect failures surface on the first write, so only
+                                    // the first address is tried.
+    std::string_view early_data;    // Request to send as TLS 1.3 0-RTT data, if the resumed
+                                    // session allows it
+};
+
+/// What became of FastConnect::early_data
+enum class EarlyData {
+    NotSent,        // No resumable session, or it allows no early data
+    Accepted,
+    Rejected        // The server ignored it; it has to be sent again
+};
+
+/// One parsed HTTP response
+struct RawResponse {
+    int status = 0;
+    std::string content_type;
+    std::string body;
+    bool close = false;         // Server will close the connection after this
+};
+
+/// Client TLS configuration shared by connections. Loading the trust store
+/// is the expensive part of TLS setup, so it is done once per client (and
+/// inherited by forked children) rather than once per connection. The
+/// latest session ticket is kept so that new connections resume it.
+class TlsContext {
+public:
+    TlsContext();
+    ~TlsContext();
+    
+    TlsContext(const TlsContext&) = delete;
+    TlsContext& operator=(const TlsContext&) = delete;
+    
+    [[nodiscard]] SSL_CTX* get() const { return ctx_; }
+    
+    /// The session to resume, with a reference for the caller to free; null
+    /// if there is none
+    [[nodiscard]] SSL_SESSION* session() const;
+    
+    void lock() { mutex_.lock(); }
+    void unlock() { mutex_.unlock(); }
+
+private:
+    SSL_CTX* ctx_ = nullptr;
+    mutable std::mutex mutex_;
+    SSL_SESSION* session_ = nullptr;
+    
+    static int on_new_session(SSL* ssl, SSL_SESSION* session);
+};
+
+class RawConnection {
+public:
+    /// Connect (and handshake, for https); throws HttpError on failure.
+    /// `addresses` are numeric addresses to try instead of resolving the
+    /// host connected to; `tls` is required for https endpoints. With a
+    /// `proxy`, the connection is a CONNECT tunnel through it and
+    /// `addresses` are the proxy's.
+    RawConnection(const Endpoint& endpoint, int timeout_seconds, const TlsContext* tls = nullptr,
+                  const std::vector<std::string>& addresses = {}, const Proxy* proxy = nullptr,
+                  const FastConnect& fast = {});
+    ~RawConnection();
+    
+    RawConnection(const RawConnection&) = delete;
+    RawConnection& operator=(const RawConnection&) = delete;
+    
+    /// Write all of `data`; throws HttpError on failure
+    void write(std::string_view data);
+    
+    /// Read the next complete response; throws HttpError if the
+    /// connection fails or closes before the response is complete
+    [[nodiscard]] RawResponse read_response();
+    
+    /// Make blocked and future reads and writes fail; safe to call from
+    /// another thread while the connection is in use
+    void interrupt();
+    
+    /// Underlying socket descriptor
+    [[nodiscard]] int fd() const { return fd_; }
+    
+    /// How long the connection took to set up. With TCP Fast Open the TCP
+    /// handshake overlaps the first flight, so it is counted with that.
+    [[nodiscard]] const ConnectTimings& timings() const { return timings_; }
+    
+    /// Whether the connection was opened with TCP Fast Open
+    [[nodiscard]] bool fast_open() const { return fast_open_; }
+    
+    /// Whether the server accepted the data carried in the SYN (Linux)
+    [[nodiscard]] bool fast_open_accepted() const;
+    
+    [[nodiscard]] EarlyData early_data() const { return early_data_; }
+
+private:
+    int fd_ = -1;
+    SSL* ssl_ = nullptr;
+    bool fast_open_ = false;
+    EarlyData early_data_ = EarlyData::NotSent;
+    std::string buffer_;        // Received but not yet consumed bytes
+    ConnectTimings timings_;
+    
+    /// Ask the proxy connected to for a tunnel to `endpoint`
+    void open_tunnel(const Endpoint& endpoint, const Proxy& proxy);    
+    size_t read_some(char* out, size_t capacity);
+    void fill();
+    std::string read_line();
+    std::string read_exact(size_t length);
+    std::string read_chunked();
+};
+
+} // namespace detail
+} // namespace pxshot
+
+#endif // PXSHOT_RAW_CONNECTION_HPP
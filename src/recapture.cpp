@@ -0,0 +1,88 @@
+// Pxshot C++ SDK - Adaptive recapture intervals
+
+#include "recapture.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace pxshot {
+namespace detail {
+
+void validate(const MonitorConfig& config) {
+    if (config.interval.count() <= 0) {
+        throw ValidationError("monitor interval must be positive");
+    }
+    if (!config.adaptive) {
+        return;
+    }
+    if (config.min_interval.count() <= 0 || config.max_interval < config.min_interval) {
+        throw ValidationError("monitor min_interval must be positive and at most max_interval");
+    }
+    if (!(config.change_probability > 0 && config.change_probability < 1)) {
+        throw ValidationError("monitor change_probability must be between 0 and 1");
+    }
+    if (!(config.max_growth >= 1)) {
+        throw ValidationError("monitor max_growth must be at least 1");
+    }
+    if (config.history == 0) {
+        throw ValidationError("monitor history must be at least 1");
+    }
+}
+
+double change_rate(const std::vector<MonitorObservation>& history) {
+    // The log-likelihood's slope is
+    //   sum over changed of I / (exp(rate * I) - 1) - sum over unchanged of I,
+    // which falls from +inf to -(unchanged time) as the rate grows, so its
+    // one root is found by bisection (on a log scale, as rates span decades)
+    double unchanged = 0;
+    bool any_changed = false;
+    for (const auto& observation : history) {
+        if (observation.changed) {
+            any_changed = true;
+        } else {
+            unchanged += static_cast<double>(observation.interval.count());
+        }
+    }
+    if (!any_changed) {
+        return 0;
+    }
+    if (unchanged == 0) {
+        return std::numeric_limits<double>::infinity();
+    }
+    
+    auto slope = [&](double rate) {
+        double sum = -unchanged;
+        for (const auto& observation : history) {
+            if (observation.changed) {
+                double interval = std::max<double>(1, static_cast<double>(observation.interval.count()));
+                sum += interval / std::expm1(rate * interval);
+            }
+        }
+        return sum;
+    };
+    double low = std::log(1e-12);       // Once in 30,000 years
+    double high = std::log(1.0);        // Every second
+    for (int i = 0; i < 64; ++i) {
+        double middle = (low + high) / 2;
+        (slope(std::exp(middle)) > 0 ? low : high) = middle;
+    }
+    return std::exp((low + high) / 2);
+}
+
+std::chrono::seconds next_interval(const MonitorConfig& config, std::chrono::seconds current, double rate) {
+    if (!config.adaptive) {
+        return config.interval;
+    }
+    // A change within t is 1 - exp(-rate * t) likely
+    double target = rate > 0 ? -std::log1p(-config.change_probability) / rate
+                             : std::numeric_limits<double>::infinity();
+    double ceiling = std::min(static_cast<double>(config.max_interval.count()),
+                              static_cast<double>(current.count()) * config.max_growth);
+    double seconds = std::clamp(target, static_cast<double>(config.min_interval.count()),
+                                std::max(ceiling, static_cast<double>(config.min_interval.count())));
+    return std::chrono::seconds(static_cast<std::chrono::seconds::rep>(std::llround(seconds)));
+}
+
+} // namespace detail
+} // namespace pxshot
@@ -0,0 +1,32 @@
+// Pxshot C++ SDK - Adaptive recapture intervals (internal)
+
+#ifndef PXSHOT_RECAPTURE_HPP
+#define PXSHOT_RECAPTURE_HPP
+
+#include "pxshot/pxshot.hpp"
+
+#include <chrono>
+#include <vector>
+
+namespace pxshot {
+namespace detail {
+
+/// Throws ValidationError for out-of-range settings
+void validate(const MonitorConfig& config);
+
+/// Changes per second of a page whose captures saw `history`. Changes are
+/// taken to arrive as a Poisson process, so a capture after interval I
+/// sees one with probability 1 - exp(-rate * I); the rate is the one most
+/// likely to give the observed history. Zero if no capture saw a change,
+/// infinite if every one did.
+[[nodiscard]] double change_rate(const std::vector<MonitorObservation>& history);
+
+/// Interval to capture a page at next, from its current interval and its
+/// change rate
+[[nodiscard]] std::chrono::seconds next_interval(const MonitorConfig& config, std::chrono::seconds current,
+                                                 double rate);
+
+} // namespace detail
+} // namespace pxshot
+
+#endif // PXSHOT_RECAPTURE_HPP
@@ -0,0 +1,160 @@
+// Pxshot C++ SDK - JSON encoding of public types
+
+#include "request_json.hpp"
+
+#include <initializer_list>
+
+namespace pxshot {
+namespace detail {
+
+using json = nlohmann::json;
+
+namespace {
+
+template <typename T>
+void read_optional(const json& body, const char* key, std::optional<T>& out) {
+    if (auto it = body.find(key); it != body.end()) {
+        out = it->get<T>();
+    }
+}
+
+template <typename Enum>
+Enum enum_from_string(const std::string& text, std::initializer_list<Enum> values) {
+    for (auto value : values) {
+        if (text == to_string(value)) {
+            return value;
+        }
+    }
+    throw ValidationError("Unknown option value: " + text);
+}
+
+WaitUntil wait_until_from_string(const std::string& text) {
+    return enum_from_string(text, {WaitUntil::Load, WaitUntil::DOMContentLoaded,
+                                   WaitUntil::NetworkIdle, WaitUntil::Commit});
+}
+
+} // namespace
+
+json to_request_body(const ScreenshotOptions& options) {
+    json body;
+    body["url"] = options.url;
+    
+    if (options.format) {
+        body["format"] = to_string(*options.format);
+    }
+    if (options.quality) {
+        body["quality"] = *options.quality;
+    }
+    if (options.width) {
+        body["width"] = *options.width;
+    }
+    if (options.height) {
+        body["height"] = *options.height;
+    }
+    if (options.full_page) {
+        body["full_page"] = *options.full_page;
+    }
+    if (options.wait_until) {
+        body["wait_until"] = to_string(*options.wait_until);
+    }
+    if (options.wait_for_selector) {
+        body["wait_for_selector"] = *options.wait_for_selector;
+    }
+    if (options.wait_for_timeout) {
+        body["wait_for_timeout"] = *options.wait_for_timeout;
+    }
+    if (options.device_scale_factor) {
+        body["device_scale_factor"] = *options.device_scale_factor;
+    }
+    if (options.store) {
+        body["store"] = *options.store;
+    }
+    if (options.block_ads) {
+        body["block_ads"] = *options.block_ads;
+    }
+    return body;
+}
+
+ScreenshotOptions from_request_body(const json& body) {
+    ScreenshotOptions options;
+    options.url = body.at("url").get<std::string>();
+    
+    if (auto it = body.find("format"); it != body.end()) {
+        options.format = enum_from_string(it->get<std::string>(),
+                                          {Format::PNG, Format::JPEG, Format::WEBP});
+    }
+    if (auto it = body.find("wait_until"); it != body.end()) {
+        options.wait_until = wait_until_from_string(it->get<std::string>());
+    }
+    read_optional(body, "quality", options.quality);
+    read_optional(body, "width", options.width);
+    read_optional(body, "height", options.height);
+    read_optional(body, "full_page", options.full_page);
+    read_optional(body, "wait_for_selector", options.wait_for_selector);
+    read_optional(body, "wait_for_timeout", options.wait_for_timeout);
+    read_optional(body, "device_scale_factor", options.device_scale_factor);
+    read_optional(body, "store", options.store);
+    read_optional(body, "block_ads", options.block_ads);
+    return options;
+}
+
+BandwidthLimit bandwidth_from_json(const json& doc) {
+    BandwidthLimit limit;
+    limit.bytes_per_second = doc.value("bytes_per_second", limit.bytes_per_second);
+    limit.interactive_share = doc.value("interactive_share", limit.interactive_share);
+    limit.batch_share = doc.value("batch_share", limit.batch_share);
+    return limit;
+}
+
+DegradationPolicy degradation_from_json(const json& doc) {
+    DegradationPolicy policy;
+    policy.error_window = doc.value("error_window", policy.error_window);
+    for (const auto& entry : doc.value("rules", json::array())) {
+        DegradationRule rule;
+        rule.queue_wait = std::chrono::milliseconds(entry.value("queue_wait_ms", int64_t{0}));
+        rule.error_rate = entry.value("error_rate", rule.error_rate);
+        read_optional(entry, "max_device_scale_factor", rule.max_device_scale_factor);
+        rule.disable_full_page = entry.value("disable_full_page", rule.disable_full_page);
+        if (auto it = entry.find("wait_until"); it != entry.end()) {
+            rule.wait_until = wait_until_from_string(it->get<std::string>());
+        }
+        read_optional(entry, "max_wait_for_timeout", rule.max_wait_for_timeout);
+        policy.rules.push_back(rule);
+    }
+    return policy;
+}
+
+BlankDetection blank_detection_from_json(const json& doc) {
+    BlankDetection detection;
+    detection.enabled = doc.value("enabled", detection.enabled);
+    detection.max_variance = doc.value("max_variance", detection.max_variance);
+    detection.min_dominant_share = doc.value("min_dominant_share", detection.min_dominant_share);
+    detection.tolerance = doc.value("tolerance", detection.tolerance);
+    if (auto it = doc.find("action"); it != doc.end()) {
+        detection.action = enum_from_string(it->get<std::string>(), {BlankAction::Flag, BlankAction::Retry});
+    }
+    detection.retries = doc.value("retries", detection.retries);
+    return detection;
+}
+
+CachePolicy cache_policy_from_json(const json& doc) {
+    return enum_from_string(doc.get<std::string>(), {CachePolicy::Lru, CachePolicy::TinyLfu});
+}
+
+Tuning tuning_from_json(const json& doc) {
+    if (!doc.is_object()) {
+        throw ValidationError("Tuning must be a JSON object");
+    }
+    Tuning tuning;
+    read_optional(doc, "max_concurrency", tuning.max_concurrency);
+    read_optional(doc, "memory_budget_bytes", tuning.memory_budget_bytes);
+    if (auto it = doc.find("bandwidth"); it != doc.end()) {
+        tuning.bandwidth = bandwidth_from_json(*it);
+    }
+    read_optional(doc, "buffer_pool_bytes", tuning.buffer_pool_bytes);
+    read_optional(doc, "result_cache_bytes", tuning.result_cache_bytes);
+    return tuning;
+}
+
+} // namespace detail
+} // namespace pxshot
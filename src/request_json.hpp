@@ -0,0 +1,43 @@
+// Pxshot C++ SDK - JSON encoding of public types (internal)
+
+#ifndef PXSHOT_REQUEST_JSON_HPP
+#define PXSHOT_REQUEST_JSON_HPP
+
+#include "pxshot/pxshot.hpp"
+
+#include <nlohmann/json.hpp>
+
+namespace pxshot {
+namespace detail {
+
+/// API request body for `options`; unset options are omitted
+[[nodiscard]] nlohmann::json to_request_body(const ScreenshotOptions& options);
+
+/// Inverse of to_request_body(). Throws ValidationError for unknown enum
+/// values and nlohmann::json::exception for missing or mistyped fields.
+[[nodiscard]] ScreenshotOptions from_request_body(const nlohmann::json& body);
+
+/// {"bytes_per_second", "interactive_share", "batch_share"}; missing fields
+/// take their defaults
+[[nodiscard]] BandwidthLimit bandwidth_from_json(const nlohmann::json& doc);
+
+/// {"error_window", "rules": [{"queue_wait_ms", "error_rate",
+/// "max_device_scale_factor", "disable_full_page", "wait_until",
+/// "max_wait_for_timeout"}, ...]}; missing fields take their defaults
+[[nodiscard]] DegradationPolicy degradation_from_json(const nlohmann::json& doc);
+
+/// {"enabled", "max_variance", "min_dominant_share", "tolerance",
+/// "action": "flag"|"retry", "retries"}; missing fields take their defaults
+[[nodiscard]] BlankDetection blank_detection_from_json(const nlohmann::json& doc);
+
+/// "lru" or "tinylfu"; throws ValidationError for anything else
+[[nodiscard]] CachePolicy cache_policy_from_json(const nlohmann::json& doc);
+
+/// Tuning from an object with its field names; missing fields stay unset.
+/// Throws ValidationError if `doc` is not an object.
+[[nodiscard]] Tuning tuning_from_json(const nlohmann::json& doc);
+
+} // namespace detail
+} // namespace pxshot
+
+#endif // PXSHOT_REQUEST_JSON_HPP
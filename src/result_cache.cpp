@@ -0,0 +1,174 @@
+// Pxshot C++ SDK - Result cache
+
+#include "result_cache.hpp"
+
+#include <functional>
+#include <iterator>
+#include <vector>
+
+namespace pxshot {
+namespace detail {
+
+namespace {
+
+/// Memory charged for a cached result
+size_t charge(const std::string& key, const ScreenshotResult& result) {
+    size_t bytes = sizeof(ScreenshotResult) + key.size();
+    if (result.is_stored()) {
+        const auto& stored = result.stored();
+        return bytes + stored.url.size() + stored.expires_at.size();
+    }
+    return bytes + result.bytes().size();
+}
+
+} // namespace
+
+std::optional<ScreenshotResult> ResultCache::find(const std::string& key) {
+    uint64_t hash = std::hash<std::string>{}(key);
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (policy_ == CachePolicy::TinyLfu) {
+        sketch_.increment(hash);
+    }
+    auto it = index_.find(key);
+    if (it == index_.end()) {
+        ++stats_.misses;
+        return std::nullopt;
+    }
+    auto entry = it->second;
+    if (Clock::now() >= entry->expires) {
+        erase(entry);
+        ++stats_.misses;
+        return std::nullopt;
+    }
+    if (entry->segment == kWindow) {
+        move(entry, kWindow);
+    } else {
+        move(entry, kProtected);
+        rebalance();
+    }
+    ++stats_.hits;
+    return entry->result;
+}
+
+void ResultCache::insert(const std::string& key, const ScreenshotResult& result) {
+    size_t bytes = charge(key, result);
+    uint64_t hash = std::hash<std::string>{}(key);
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (auto it = index_.find(key); it != index_.end()) {
+        erase(it->second);
+    }
+    if (bytes > max_bytes_.load(std::memory_order_relaxed)) {
+        return;
+    }
+    auto& window = segments_[kWindow];
+    window.push_front(Entry{key, result, Clock::now() + ttl_, bytes, hash, kWindow});
+    index_.emplace(key, window.begin());
+    segment_bytes_[kWindow] += bytes;
+    stats_.bytes += bytes;
+    ++stats_.entries;
+    if (policy_ == CachePolicy::TinyLfu) {
+        sketch_.ensure_capacity(static_cast<size_t>(stats_.entries));
+    }
+    evict();
+}
+
+void ResultCache::set_max_bytes(size_t max_bytes) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    max_bytes_.store(max_bytes, std::memory_order_relaxed);
+    evict();
+    rebalance();
+}
+
+ResultCache::Stats ResultCache::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+size_t ResultCache::budget(Segment segment) const {
+    size_t total = max_bytes_.load(std::memory_order_relaxed);
+    if (policy_ == CachePolicy::Lru) {
+        return segment == kWindow ? total : 0;
+    }
+    size_t window = total / 100;
+    switch (segment) {
+        case kWindow: return window;
+        case kProtected: return (total - window) / 10 * 8;
+        default: return total - window;
+    }
+}
+
+void ResultCache::move(Iterator it, Segment segment) {
+    segment_bytes_[it->segment] -= it->bytes;
+    segments_[segment].splice(segments_[segment].begin(), segments_[it->segment], it);
+    segment_bytes_[segment] += it->bytes;
+    it->segment = segment;
+}
+
+void ResultCache::evict() {
+    if (policy_ == CachePolicy::TinyLfu) {
+        auto& window = segments_[kWindow];
+        while (!window.empty() && segment_bytes_[kWindow] > budget(kWindow)) {
+            admit(std::prev(window.end()));
+        }
+    }
+    // Only a smaller budget leaves more to evict here
+    size_t total = max_bytes_.load(std::memory_order_relaxed);
+    for (auto segment : {kProbation, kProtected, kWindow}) {
+        auto& entries = segments_[segment];
+        while (!entries.empty() && stats_.bytes > total) {
+            erase(std::prev(entries.end()));
+        }
+    }
+}
+
+void ResultCache::admit(Iterator candidate) {
+    size_t room = budget(kProbation);
+    size_t used = segment_bytes_[kProbation] + segment_bytes_[kProtected];
+    if (candidate->bytes > room) {
+        erase(candidate);
+        ++stats_.rejected;
+        return;
+    }
+    
+    // Victims are the least recently used entries of probation, then of
+    // the protected segment; expired ones go whatever their frequency
+    std::vector<Iterator> victims;
+    size_t freed = 0;
+    int frequency = sketch_.frequency(candidate->hash);
+    auto now = Clock::now();
+    for (auto segment : {kProbation, kProtected}) {
+        auto& entries = segments_[segment];
+        for (auto it = entries.end(); used + candidate->bytes > room + freed && it != entries.begin();) {
+            --it;
+            if (it->expires > now && sketch_.frequency(it->hash) >= frequency) {
+                erase(candidate);
+                ++stats_.rejected;
+                return;
+            }
+            victims.push_back(it);
+            freed += it->bytes;
+        }
+    }
+    for (auto victim : victims) {
+        erase(victim);
+    }
+    move(candidate, kProbation);
+}
+
+void ResultCache::rebalance() {
+    auto& protected_entries = segments_[kProtected];
+    while (!protected_entries.empty() && segment_bytes_[kProtected] > budget(kProtected)) {
+        move(std::prev(protected_entries.end()), kProbation);
+    }
+}
+
+void ResultCache::erase(Iterator it) {
+    stats_.bytes -= it->bytes;
+    --stats_.entries;
+    segment_bytes_[it->segment] -= it->bytes;
+    index_.erase(it->key);
+    segments_[it->segment].erase(it);
+}
+
+} // namespace detail
+} // namespace pxshot
@@ -0,0 +1,120 @@
+// Pxshot C++ SDK - Result cache (internal)
+
+#ifndef PXSHOT_RESULT_CACHE_HPP
+#define PXSHOT_RESULT_CACHE_HPP
+
+#include "pxshot/pxshot.hpp"
+#include "frequency_sketch.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+namespace pxshot {
+namespace detail {
+
+/// Completed captures keyed by their request body, so repeating an
+/// identical request within the TTL costs no render. Entries are evicted
+/// to stay within a byte budget, which can be changed at any time. Entries
+/// share their bytes with the results handed out, so caching a result
+/// adds no copy of the image either.
+///
+/// CachePolicy::Lru keeps one list and evicts its least recently used
+/// entries. CachePolicy::TinyLfu (W-TinyLFU) puts new entries in a small
+/// LRU window (1% of the budget). Those the window evicts are admitted to
+/// the main cache only if they were requested more often than the
+/// entries they would evict there, going by a FrequencySketch of every
+/// lookup. The main cache is a segmented LRU: entries hit there move from
+/// probation to a protected segment (80% of it), and entries falling out
+/// of that go back to probation. A sweep of one-off requests then
+/// churns only the window.
+class ResultCache {
+public:
+    using Clock = std::chrono::steady_clock;
+    
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t bytes = 0;         // Charged size of the cached results
+        uint64_t entries = 0;
+        uint64_t rejected = 0;      // Results the admission policy turned away
+    };
+    
+    ResultCache(size_t max_bytes, Clock::duration ttl, CachePolicy policy = CachePolicy::Lru)
+        : max_bytes_(max_bytes), ttl_(ttl), policy_(policy) {}
+    
+    [[nodiscard]] bool enabled() const { return max_bytes_.load(std::memory_order_relaxed) > 0; }
+    
+    /// Copy of the live entry for `key`, if any. Copies share the
+    /// entry's image bytes, so a hit costs no copy of the image.
+    [[nodiscard]] std::optional<ScreenshotResult> find(const std::string& key);
+    
+    /// Cache `result` under `key`, evicting as needed. Results larger than
+    /// the whole budget are not cached.
+    void insert(const std::string& key, const ScreenshotResult& result);
+    
+    /// Change the budget, evicting down to it immediately
+    void set_max_bytes(size_t max_bytes);
+    
+    [[nodiscard]] Stats stats() const;
+    
+    void lock() { mutex_.lock(); }
+    void unlock() { mutex_.unlock(); }
+
+private:
+    enum Segment { kWindow, kProbation, kProtected, kSegments };
+    
+    struct Entry {
+        std::string key;
+        ScreenshotResult result;
+        Clock::time_point expires;
+        size_t bytes;
+        uint64_t hash;              // Of the key, for the frequency sketch
+        Segment segment;
+    };
+    
+    using Iterator = std::list<Entry>::iterator;
+    
+    std::atomic<size_t> max_bytes_;
+    Clock::duration ttl_;
+    CachePolicy policy_;
+    mutable std::mutex mutex_;
+    std::list<Entry> segments_[kSegments];      // Most recently used first; only
+                                                // the window is used with Lru
+    size_t segment_bytes_[kSegments] = {};
+    std::unordered_map<std::string, Iterator> index_;
+    FrequencySketch sketch_;
+    Stats stats_;
+    
+    /// Byte budget of `segment`; that of probation covers the whole main
+    /// cache. Requires mutex_.
+    [[nodiscard]] size_t budget(Segment segment) const;
+    
+    /// Move `it` to the front of `segment`
+    void move(Iterator it, Segment segment);
+    
+    /// Evict down to the budget. Under TinyLfu, entries the window evicts
+    /// go to admit() first. Requires mutex_.
+    void evict();
+    
+    /// Move `candidate` from the window into probation if it is requested
+    /// more often than the main cache entries it would evict, else drop it
+    void admit(Iterator candidate);
+    
+    /// Demote protected entries to probation until the protected segment
+    /// is within its budget
+    void rebalance();
+    
+    void erase(Iterator it);
+};
+
+} // namespace detail
+} // namespace pxshot
+
+#endif // PXSHOT_RESULT_CACHE_HPP
@@ -0,0 +1,516 @@
+// Pxshot C++ SDK - S3 multipart upload sink
+
+#include "pxshot/pxshot.hpp"
+#include "raw_connection.hpp"
+#include "sigv4.hpp"
+
+#define CPPHTTPLIB_OPENSSL_SUPPORT
+#include <httplib.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <ctime>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace pxshot {
+
+namespace {
+
+constexpr size_t kMinPartBytes = 5 * 1024 * 1024;   // S3's floor for all but the last part
+constexpr int kPartAttempts = 3;
+constexpr std::chrono::milliseconds kFirstRetryDelay{100};     // Doubled before each later retry
+
+/// Current time as "YYYYMMDDTHHMMSSZ"
+std::string amz_date_now() {
+    auto now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+    std::tm tm{};
+#ifdef _WIN32
+    gmtime_s(&tm, &now);
+#else
+    gmtime_r(&now, &tm);
+#endif
+    char text[20];
+    std::strftime(text, sizeof(text), "%Y%m%dT%H%M%SZ", &tm);
+    return text;
+}
+
+/// Text of the first <tag> element in an S3 XML response ("" if none)
+std::string xml_value(const std::string& xml, const std::string& tag) {
+    auto open = xml.find('<' + tag + '>');
+    if (open == std::string::npos) {
+        return {};
+    }
+    open += tag.size() + 2;
+    auto close = xml.find("</" + tag + '>', open);
+    return close == std::string::npos ? std::string() : xml.substr(open, close - open);
+}
+
+[[noreturn]] void throw_s3_error(const std::string& context, const httplib::Result& res) {
+    if (!res) {
+        throw HttpError(0, context + ": " + httplib::to_string(res.error()));
+    }
+    std::string message = context + ": HTTP " + std::to_string(res->status);
+    if (auto code = xml_value(res->body, "Code"); !code.empty()) {
+        message += ' ' + code;
+    }
+    if (auto detail = xml_value(res->body, "Message"); !detail.empty()) {
+        message += ": " + detail;
+    }
+    throw HttpError(res->status, message);
+}
+
+} // namespace
+
+// =============================================================================
+// Implementation Details
+// =============================================================================
+
+/// One object's upload, shared between its sink and the part uploaders
+struct S3Sink::Upload {
+    std::string key;
+    std::string content_type = "application/octet-stream";
+    std::string upload_id;                  // Set before the first part is queued
+    uint64_t bytes = 0;
+    
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<std::string> etags;         // By part number - 1
+    int outstanding = 0;                    // Parts queued or uploading
+    std::exception_ptr error;               // First part failure
+};
+
+struct S3Uploader::Impl {
+    struct Part {
+        std::shared_ptr<S3Sink::Upload> upload;
+        int number = 0;
+        std::string data;
+    };
+    
+    S3Target target;
+    std::string base_url;                   // Scheme and authority, for httplib
+    std::string host;                       // Host header, signed
+    std::string bucket_path;                // "/bucket" for path-style addressing
+    size_t max_pending;                     // Parts queued or uploading, across all sinks
+    
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<Part> parts;
+    size_t pending = 0;
+    std::vector<std::string> free_buffers;
+    std::vector<std::unique_ptr<httplib::Client>> idle_clients;
+    bool stopping = false;
+    std::vector<std::thread> workers;
+    
+    explicit Impl(S3Target t) : target(std::move(t)) {
+        if (target.bucket.empty()) {
+            throw ValidationError("S3 bucket is required");
+        }
+        if (target.part_bytes < kMinPartBytes) {
+            throw ValidationError("S3 part size must be at least 5 MiB");
+        }
+        detail::Endpoint endpoint;
+        try {
+            endpoint = detail::parse_endpoint(target.endpoint);
+        } catch (const Error& e) {
+            throw ValidationError(std::string("Invalid S3 endpoint: ") + e.what());
+        }
+        if (target.virtual_hosted) {
+            endpoint.host = target.bucket + '.' + endpoint.host;
+        } else {
+            bucket_path = '/' + detail::uri_encode(target.bucket, false);
+        }
+        host = endpoint.authority();
+        base_url = endpoint.scheme + "://" + host;
+        
+        int count = std::max(1, target.parallel_parts);
+        max_pending = 2 * static_cast<size_t>(count);
+        for (int i = 0; i < count; ++i) {
+            workers.emplace_back([this] { worker_loop(); });
+        }
+    }
+    
+    ~Impl() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        cv.notify_all();
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+    
+    [[nodiscard]] std::unique_ptr<httplib::Client> make_client() const {
+        auto client = std::make_unique<httplib::Client>(base_url);
+        client->set_connection_timeout(target.timeout_seconds);
+        client->set_read_timeout(target.timeout_seconds);
+        client->set_write_timeout(target.timeout_seconds);
+        client->set_keep_alive(true);
+        return client;
+    }
+    
+    // -------------------------------------------------------------------------
+    // Pools
+    // -------------------------------------------------------------------------
+    
+    /// Connection for a request made on a sink's thread
+    [[nodiscard]] std::unique_ptr<httplib::Client> acquire_client() {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (idle_clients.empty()) {
+            return make_client();
+        }
+        auto client = std::move(idle_clients.back());
+        idle_clients.pop_back();
+        return client;
+    }
+    
+    void release_client(std::unique_ptr<httplib::Client> client) {
+        std::lock_guard<std::mutex> lock(mutex);
+        idle_clients.push_back(std::move(client));
+    }
+    
+    /// Empty buffer with room for a whole part
+    [[nodiscard]] std::string acquire_buffer() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!free_buffers.empty()) {
+                auto buffer = std::move(free_buffers.back());
+                free_buffers.pop_back();
+                return buffer;
+            }
+        }
+        std::string buffer;
+        buffer.reserve(target.part_bytes);
+        return buffer;
+    }
+    
+    /// Keep `buffer` for reuse, up to one per pending slot. Requires mutex.
+    void keep_buffer(std::string&& buffer) {
+        if (free_buffers.size() < max_pending && buffer.capacity() >= target.part_bytes) {
+            buffer.clear();
+            free_buffers.push_back(std::move(buffer));
+        }
+    }
+    
+    void release_buffer(std::string&& buffer) {
+        std::lock_guard<std::mutex> lock(mutex);
+        keep_buffer(std::move(buffer));
+    }
+    
+    // -------------------------------------------------------------------------
+    // Requests
+    // -------------------------------------------------------------------------
+    
+    /// Send a SigV4-signed request for `key`. The body is moved into the
+    /// request and back, so pooled buffers keep their capacity.
+    httplib::Result send(httplib::Client& client, const std::string& method, const std::string& key,
+                         std::vector<std::pair<std::string, std::string>> query, std::string& body,
+                         const std::string& content_type = {}) {
+        auto path = bucket_path + '/' + detail::uri_encode(key, true);
+        auto query_text = detail::canonical_query(query);
+        auto payload_hash = detail::sha256_hex(body);
+        auto date = amz_date_now();
+        
+        detail::SigV4Request signed_request{method, path, std::move(query),
+                                            {{"host", host},
+                                             {"x-amz-content-sha256", payload_hash},
+                                             {"x-amz-date", date}},
+                                            payload_hash};
+        if (!target.session_token.empty()) {
+            signed_request.headers.emplace_back("x-amz-security-token", target.session_token);
+        }
+        
+        httplib::Request req;
+        req.method = method;
+        req.path = query_text.empty() ? path : path + '?' + query_text;
+        for (const auto& [name, value] : signed_request.headers) {
+            req.headers.emplace(name, value);
+        }
+        req.headers.emplace("Authorization",
+                            detail::sigv4_authorization(signed_request, target.access_key_id,
+                                                        target.secret_access_key, target.region, "s3", date));
+        if (!content_type.empty()) {
+            req.headers.emplace("Content-Type", content_type);
+        }
+        req.body = std::move(body);
+        auto res = client.send(req);
+        body = std::move(req.body);
+        return res;
+    }
+    
+    /// Request on a pooled connection from the calling thread
+    httplib::Result send_control(const std::string& method, const std::string& key,
+                                 std::vector<std::pair<std::string, std::string>> query, std::string body,
+                                 const std::string& content_type = {}) {
+        auto client = acquire_client();
+        auto res = send(*client, method, key, std::move(query), body, content_type);
+        if (res) {
+            release_client(std::move(client));
+        }
+        return res;
+    }
+    
+    void initiate(S3Sink::Upload& upload) {
+        auto res = send_control("POST", upload.key, {{"uploads", ""}}, {}, upload.content_type);
+        if (!res || res->status != 200) {
+            throw_s3_error("S3 multipart upload could not be started", res);
+        }
+        upload.upload_id = xml_value(res->body, "UploadId");
+        if (upload.upload_id.empty()) {
+            throw HttpError(res->status, "S3 multipart upload could not be started: no UploadId in response");
+        }
+    }
+    
+    /// Returns the object's ETag
+    std::string complete(S3Sink::Upload& upload) {
+        std::string xml = "<CompleteMultipartUpload>";
+        for (size_t i = 0; i < upload.etags.size(); ++i) {
+            xml += "<Part><PartNumber>" + std::to_string(i + 1) + "</PartNumber><ETag>" + upload.etags[i] +
+                   "</ETag></Part>";
+        }
+        xml += "</CompleteMultipartUpload>";
+        
+        auto res = send_control("POST", upload.key, {{"uploadId", upload.upload_id}}, std::move(xml),
+                                "application/xml");
+        // A failure can also arrive as an <Error> document with status 200
+        if (!res || res->status != 200 || res->body.find("<Error>") != std::string::npos) {
+            throw_s3_error("S3 multipart upload could not be completed", res);
+        }
+        return xml_value(res->body, "ETag");
+    }
+    
+    void abort_upload(S3Sink::Upload& upload) {
+        (void)send_control("DELETE", upload.key, {{"uploadId", upload.upload_id}}, {});
+    }
+    
+    /// Single-request upload of a small body; returns the object's ETag
+    std::string put_object(S3Sink::Upload& upload, std::string& body) {
+        auto client = acquire_client();
+        auto res = send(*client, "PUT", upload.key, {}, body, upload.content_type);
+        if (!res || res->status != 200) {
+            throw_s3_error("S3 upload failed", res);
+        }
+        release_client(std::move(client));
+        return res->get_header_value("ETag");
+    }
+    
+    // -------------------------------------------------------------------------
+    // Part uploads
+    // -------------------------------------------------------------------------
+    
+    /// Queue a part, waiting while too many are already pending
+    void submit(Part part) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            cv.wait(lock, [&] { return pending < max_pending; });
+            ++pending;
+            parts.push_back(std::move(part));
+        }
+        cv.notify_all();
+    }
+    
+    void worker_loop() {
+        auto client = make_client();
+        for (;;) {
+            Part part;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                cv.wait(lock, [&] { return stopping || !parts.empty(); });
+                if (parts.empty()) {
+                    return;
+                }
+                part = std::move(parts.front());
+                parts.pop_front();
+            }
+            
+            upload_part(*client, part);
+            
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                --pending;
+                keep_buffer(std::move(part.data));
+            }
+            cv.notify_all();
+        }
+    }
+    
+    /// Upload one part, retrying network failures and server errors after
+    /// a short exponential backoff
+    void upload_part(httplib::Client& client, Part& part) {
+        auto& upload = *part.upload;
+        {
+            std::lock_guard<std::mutex> lock(upload.mutex);
+            if (upload.error) {
+                --upload.outstanding;   // The upload is being abandoned anyway
+                upload.cv.notify_all();
+                return;
+            }
+        }
+        
+        std::string etag;
+        std::exception_ptr error;
+        auto delay = kFirstRetryDelay;
+        for (int attempt = 1; attempt <= kPartAttempts; ++attempt) {
+            if (attempt > 1) {
+                std::this_thread::sleep_for(delay);
+                delay *= 2;
+            }
+            auto res = send(client, "PUT", upload.key,
+                            {{"partNumber", std::to_string(part.number)}, {"uploadId", upload.upload_id}},
+                            part.data);
+            if (res && res->status == 200) {
+                etag = res->get_header_value("ETag");
+                error = nullptr;
+                break;
+            }
+            try {
+                throw_s3_error("S3 part " + std::to_string(part.number) + " upload failed", res);
+            } catch (...) {
+                error = std::current_exception();
+            }
+            if (res && res->status < 500) {
+                break;      // Retrying a client error will not help
+            }
+        }
+        
+        {
+            std::lock_guard<std::mutex> lock(upload.mutex);
+            if (error) {
+                if (!upload.error) {
+                    upload.error = error;
+                }
+            } else {
+                upload.etags[static_cast<size_t>(part.number) - 1] = std::move(etag);
+            }
+            --upload.outstanding;
+        }
+        upload.cv.notify_all();
+    }
+};
+
+// =============================================================================
+// S3Uploader
+// =============================================================================
+
+S3Uploader::S3Uploader(S3Target target) : impl_(std::make_shared<Impl>(std::move(target))) {}
+
+S3Uploader::~S3Uploader() = default;
+
+std::unique_ptr<S3Sink> S3Uploader::open(std::string key) {
+    return std::unique_ptr<S3Sink>(new S3Sink(impl_, std::move(key)));
+}
+
+// =============================================================================
+// S3Sink
+// =============================================================================
+
+S3Sink::S3Sink(std::shared_ptr<S3Uploader::Impl> uploader, std::string key)
+    : uploader_(std::move(uploader)), upload_(std::make_shared<Upload>()) {
+    upload_->key = key;
+    object_.bucket = uploader_->target.bucket;
+    object_.key = std::move(key);
+}
+
+S3Sink::~S3Sink() {
+    abort();
+}
+
+void S3Sink::begin(std::string_view content_type, std::optional<uint64_t>) {
+    if (!content_type.empty()) {
+        upload_->content_type = std::string(content_type);
+    }
+    buffer_ = uploader_->acquire_buffer();
+}
+
+void S3Sink::write(const uint8_t* data, size_t size) {
+    size_t part_bytes = uploader_->target.part_bytes;
+    while (size > 0) {
+        size_t n = std::min(size, part_bytes - buffer_.size());
+        buffer_.append(reinterpret_cast<const char*>(data), n);
+        data += n;
+        size -= n;
+        if (buffer_.size() == part_bytes) {
+            submit_part();
+            buffer_ = uploader_->acquire_buffer();
+        }
+    }
+}
+
+void S3Sink::submit_part() {
+    auto& upload = *upload_;
+    {
+        std::lock_guard<std::mutex> lock(upload.mutex);
+        if (upload.error) {
+            std::rethrow_exception(upload.error);   // Stop receiving what cannot be stored
+        }
+    }
+    if (upload.upload_id.empty()) {
+        uploader_->initiate(upload);
+    }
+    int number = 0;
+    {
+        std::lock_guard<std::mutex> lock(upload.mutex);
+        upload.etags.emplace_back();
+        number = static_cast<int>(upload.etags.size());
+        ++upload.outstanding;
+    }
+    upload.bytes += buffer_.size();
+    uploader_->submit(S3Uploader::Impl::Part{upload_, number, std::move(buffer_)});
+    buffer_.clear();
+}
+
+void S3Sink::finish() {
+    auto& upload = *upload_;
+    if (upload.upload_id.empty()) {
+        upload.bytes = buffer_.size();
+        object_.etag = uploader_->put_object(upload, buffer_);
+    } else {
+        try {
+            if (!buffer_.empty()) {
+                submit_part();
+            }
+            std::exception_ptr error;
+            {
+                std::unique_lock<std::mutex> lock(upload.mutex);
+                upload.cv.wait(lock, [&] { return upload.outstanding == 0; });
+                error = upload.error;
+            }
+            if (error) {
+                std::rethrow_exception(error);
+            }
+            object_.etag = uploader_->complete(upload);
+        } catch (...) {
+            abort();
+            throw;
+        }
+        object_.parts = static_cast<int>(upload.etags.size());
+    }
+    object_.size_bytes = upload.bytes;
+    uploader_->release_buffer(std::move(buffer_));
+    buffer_ = std::string();
+    upload.upload_id.clear();       // Nothing left for abort() to clean up
+}
+
+void S3Sink::abort() noexcept {
+    auto& upload = *upload_;
+    if (!upload.upload_id.empty()) {
+        {
+            std::unique_lock<std::mutex> lock(upload.mutex);
+            upload.cv.wait(lock, [&] { return upload.outstanding == 0; });
+        }
+        try {
+            uploader_->abort_upload(upload);
+        } catch (...) {
+            // Unreferenced parts expire under the bucket's lifecycle rules
+        }
+        upload.upload_id.clear();
+    }
+    if (buffer_.capacity() > 0) {
+        uploader_->release_buffer(std::move(buffer_));
+        buffer_ = std::string();
+    }
+}
+
+} // namespace pxshot
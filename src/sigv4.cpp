@@ -0,0 +1,112 @@
+// Pxshot C++ SDK - AWS Signature Version 4
+
+#include "sigv4.hpp"
+
+#include <openssl/hmac.h>
+#include <openssl/sha.h>
+
+#include <algorithm>
+
+namespace pxshot {
+namespace detail {
+
+namespace {
+
+std::string to_hex(const unsigned char* data, size_t size) {
+    static constexpr char kDigits[] = "0123456789abcdef";
+    std::string hex(size * 2, '0');
+    for (size_t i = 0; i < size; ++i) {
+        hex[2 * i] = kDigits[data[i] >> 4];
+        hex[2 * i + 1] = kDigits[data[i] & 0xf];
+    }
+    return hex;
+}
+
+std::string hmac_sha256(std::string_view key, std::string_view data) {
+    unsigned char digest[EVP_MAX_MD_SIZE];
+    unsigned int length = 0;
+    HMAC(EVP_sha256(), key.data(), static_cast<int>(key.size()),
+         reinterpret_cast<const unsigned char*>(data.data()), data.size(), digest, &length);
+    return std::string(reinterpret_cast<const char*>(digest), length);
+}
+
+} // namespace
+
+std::string sha256_hex(std::string_view data) {
+    unsigned char digest[SHA256_DIGEST_LENGTH];
+    SHA256(reinterpret_cast<const unsigned char*>(data.data()), data.size(), digest);
+    return to_hex(digest, sizeof(digest));
+}
+
+std::string uri_encode(std::string_view text, bool keep_slash) {
+    static constexpr char kDigits[] = "0123456789ABCDEF";
+    std::string out;
+    out.reserve(text.size());
+    for (unsigned char c : text) {
+        bool unreserved = (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') ||
+                          c == '-' || c == '.' || c == '_' || c == '~' || (keep_slash && c == '/');
+        if (unreserved) {
+            out += static_cast<char>(c);
+        } else {
+            out += '%';
+            out += kDigits[c >> 4];
+            out += kDigits[c & 0xf];
+        }
+    }
+    return out;
+}
+
+std::string canonical_query(std::vector<std::pair<std::string, std::string>> query) {
+    for (auto& [name, value] : query) {
+        name = uri_encode(name, false);
+        value = uri_encode(value, false);
+    }
+    std::sort(query.begin(), query.end());
+    std::string text;
+    for (const auto& [name, value] : query) {
+        if (!text.empty()) {
+            text += '&';
+        }
+        text += name + '=' + value;
+    }
+    return text;
+}
+
+std::string sigv4_authorization(const SigV4Request& request, std::string_view access_key_id,
+                                std::string_view secret_access_key, std::string_view region,
+                                std::string_view service, std::string_view amz_date) {
+    auto headers = request.headers;
+    std::sort(headers.begin(), headers.end());
+    std::string canonical_headers;
+    std::string signed_headers;
+    for (const auto& [name, value] : headers) {
+        // Values are signed with surrounding whitespace trimmed
+        auto first = value.find_first_not_of(" \t");
+        auto last = value.find_last_not_of(" \t");
+        canonical_headers += name + ':' +
+                             (first == std::string::npos ? "" : value.substr(first, last - first + 1)) + '\n';
+        signed_headers += (signed_headers.empty() ? "" : ";") + name;
+    }
+    
+    std::string canonical_request = request.method + '\n' + request.canonical_uri + '\n' +
+                                    canonical_query(request.query) + '\n' + canonical_headers + '\n' +
+                                    signed_headers + '\n' + request.payload_hash;
+    
+    std::string date(amz_date.substr(0, 8));
+    std::string scope = date + '/' + std::string(region) + '/' + std::string(service) + "/aws4_request";
+    std::string string_to_sign = "AWS4-HMAC-SHA256\n" + std::string(amz_date) + '\n' + scope + '\n' +
+                                 sha256_hex(canonical_request);
+    
+    auto key = hmac_sha256("AWS4" + std::string(secret_access_key), date);
+    key = hmac_sha256(key, region);
+    key = hmac_sha256(key, service);
+    key = hmac_sha256(key, "aws4_request");
+    auto signature = hmac_sha256(key, string_to_sign);
+    
+    return "AWS4-HMAC-SHA256 Credential=" + std::string(access_key_id) + '/' + scope +
+           ", SignedHeaders=" + signed_headers +
+           ", Signature=" + to_hex(reinterpret_cast<const unsigned char*>(signature.data()), signature.size());
+}
+
+} // namespace detail
+} // namespace pxshot
@@ -0,0 +1,43 @@
+// Pxshot C++ SDK - AWS Signature Version 4 (internal)
+
+#ifndef PXSHOT_SIGV4_HPP
+#define PXSHOT_SIGV4_HPP
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace pxshot {
+namespace detail {
+
+/// Lower-case hex SHA-256 of `data`
+[[nodiscard]] std::string sha256_hex(std::string_view data);
+
+/// Percent-encode everything but RFC 3986 unreserved characters, and '/'
+/// too when `keep_slash` (for object key paths)
+[[nodiscard]] std::string uri_encode(std::string_view text, bool keep_slash);
+
+/// The parts of a request that SigV4 signs
+struct SigV4Request {
+    std::string method;
+    std::string canonical_uri;      // Already uri_encode()d path
+    std::vector<std::pair<std::string, std::string>> query;    // Raw, unsorted
+    std::vector<std::pair<std::string, std::string>> headers;  // Lower-case names, incl. host
+    std::string payload_hash;       // sha256_hex() of the body, as sent in x-amz-content-sha256
+};
+
+/// Authorization header value for `request`, signed at `amz_date`
+/// ("YYYYMMDDTHHMMSSZ", also sent as x-amz-date)
+[[nodiscard]] std::string sigv4_authorization(const SigV4Request& request, std::string_view access_key_id,
+                                              std::string_view secret_access_key, std::string_view region,
+                                              std::string_view service, std::string_view amz_date);
+
+/// Query string with the parameters sorted and encoded as SigV4 requires
+[[nodiscard]] std::string canonical_query(std::vector<std::pair<std::string, std::string>> query);
+
+} // namespace detail
+} // namespace pxshot
+
+#endif // PXSHOT_SIGV4_HPP
@@ -0,0 +1,85 @@
+// Pxshot C++ SDK - TCP_INFO sampling
+
+#include "tcp_info.hpp"
+#include "logger.hpp"
+
+#include <cstring>
+
+#ifdef __linux__
+#include <linux/tcp.h>      // Newer fields than <netinet/tcp.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#endif
+
+namespace pxshot {
+namespace detail {
+
+std::optional<TcpInfo> read_tcp_info(int fd) {
+#ifdef __linux__
+    if (fd < 0) {
+        return std::nullopt;
+    }
+    // Older kernels fill a prefix of the structure; the rest reads as zero
+    struct tcp_info raw;
+    std::memset(&raw, 0, sizeof(raw));
+    socklen_t length = sizeof(raw);
+    if (getsockopt(fd, IPPROTO_TCP, TCP_INFO, &raw, &length) != 0) {
+        return std::nullopt;
+    }
+    TcpInfo info;
+    info.rtt = std::chrono::microseconds(raw.tcpi_rtt);
+    info.rtt_variance = std::chrono::microseconds(raw.tcpi_rttvar);
+    info.receive_rtt = std::chrono::microseconds(raw.tcpi_rcv_rtt);
+    info.congestion_window = raw.tcpi_snd_cwnd;
+    info.mss = raw.tcpi_snd_mss;
+    info.retransmits = raw.tcpi_total_retrans;
+    info.segments_out = raw.tcpi_segs_out;
+    info.delivery_rate = raw.tcpi_delivery_rate;
+    info.bytes_received = raw.tcpi_bytes_received;
+    return info;
+#else
+    (void)fd;
+    return std::nullopt;
+#endif
+}
+
+bool TcpSampler::due() {
+    return sample_evenly(requests_, rate_);
+}
+
+std::optional<TcpInfo> TcpSampler::sample(int fd) {
+    auto info = read_tcp_info(fd);
+    if (!info) {
+        return info;
+    }
+    auto rtt = static_cast<uint64_t>(info->rtt.count());
+    samples_.fetch_add(1, std::memory_order_relaxed);
+    rtt_sum_us_.fetch_add(rtt, std::memory_order_relaxed);
+    auto max = rtt_max_us_.load(std::memory_order_relaxed);
+    while (rtt > max && !rtt_max_us_.compare_exchange_weak(max, rtt, std::memory_order_relaxed)) {
+    }
+    if (info->segments_out > 0) {
+        retransmit_ppm_sum_.fetch_add(uint64_t{info->retransmits} * 1'000'000 / info->segments_out,
+                                      std::memory_order_relaxed);
+    }
+    cwnd_sum_.fetch_add(info->congestion_window, std::memory_order_relaxed);
+    delivery_rate_sum_.fetch_add(info->delivery_rate, std::memory_order_relaxed);
+    return info;
+}
+
+void TcpSampler::fill(ClientStats& stats) const {
+    uint64_t samples = samples_.load(std::memory_order_relaxed);
+    stats.tcp_samples = samples;
+    if (samples == 0) {
+        return;
+    }
+    auto n = static_cast<double>(samples);
+    stats.tcp_rtt_mean = std::chrono::microseconds(rtt_sum_us_.load(std::memory_order_relaxed) / samples);
+    stats.tcp_rtt_max = std::chrono::microseconds(rtt_max_us_.load(std::memory_order_relaxed));
+    stats.tcp_retransmit_ratio = static_cast<double>(retransmit_ppm_sum_.load(std::memory_order_relaxed)) / 1e6 / n;
+    stats.tcp_cwnd_mean = static_cast<double>(cwnd_sum_.load(std::memory_order_relaxed)) / n;
+    stats.tcp_delivery_rate_mean = delivery_rate_sum_.load(std::memory_order_relaxed) / samples;
+}
+
+} // namespace detail
+} // namespace pxshot
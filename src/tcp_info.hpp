@@ -0,0 +1,47 @@
+// Pxshot C++ SDK - TCP_INFO sampling (internal)
+
+#ifndef PXSHOT_TCP_INFO_HPP
+#define PXSHOT_TCP_INFO_HPP
+
+#include "pxshot/pxshot.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <optional>
+
+namespace pxshot {
+namespace detail {
+
+/// The kernel's view of TCP socket `fd`; empty if it is not a TCP socket
+/// or the platform has no TCP_INFO (only Linux is supported)
+[[nodiscard]] std::optional<TcpInfo> read_tcp_info(int fd);
+
+/// Decides which requests to sample and sums the samples for stats()
+class TcpSampler {
+public:
+    explicit TcpSampler(double rate) : rate_(rate) {}
+    
+    /// Whether to sample the request about to be sent, by sample_evenly()
+    [[nodiscard]] bool due();
+    
+    /// Read `fd` and count the sample
+    [[nodiscard]] std::optional<TcpInfo> sample(int fd);
+    
+    /// Fill the tcp_* fields of `stats`
+    void fill(ClientStats& stats) const;
+
+private:
+    double rate_;
+    std::atomic<uint64_t> requests_{0};
+    std::atomic<uint64_t> samples_{0};
+    std::atomic<uint64_t> rtt_sum_us_{0};
+    std::atomic<uint64_t> rtt_max_us_{0};
+    std::atomic<uint64_t> retransmit_ppm_sum_{0};  // Retransmitted per million sent, per sample
+    std::atomic<uint64_t> cwnd_sum_{0};
+    std::atomic<uint64_t> delivery_rate_sum_{0};
+};
+
+} // namespace detail
+} // namespace pxshot
+
+#endif // PXSHOT_TCP_INFO_HPP
@@ -0,0 +1,259 @@
+// Pxshot C++ SDK - Arrow IPC file writer tests
+//
+// Files are read back with a minimal FlatBuffers reader following the
+// Arrow IPC file layout, so the test needs no Arrow libraries either.
+
+#include "test.hpp"
+#include "arrow_ipc.hpp"
+#include "pxshot/pxshot.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+using namespace pxshot;
+using namespace pxshot::detail;
+
+namespace {
+
+template <class T>
+T load(const std::string& data, size_t pos) {
+    T value{};
+    if (pos + sizeof(T) <= data.size()) {
+        std::memcpy(&value, data.data() + pos, sizeof(T));
+    } else {
+        pxshot::test::failures++;
+        std::printf("  read past the end at %zu\n", pos);
+    }
+    return value;
+}
+
+/// A FlatBuffers table at `pos` of `data`
+struct Table {
+    const std::string* data;
+    size_t pos;
+    
+    static Table root(const std::string& data, size_t start = 0) {
+        return {&data, start + load<uint32_t>(data, start)};
+    }
+    
+    /// Position of field `id`, or 0 when absent
+    [[nodiscard]] size_t field(int id) const {
+        size_t vtable = pos - static_cast<size_t>(load<int32_t>(*data, pos));
+        auto slot = static_cast<size_t>(4 + 2 * id);
+        if (slot >= load<uint16_t>(*data, vtable)) {
+            return 0;
+        }
+        auto offset = load<uint16_t>(*data, vtable + slot);
+        return offset == 0 ? 0 : pos + offset;
+    }
+    
+    template <class T>
+    [[nodiscard]] T scalar(int id, T fallback = 0) const {
+        size_t at = field(id);
+        return at == 0 ? fallback : load<T>(*data, at);
+    }
+    
+    /// Position of what field `id` refers to
+    [[nodiscard]] size_t target(int id) const {
+        size_t at = field(id);
+        return at + load<uint32_t>(*data, at);
+    }
+    
+    [[nodiscard]] Table table(int id) const { return {data, target(id)}; }
+    
+    [[nodiscard]] std::string string(int id) const {
+        size_t at = target(id);
+        return data->substr(at + 4, load<uint32_t>(*data, at));
+    }
+    
+    [[nodiscard]] uint32_t count(int id) const { return load<uint32_t>(*data, target(id)); }
+    
+    /// Element `i` of a vector of tables
+    [[nodiscard]] Table element(int id, size_t i) const {
+        size_t at = target(id) + 4 + 4 * i;
+        return {data, at + load<uint32_t>(*data, at)};
+    }
+    
+    /// Position of element `i` of a vector of structs
+    [[nodiscard]] size_t struct_at(int id, size_t i, size_t size) const { return target(id) + 4 + size * i; }
+};
+
+std::string read_file(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+std::string temp_path(const char* name) {
+    return "/tmp/pxshot_" + std::string(name) + ".arrow";
+}
+
+std::vector<ArrowField> schema() {
+    return {{"url", ArrowType::Utf8, true},
+            {"status", ArrowType::Int32},
+            {"bytes", ArrowType::Int64},
+            {"latency_ms", ArrowType::Float64},
+            {"captured_at", ArrowType::TimestampMs},
+            {"digest", ArrowType::FixedBinary, false, 4}};
+}
+
+std::vector<ArrowColumn> columns() {
+    std::vector<ArrowColumn> columns;
+    for (auto& field : schema()) {
+        columns.emplace_back(field);
+    }
+    return columns;
+}
+
+void append_row(std::vector<ArrowColumn>& columns, const char* url, int64_t row) {
+    if (url) {
+        columns[0].append(std::string_view(url));
+    } else {
+        columns[0].append_null();
+    }
+    columns[1].append(int64_t{200} + row);
+    columns[2].append(int64_t{1} << (40 + row));
+    columns[3].append(0.5 + static_cast<double>(row));
+    columns[4].append(int64_t{1700000000000} + row);
+    columns[5].append(std::string_view("\x01\x02\x03\x04", 4));
+}
+
+} // namespace
+
+TEST_CASE(file_layout) {
+    auto path = temp_path("layout");
+    ArrowFileWriter writer(path, schema());
+    auto batch = columns();
+    append_row(batch, "https://a.example/", 0);
+    append_row(batch, nullptr, 1);
+    append_row(batch, "https://bb.example/", 2);
+    writer.write_batch(batch);
+    for (auto& column : batch) {
+        column.clear();
+    }
+    append_row(batch, "https://c.example/", 3);
+    writer.write_batch(batch);
+    writer.close();
+    CHECK(!writer.is_open());
+    
+    auto file = read_file(path);
+    std::remove(path.c_str());
+    CHECK(file.compare(0, 8, std::string("ARROW1\0\0", 8)) == 0);
+    CHECK(file.compare(file.size() - 6, 6, "ARROW1") == 0);
+    
+    auto footer_length = load<int32_t>(file, file.size() - 10);
+    auto footer = Table::root(file, file.size() - 10 - static_cast<size_t>(footer_length));
+    CHECK(footer.scalar<int16_t>(0) == 4);         // MetadataVersion V5
+    
+    auto footer_schema = footer.table(1);
+    CHECK(footer_schema.count(1) == 6);
+    const char* names[] = {"url", "status", "bytes", "latency_ms", "captured_at", "digest"};
+    const uint8_t types[] = {5, 2, 2, 3, 10, 15};
+    for (size_t i = 0; i < 6; ++i) {
+        auto field = footer_schema.element(1, i);
+        CHECK(field.string(0) == names[i]);
+        CHECK(field.scalar<uint8_t>(1) == (i == 0 ? 1 : 0));
+        CHECK(field.scalar<uint8_t>(2) == types[i]);
+    }
+    CHECK(footer_schema.element(1, 1).table(3).scalar<int32_t>(0) == 32);
+    CHECK(footer_schema.element(1, 2).table(3).scalar<int32_t>(0) == 64);
+    CHECK(footer_schema.element(1, 4).table(3).string(1) == "UTC");
+    CHECK(footer_schema.element(1, 5).table(3).scalar<int32_t>(0) == 4);
+    
+    // Blocks: offset, metadata length including its prefix, body length
+    CHECK(footer.count(3) == 2);
+    const int64_t rows[] = {3, 1};
+    for (size_t b = 0; b < 2; ++b) {
+        size_t block = footer.struct_at(3, b, 24);
+        auto offset = static_cast<size_t>(load<int64_t>(file, block));
+        auto metadata_length = load<int32_t>(file, block + 8);
+        auto body_length = load<int64_t>(file, block + 16);
+        CHECK(offset % 8 == 0);
+        CHECK(metadata_length % 8 == 0);
+        CHECK(load<uint32_t>(file, offset) == 0xFFFFFFFF);
+        CHECK(load<int32_t>(file, offset + 4) == metadata_length - 8);
+        
+        auto message = Table::root(file, offset + 8);
+        CHECK(message.scalar<int16_t>(0) == 4);
+        CHECK(message.scalar<uint8_t>(1) == 3);        // RecordBatch
+        CHECK(message.scalar<int64_t>(3) == body_length);
+        
+        auto record_batch = message.table(2);
+        CHECK(record_batch.scalar<int64_t>(0) == rows[b]);
+        CHECK(record_batch.count(1) == 6);
+        CHECK(load<int64_t>(file, record_batch.struct_at(1, 0, 16)) == rows[b]);
+        CHECK(load<int64_t>(file, record_batch.struct_at(1, 0, 16) + 8) == (b == 0 ? 1 : 0));
+        
+        // Validity, offsets and values for the strings, then validity and
+        // values for each of the other five
+        CHECK(record_batch.count(2) == 13);
+        size_t body = offset + static_cast<size_t>(metadata_length);
+        auto buffer = [&](size_t i) {
+            size_t at = record_batch.struct_at(2, i, 16);
+            return file.substr(body + static_cast<size_t>(load<int64_t>(file, at)),
+                               static_cast<size_t>(load<int64_t>(file, at + 8)));
+        };
+        for (size_t i = 0; i < 13; ++i) {
+            CHECK(load<int64_t>(file, record_batch.struct_at(2, i, 16)) % 8 == 0);
+        }
+        if (b == 0) {
+            CHECK(buffer(0) == std::string(1, '\x05'));        // Row 1 is null
+            CHECK(buffer(2) == "https://a.example/https://bb.example/");
+            CHECK(load<int32_t>(buffer(1), 12) == 37);
+            CHECK(buffer(3).empty());                           // No nulls, no validity
+            CHECK(load<int32_t>(buffer(4), 8) == 202);
+            CHECK(load<int64_t>(buffer(6), 16) == int64_t{1} << 42);
+            CHECK(load<double>(buffer(8), 8) == 1.5);
+            CHECK(load<int64_t>(buffer(10), 0) == 1700000000000);
+            CHECK(buffer(12) == std::string("\x01\x02\x03\x04\x01\x02\x03\x04\x01\x02\x03\x04"));
+        } else {
+            CHECK(buffer(0).empty());
+            CHECK(buffer(2) == "https://c.example/");
+            CHECK(load<int64_t>(buffer(10), 0) == 1700000000003);
+        }
+    }
+    
+    // The schema message opens the stream and end-of-stream closes it
+    auto schema_message = Table::root(file, 16);
+    CHECK(load<uint32_t>(file, 8) == 0xFFFFFFFF);
+    CHECK(schema_message.scalar<uint8_t>(1) == 1);
+    size_t footer_start = file.size() - 10 - static_cast<size_t>(footer_length);
+    CHECK(load<uint32_t>(file, footer_start - 8) == 0xFFFFFFFF);
+    CHECK(load<uint32_t>(file, footer_start - 4) == 0);
+}
+
+TEST_CASE(column_buffers_reused) {
+    ArrowColumn column({"url", ArrowType::Utf8, true});
+    column.append(std::string_view("abc"));
+    column.append_null();
+    CHECK(column.length() == 2);
+    CHECK(column.null_count() == 1);
+    CHECK(column.bytes() == 1 + 3 * 4 + 3);
+    column.clear();
+    CHECK(column.length() == 0);
+    CHECK(column.buffers().size() == 3);
+    CHECK(column.buffers()[1].size() == 4);        // The leading zero offset
+}
+
+TEST_CASE(mismatched_values_rejected) {
+    ArrowColumn ints({"n", ArrowType::Int32});
+    CHECK_THROWS(ints.append(1.0), Error);
+    CHECK_THROWS(ints.append(std::string_view("x")), Error);
+    ArrowColumn digest({"d", ArrowType::FixedBinary, false, 4});
+    CHECK_THROWS(digest.append(std::string_view("abc")), Error);
+    CHECK_THROWS(digest.append(int64_t{1}), Error);
+    
+    auto path = temp_path("mismatched");
+    ArrowFileWriter writer(path, schema());
+    auto batch = columns();
+    CHECK_THROWS(writer.write_batch({batch[0]}), Error);
+    append_row(batch, "x", 0);
+    batch[1].append(int64_t{1});
+    CHECK_THROWS(writer.write_batch(batch), Error);
+    writer.close();
+    std::remove(path.c_str());
+    
+    CHECK_THROWS(ArrowFileWriter("/nonexistent/dir/file.arrow", schema()), Error);
+}
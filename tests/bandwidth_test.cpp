@@ -0,0 +1,82 @@
+// Pxshot C++ SDK - Bandwidth shaping tests
+
+#include "test.hpp"
+#include "bandwidth.hpp"
+
+#include <chrono>
+#include <thread>
+
+using namespace pxshot;
+using detail::BandwidthLimiter;
+using detail::TokenBucket;
+
+namespace {
+
+double seconds(TokenBucket::Clock::duration d) {
+    return std::chrono::duration<double>(d).count();
+}
+
+} // namespace
+
+TEST_CASE(unlimited_never_waits) {
+    TokenBucket bucket;
+    CHECK(bucket.take(1 << 30) == TokenBucket::Clock::duration::zero());
+    bucket.configure(0, 0);
+    CHECK(bucket.take(1 << 30) == TokenBucket::Clock::duration::zero());
+}
+
+TEST_CASE(debt_accumulates) {
+    // Buckets start empty, so every byte is owed at the configured rate
+    TokenBucket bucket(1000, 1000);
+    CHECK_NEAR(seconds(bucket.take(500)), 0.5, 0.01);
+    CHECK_NEAR(seconds(bucket.take(500)), 1.0, 0.01);
+    CHECK_NEAR(seconds(bucket.take(2000)), 3.0, 0.01);
+}
+
+TEST_CASE(refill_capped_at_burst) {
+    TokenBucket bucket(100'000, 1000);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    // 5000 tokens' worth of time has passed, but only 1000 fit
+    CHECK(bucket.take(1000) == TokenBucket::Clock::duration::zero());
+    CHECK_NEAR(seconds(bucket.take(1000)), 0.01, 0.005);
+}
+
+TEST_CASE(reconfigure_trims_tokens) {
+    TokenBucket bucket(100'000, 10'000);
+    std::this_thread::sleep_for(std::chrono::milliseconds(150));
+    CHECK(bucket.take(0) == TokenBucket::Clock::duration::zero());     // Refills to the burst
+    bucket.configure(1000, 100);
+    CHECK(bucket.take(100) == TokenBucket::Clock::duration::zero());
+    CHECK_NEAR(seconds(bucket.take(100)), 0.1, 0.01);
+}
+
+TEST_CASE(limiter_disabled_without_rate) {
+    BandwidthLimiter limiter(BandwidthLimit{});
+    CHECK(!limiter.enabled());
+    auto start = std::chrono::steady_clock::now();
+    limiter.consume(Priority::Batch, size_t{1} << 30);
+    CHECK(std::chrono::steady_clock::now() - start < std::chrono::milliseconds(50));
+    
+    limiter.configure(BandwidthLimit{1'000'000});
+    CHECK(limiter.enabled());
+    limiter.configure(BandwidthLimit{-5});
+    CHECK(!limiter.enabled());
+}
+
+TEST_CASE(limiter_honours_class_share) {
+    // Batch may use a tenth of 4 MB/s; 40 KB then takes about 0.1 s,
+    // while interactive transfers are held only by the shared cap
+    BandwidthLimiter limiter(BandwidthLimit{4'000'000, 1.0, 0.1});
+    auto start = std::chrono::steady_clock::now();
+    limiter.consume(Priority::Batch, 40'000);
+    double batch = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    CHECK(batch >= 0.095);
+    CHECK(batch < 0.3);
+    
+    limiter.configure(BandwidthLimit{4'000'000, 1.0, 0.1});
+    start = std::chrono::steady_clock::now();
+    limiter.consume(Priority::Interactive, 40'000);
+    double interactive = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    CHECK(interactive >= 0.0095);
+    CHECK(interactive < batch);
+}
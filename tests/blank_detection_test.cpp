@@ -0,0 +1,137 @@
+// Pxshot C++ SDK - Blank page detection tests
+
+#include "test.hpp"
+#include "test_images.hpp"
+#include "blank_detection.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <random>
+
+using namespace pxshot;
+using namespace pxshot::test;
+
+namespace {
+
+detail::Preview filled(size_t pixels, uint8_t red, uint8_t green, uint8_t blue) {
+    detail::Preview preview;
+    preview.width = static_cast<int>(pixels);
+    preview.height = 1;
+    preview.red.assign(pixels, red);
+    preview.green.assign(pixels, green);
+    preview.blue.assign(pixels, blue);
+    return preview;
+}
+
+} // namespace
+
+TEST_CASE(measure_uniform) {
+    auto check = detail::measure(filled(1000, 255, 255, 255), 0);
+    CHECK(check.luma_variance == 0);
+    CHECK(check.dominant_color == 0xFFFFFF);
+    CHECK(check.dominant_share == 1);
+}
+
+TEST_CASE(measure_matches_scalar) {
+    // Odd sizes exercise the SIMD kernels' tails
+    std::mt19937 rng(3);
+    for (int trial = 0; trial < 200; ++trial) {
+        size_t pixels = 1 + rng() % 5000;
+        int tolerance = static_cast<int>(rng() % 40);
+        bool noisy = trial % 2 == 0;
+        detail::Preview preview;
+        for (size_t i = 0; i < pixels; ++i) {
+            auto value = [&] {
+                return noisy ? static_cast<uint8_t>(rng()) : static_cast<uint8_t>(180 + rng() % 41);
+            };
+            preview.red.push_back(value());
+            preview.green.push_back(value());
+            preview.blue.push_back(value());
+        }
+        auto check = detail::measure(preview, tolerance);
+        
+        double sum = 0;
+        double squares = 0;
+        for (size_t i = 0; i < pixels; ++i) {
+            int luma = (77 * preview.red[i] + 150 * preview.green[i] + 29 * preview.blue[i]) >> 8;
+            sum += luma;
+            squares += double(luma) * luma;
+        }
+        double mean = sum / double(pixels);
+        double variance = std::max(0.0, squares / double(pixels) - mean * mean);
+        CHECK_NEAR(check.luma_variance, variance, 1e-6 * std::max(1.0, variance));
+        
+        int red = check.dominant_color >> 16 & 0xFF;
+        int green = check.dominant_color >> 8 & 0xFF;
+        int blue = check.dominant_color & 0xFF;
+        size_t near = 0;
+        for (size_t i = 0; i < pixels; ++i) {
+            near += std::abs(preview.red[i] - red) <= tolerance && std::abs(preview.green[i] - green) <= tolerance &&
+                    std::abs(preview.blue[i] - blue) <= tolerance;
+        }
+        CHECK_NEAR(check.dominant_share, double(near) / double(pixels), 1e-12);
+    }
+}
+
+TEST_CASE(measure_mostly_one_colour) {
+    // An error page: white background with a little dark text
+    auto preview = filled(10000, 250, 250, 250);
+    std::fill(preview.red.begin(), preview.red.begin() + 100, 20);
+    std::fill(preview.green.begin(), preview.green.begin() + 100, 20);
+    std::fill(preview.blue.begin(), preview.blue.begin() + 100, 20);
+    auto check = detail::measure(preview, 16);
+    CHECK(check.dominant_color == 0xFAFAFA);
+    CHECK_NEAR(check.dominant_share, 0.99, 1e-12);
+    CHECK(check.luma_variance > 4);
+}
+
+TEST_CASE(detector_rejects_bad_config) {
+    BlankDetection config;
+    config.max_variance = -1;
+    CHECK_THROWS(detail::BlankDetector{config}, ValidationError);
+    config = {};
+    config.min_dominant_share = 0;
+    CHECK_THROWS(detail::BlankDetector{config}, ValidationError);
+    config = {};
+    config.tolerance = 256;
+    CHECK_THROWS(detail::BlankDetector{config}, ValidationError);
+    config = {};
+    config.retries = -1;
+    CHECK_THROWS(detail::BlankDetector{config}, ValidationError);
+}
+
+TEST_CASE(detector_verdicts) {
+    BlankDetection config;
+    config.enabled = true;
+    config.action = BlankAction::Retry;
+    config.retries = 2;
+    detail::BlankDetector detector(config);
+    
+    // A mid-grey JPEG is uniform
+    auto blank = detector.check(grey_jpeg(8, 0, 1));
+    CHECK(blank.verdict == BlankVerdict::Blank);
+    CHECK(detector.retry_due(blank, 0));
+    CHECK(detector.retry_due(blank, 1));
+    CHECK(!detector.retry_due(blank, 2));
+    
+    // Bytes that are not an image are not checked, nor counted
+    auto unknown = detector.check({1, 2, 3, 4});
+    CHECK(unknown.verdict == BlankVerdict::NotChecked);
+    CHECK(!detector.retry_due(unknown, 0));
+    
+    detector.count_retry();
+    ClientStats stats;
+    detector.fill(stats);
+    CHECK(stats.blank_checked == 1);
+    CHECK(stats.blank_detected == 1);
+    CHECK(stats.blank_retries == 1);
+}
+
+TEST_CASE(flag_action_never_retries) {
+    BlankDetection config;
+    config.enabled = true;
+    detail::BlankDetector detector(config);
+    auto blank = detector.check(grey_jpeg(8, 0, 1));
+    CHECK(blank.verdict == BlankVerdict::Blank);
+    CHECK(!detector.retry_due(blank, 0));
+}
@@ -0,0 +1,116 @@
+// Pxshot C++ SDK - Cost model tests
+
+#include "test.hpp"
+#include "cost_model.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <string>
+#include <thread>
+
+using namespace pxshot;
+using detail::CostModel;
+using detail::host_of;
+
+namespace {
+
+ScreenshotOptions on(const std::string& host) {
+    ScreenshotOptions options;
+    options.url = "https://" + host + "/page";
+    return options;
+}
+
+} // namespace
+
+TEST_CASE(hosts) {
+    CHECK(host_of("https://Example.COM/path") == "example.com");
+    CHECK(host_of("http://user:pw@example.com:8080?q") == "example.com");
+    CHECK(host_of("https://[2001:DB8::1]:443/") == "[2001:db8::1]");
+    CHECK(host_of("example.com/path").empty());
+}
+
+TEST_CASE(prior_from_options) {
+    auto options = on("example.com");
+    auto base = CostModel::prior(options);
+    CHECK(base.latency_ms == 2000);                  // Load adds 500 to 1500
+    CHECK(base.stddev_ms == 1000);
+    CHECK(base.samples == 0);
+    CHECK_NEAR(base.bytes, 1280.0 * 720 * 0.6, 1e-6);
+    
+    options.full_page = true;
+    options.wait_for_timeout = 250;
+    CHECK(CostModel::prior(options).latency_ms == 4250);
+    
+    options = on("example.com");
+    options.format = Format::JPEG;
+    options.quality = 50;
+    CHECK_NEAR(CostModel::prior(options).bytes, 1280.0 * 720 * 0.15, 1e-6);
+    
+    options.store = true;
+    CHECK(CostModel::prior(options).bytes == 512);
+}
+
+TEST_CASE(ewma_mean_and_variance) {
+    CostModel model;
+    auto options = on("example.com");
+    model.record(options, 100, 1000);
+    auto e = model.estimate(options);
+    CHECK(e.latency_ms == 100);
+    CHECK(e.stddev_ms == 0);
+    CHECK(e.bytes == 1000);
+    CHECK(e.samples == 1);
+    
+    // delta 100: mean 100 + 0.2 * 100, variance 0.8 * (0.2 * 100²)
+    model.record(options, 200, 2000);
+    e = model.estimate(options);
+    CHECK_NEAR(e.latency_ms, 120, 1e-9);
+    CHECK_NEAR(e.stddev_ms, 40, 1e-9);
+    CHECK_NEAR(e.bytes, 1200, 1e-9);
+    CHECK(e.samples == 2);
+    
+    // No surprise decays the variance
+    model.record(options, 120, 1200);
+    e = model.estimate(options);
+    CHECK_NEAR(e.latency_ms, 120, 1e-9);
+    CHECK_NEAR(e.stddev_ms, std::sqrt(1280.0), 1e-9);
+}
+
+TEST_CASE(ewma_converges) {
+    CostModel model;
+    auto options = on("example.com");
+    model.record(options, 5000, 0);
+    for (int i = 0; i < 100; ++i) {
+        model.record(options, 300, 0);
+    }
+    auto e = model.estimate(options);
+    CHECK_NEAR(e.latency_ms, 300, 1e-3);
+    CHECK(e.stddev_ms < 0.1);
+}
+
+TEST_CASE(fallbacks) {
+    CostModel model;
+    model.record(on("a.example"), 800, 4000);
+    
+    // Same shape elsewhere borrows the shape's history, without samples
+    auto e = model.estimate(on("b.example"));
+    CHECK(e.latency_ms == 800);
+    CHECK(e.samples == 0);
+    
+    // Another shape has no history at all
+    auto full = on("a.example");
+    full.full_page = true;
+    e = model.estimate(full);
+    CHECK(e.latency_ms == CostModel::prior(full).latency_ms);
+    CHECK(e.samples == 0);
+}
+
+TEST_CASE(oldest_host_evicted) {
+    CostModel model;
+    model.record(on("first.example"), 100, 0);
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    for (int i = 0; i < 4096; ++i) {
+        model.record(on("host" + std::to_string(i) + ".example"), 100, 0);
+    }
+    CHECK(model.estimate(on("first.example")).samples == 0);
+    CHECK(model.estimate(on("host4095.example")).samples == 1);
+}
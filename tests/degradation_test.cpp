@@ -0,0 +1,179 @@
+// Pxshot C++ SDK - Degradation tests
+
+#include "test.hpp"
+#include "degradation.hpp"
+
+#include <chrono>
+
+using namespace pxshot;
+using detail::Degrader;
+
+namespace {
+
+using std::chrono::milliseconds;
+
+DegradationPolicy on_errors(double error_rate, size_t window) {
+    DegradationRule rule;
+    rule.error_rate = error_rate;
+    rule.disable_full_page = true;
+    DegradationPolicy policy;
+    policy.rules.push_back(rule);
+    policy.error_window = window;
+    return policy;
+}
+
+} // namespace
+
+TEST_CASE(error_rate_waits_for_outcomes) {
+    Degrader degrader(on_errors(0.5, 100));
+    for (int i = 0; i < 9; ++i) {
+        degrader.record_outcome(true);
+    }
+    CHECK(degrader.triggered() == 0);      // 9 of kMinOutcomes = 10
+    degrader.record_outcome(false);
+    CHECK(degrader.triggered() == 1);      // 9 of 10 failed
+    
+    // A window smaller than kMinOutcomes needs only a full window
+    Degrader small(on_errors(0.5, 4));
+    for (int i = 0; i < 3; ++i) {
+        small.record_outcome(true);
+    }
+    CHECK(small.triggered() == 0);
+    small.record_outcome(true);
+    CHECK(small.triggered() == 1);
+}
+
+TEST_CASE(error_ring_wraps) {
+    Degrader degrader(on_errors(0.5, 10));
+    for (int i = 0; i < 10; ++i) {
+        degrader.record_outcome(true);
+    }
+    CHECK(degrader.triggered() == 1);
+    
+    // Successes overwrite the oldest failures: 5 of 10 still trigger, 4 do not
+    for (int i = 0; i < 5; ++i) {
+        degrader.record_outcome(false);
+    }
+    CHECK(degrader.triggered() == 1);
+    degrader.record_outcome(false);
+    CHECK(degrader.triggered() == 0);
+    
+    // Around the ring again, failures back in
+    for (int i = 0; i < 14; ++i) {
+        degrader.record_outcome(false);
+    }
+    for (int i = 0; i < 5; ++i) {
+        degrader.record_outcome(true);
+    }
+    CHECK(degrader.triggered() == 1);
+}
+
+TEST_CASE(queue_wait_triggers) {
+    DegradationPolicy policy;
+    DegradationRule light;
+    light.queue_wait = milliseconds(100);
+    light.wait_until = WaitUntil::DOMContentLoaded;
+    DegradationRule heavy;
+    heavy.queue_wait = milliseconds(1000);
+    heavy.max_device_scale_factor = 1.0;
+    policy.rules = {light, heavy};
+    Degrader degrader(policy);
+    
+    CHECK(degrader.triggered() == 0);
+    degrader.record_queue_wait(milliseconds(99));
+    CHECK(degrader.triggered() == 0);
+    degrader.record_queue_wait(milliseconds(100));
+    CHECK(degrader.triggered() == 0b01);
+    degrader.record_queue_wait(milliseconds(2500));
+    CHECK(degrader.triggered() == 0b11);
+    degrader.record_queue_wait(milliseconds(0));       // Queue emptied
+    CHECK(degrader.triggered() == 0);
+    
+    // Failures never trigger a rule without an error_rate
+    for (int i = 0; i < 100; ++i) {
+        degrader.record_outcome(true);
+    }
+    CHECK(degrader.triggered() == 0);
+}
+
+TEST_CASE(relax_merges_rules) {
+    DegradationPolicy policy;
+    DegradationRule first;
+    first.queue_wait = milliseconds(100);
+    first.max_device_scale_factor = 1.5;
+    first.wait_until = WaitUntil::Load;
+    first.max_wait_for_timeout = 2000;
+    DegradationRule second;
+    second.queue_wait = milliseconds(100);
+    second.max_device_scale_factor = 1.0;
+    second.disable_full_page = true;
+    second.wait_until = WaitUntil::DOMContentLoaded;
+    second.max_wait_for_timeout = 5000;
+    policy.rules = {first, second};
+    Degrader degrader(policy);
+    
+    ScreenshotOptions options;
+    options.url = "https://example.com";
+    options.device_scale_factor = 2.0;
+    options.full_page = true;
+    options.wait_until = WaitUntil::NetworkIdle;
+    options.wait_for_timeout = 3000;
+    
+    Degradation applied;
+    auto relaxed = degrader.relax(options, 0b11, applied);
+    CHECK(relaxed.has_value());
+    if (relaxed) {
+        // The cheapest setting of either rule wins
+        CHECK(relaxed->device_scale_factor == 1.0);
+        CHECK(relaxed->full_page == false);
+        CHECK(relaxed->wait_until == WaitUntil::DOMContentLoaded);
+        CHECK(relaxed->wait_for_timeout == 2000);
+        CHECK(relaxed->url == options.url);
+    }
+    CHECK(applied.device_scale_factor && applied.full_page && applied.wait_until && applied.wait_for_timeout);
+    
+    // Only the first rule; full_page is left alone
+    relaxed = degrader.relax(options, 0b01, applied);
+    CHECK(relaxed && relaxed->device_scale_factor == 1.5 && relaxed->full_page == true);
+    CHECK(applied.device_scale_factor && !applied.full_page && applied.wait_until && applied.wait_for_timeout);
+    
+    // Options already as cheap as the rules change nothing
+    ScreenshotOptions cheap;
+    cheap.url = "https://example.com";
+    cheap.wait_until = WaitUntil::Commit;
+    CHECK(!degrader.relax(cheap, 0b11, applied));
+    CHECK(!applied.any());
+    CHECK(!degrader.relax(options, 0, applied));
+    CHECK(!applied.any());
+    
+    ClientStats stats;
+    degrader.enter(0b11);
+    degrader.fill(stats);
+    CHECK(stats.degrading);
+    CHECK(stats.degraded_requests == 2);
+    CHECK(degrader.enter(0) == 0b11);
+    degrader.fill(stats);
+    CHECK(!stats.degrading);
+}
+
+TEST_CASE(validation) {
+    CHECK(!Degrader(DegradationPolicy{}).enabled());
+    CHECK(Degrader(on_errors(0.5, 1)).enabled());
+    CHECK_THROWS(Degrader(on_errors(0.5, 0)), ValidationError);
+    CHECK_THROWS(Degrader(on_errors(1.5, 10)), ValidationError);
+    CHECK_THROWS(Degrader(on_errors(-0.1, 10)), ValidationError);
+    
+    DegradationPolicy policy;
+    policy.rules.resize(Degrader::kMaxRules + 1);
+    CHECK_THROWS(Degrader(policy), ValidationError);
+    
+    policy.rules.assign(1, DegradationRule{});
+    policy.rules[0].queue_wait = milliseconds(-1);
+    CHECK_THROWS(Degrader(policy), ValidationError);
+    policy.rules.assign(1, DegradationRule{});
+    policy.rules[0].max_device_scale_factor = 0.0;
+    CHECK_THROWS(Degrader(policy), ValidationError);
+    policy.rules.assign(1, DegradationRule{});
+    policy.rules[0].max_wait_for_timeout = -1;
+    CHECK_THROWS(Degrader(policy), ValidationError);
+}
@@ -0,0 +1,89 @@
+// Pxshot C++ SDK - Frequency sketch tests
+
+#include "test.hpp"
+#include "frequency_sketch.hpp"
+
+#include <functional>
+#include <string>
+
+using pxshot::detail::FrequencySketch;
+
+namespace {
+
+uint64_t hash_of(int key) {
+    return std::hash<std::string>{}("key" + std::to_string(key));
+}
+
+} // namespace
+
+TEST_CASE(doorkeeper_then_counters) {
+    FrequencySketch sketch;
+    CHECK(sketch.frequency(hash_of(1)) == 0);
+    sketch.increment(hash_of(1));
+    CHECK(sketch.frequency(hash_of(1)) == 1);
+    for (int i = 0; i < 4; ++i) {
+        sketch.increment(hash_of(1));
+    }
+    CHECK(sketch.frequency(hash_of(1)) == 5);
+}
+
+TEST_CASE(counts_saturate) {
+    FrequencySketch sketch;
+    for (int i = 0; i < 100; ++i) {
+        sketch.increment(hash_of(1));
+    }
+    CHECK(sketch.frequency(hash_of(1)) == 16);
+}
+
+TEST_CASE(distinguishes_keys) {
+    // Well within capacity, collisions rarely lift a key that was never seen
+    FrequencySketch sketch;
+    sketch.ensure_capacity(1000);
+    for (int key = 0; key < 200; ++key) {
+        for (int i = 0; i <= key % 8; ++i) {
+            sketch.increment(hash_of(key));
+        }
+    }
+    int exact = 0;
+    for (int key = 0; key < 200; ++key) {
+        int count = sketch.frequency(hash_of(key));
+        CHECK(count >= key % 8 + 1);
+        exact += count == key % 8 + 1;
+    }
+    CHECK(exact >= 190);
+    int phantoms = 0;
+    for (int key = 1000; key < 2000; ++key) {
+        phantoms += sketch.frequency(hash_of(key)) > 0;
+    }
+    CHECK(phantoms < 50);
+}
+
+TEST_CASE(growth_keeps_counts) {
+    FrequencySketch sketch;
+    for (int key = 0; key < 100; ++key) {
+        for (int i = 0; i < 6; ++i) {
+            sketch.increment(hash_of(key));
+        }
+    }
+    sketch.ensure_capacity(5000);
+    sketch.ensure_capacity(100'000);
+    for (int key = 0; key < 100; ++key) {
+        CHECK(sketch.frequency(hash_of(key)) >= 6);
+    }
+    sketch.increment(hash_of(0));
+    CHECK(sketch.frequency(hash_of(0)) >= 7);
+}
+
+TEST_CASE(aging_halves_counts) {
+    // The minimum capacity of 256 keys ages every 2560 additions
+    FrequencySketch sketch;
+    for (int i = 0; i < 13; ++i) {
+        sketch.increment(hash_of(1));
+    }
+    CHECK(sketch.frequency(hash_of(1)) == 13);
+    for (int i = 0; i < 2560 - 13; ++i) {
+        sketch.increment(hash_of(100'000 + i));
+    }
+    // 12 counted plus the doorkeeper's one, halved with the doorkeeper cleared
+    CHECK(sketch.frequency(hash_of(1)) == 6);
+}
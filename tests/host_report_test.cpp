@@ -0,0 +1,93 @@
+// Pxshot C++ SDK - Host report tests
+
+#include "test.hpp"
+#include "host_report.hpp"
+
+#include <cmath>
+
+using namespace pxshot;
+using detail::LogHistogram;
+
+TEST_CASE(empty_histogram) {
+    LogHistogram histogram;
+    auto d = histogram.summary();
+    CHECK(d.count == 0);
+    CHECK(d.p50 == 0 && d.p99 == 0 && d.max == 0);
+}
+
+TEST_CASE(quantiles_of_known_samples) {
+    // 1 to 10000: the true p50 is 5000, p90 9000 and p99 9900
+    LogHistogram histogram;
+    for (int i = 1; i <= 10000; ++i) {
+        histogram.add(i);
+    }
+    auto d = histogram.summary();
+    CHECK(d.count == 10000);
+    CHECK_NEAR(d.mean, 5000.5, 1e-9);
+    CHECK(d.max == 10000);
+    CHECK_NEAR(d.p50, 5000, 5000 * 0.0625);
+    CHECK_NEAR(d.p90, 9000, 9000 * 0.0625);
+    CHECK_NEAR(d.p99, 9900, 9900 * 0.0625);
+    
+    // A long tail: 2% of requests take 50 times as long
+    LogHistogram tail;
+    for (int i = 0; i < 980; ++i) {
+        tail.add(120);
+    }
+    for (int i = 0; i < 20; ++i) {
+        tail.add(6000);
+    }
+    d = tail.summary();
+    CHECK_NEAR(d.p50, 120, 120 * 0.0625);
+    CHECK_NEAR(d.p99, 6000, 6000 * 0.0625);
+}
+
+TEST_CASE(every_value_within_bucket_error) {
+    // A midpoint is at most half a bucket, 1/16 of the octave's base, from
+    // any value in its bucket. The larger value keeps max from clamping.
+    for (double value = 1; value < 1e14; value *= 1.37) {
+        LogHistogram histogram;
+        histogram.add(value);
+        histogram.add(value);
+        histogram.add(1e15);
+        CHECK_NEAR(histogram.summary().p50, value, value * 0.0625);
+    }
+}
+
+TEST_CASE(values_below_one) {
+    LogHistogram histogram;
+    for (int i = 0; i < 3; ++i) {
+        histogram.add(0.25);
+    }
+    histogram.add(100);
+    auto d = histogram.summary();
+    CHECK(d.p50 == 0.5);        // Bucket 0's midpoint
+    CHECK_NEAR(d.mean, (0.75 + 100) / 4, 1e-12);
+    
+    // Never above the largest value seen
+    LogHistogram small;
+    small.add(0.25);
+    small.add(0);
+    small.add(-3);
+    d = small.summary();
+    CHECK(d.p50 == 0.25 && d.p99 == 0.25 && d.max == 0.25);
+}
+
+TEST_CASE(overflow_bucket) {
+    // Beyond 2^48, values share the top bucket, which reads as the maximum
+    LogHistogram histogram;
+    histogram.add(10);
+    for (int i = 0; i < 3; ++i) {
+        histogram.add(1e15);
+    }
+    histogram.add(1e18);
+    auto d = histogram.summary();
+    CHECK(d.p50 == 1e18);
+    CHECK(d.p99 == 1e18);
+    CHECK(d.max == 1e18);
+    
+    LogHistogram top;
+    top.add(std::ldexp(1.0, 47) * 1.99);
+    top.add(std::ldexp(1.0, 47) * 1.95);
+    CHECK(top.summary().p50 == std::ldexp(1.0, 47) * 1.99);
+}
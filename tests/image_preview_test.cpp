@@ -0,0 +1,117 @@
+// Pxshot C++ SDK - Image preview tests
+
+#include "test.hpp"
+#include "test_images.hpp"
+#include "image_preview.hpp"
+
+#include <algorithm>
+#include <random>
+#include <string>
+
+using pxshot::detail::decode_preview;
+using namespace pxshot::test;
+
+namespace {
+
+bool uniform(const pxshot::detail::Preview& preview, uint8_t red, uint8_t green, uint8_t blue) {
+    auto all = [](const std::vector<uint8_t>& channel, uint8_t value) {
+        return std::all_of(channel.begin(), channel.end(), [&](uint8_t v) { return v == value; });
+    };
+    return preview.pixels() > 0 && all(preview.red, red) && all(preview.green, green) && all(preview.blue, blue);
+}
+
+/// Decode every prefix of `image` and many copies with random bytes
+/// changed; none may crash or read out of bounds
+void mangle(const std::vector<uint8_t>& image) {
+    for (size_t size = 0; size < image.size(); ++size) {
+        (void)decode_preview(std::vector<uint8_t>(image.begin(), image.begin() + static_cast<std::ptrdiff_t>(size)),
+                             4096);
+    }
+    std::mt19937 rng(7);
+    for (int i = 0; i < 2000; ++i) {
+        auto copy = image;
+        int changes = 1 + static_cast<int>(rng() % 4);
+        for (int c = 0; c < changes; ++c) {
+            copy[rng() % copy.size()] = static_cast<uint8_t>(rng());
+        }
+        (void)decode_preview(copy, 4096);
+    }
+}
+
+} // namespace
+
+TEST_CASE(jpeg_dc_means) {
+    // Category 0 differences leave every block at the mid-grey level shift
+    auto preview = decode_preview(grey_jpeg(4, 0, 1), 4096);
+    CHECK(preview.has_value());
+    CHECK(preview && preview->width == 4 && preview->height == 1);
+    CHECK(preview && uniform(*preview, 128, 128, 128));
+}
+
+TEST_CASE(jpeg_oversubscribed_huffman_table) {
+    // Five codes of length 1 overflow the fast lookup table if accepted
+    std::vector<uint8_t> image{0xFF, 0xD8};
+    jpeg_segment(image, 0xC4, huffman_table(0x00, {5}, {0, 1, 2, 3, 4}));
+    image.insert(image.end(), {0xFF, 0xD9});
+    CHECK(!decode_preview(image, 4096));
+    
+    // Three codes of length 2 after two of length 1 are one too many
+    image = {0xFF, 0xD8};
+    jpeg_segment(image, 0xC4, huffman_table(0x10, {1, 3}, {0, 1, 2, 3}));
+    image.insert(image.end(), {0xFF, 0xD9});
+    CHECK(!decode_preview(image, 4096));
+}
+
+TEST_CASE(jpeg_dc_product_beyond_int) {
+    // 64 maximal differences push the predictor to its clamp, and times a
+    // 16-bit quantizer of 65535 the DC coefficient passes 2^31
+    auto preview = decode_preview(grey_jpeg(64, 11, 65535), 4096);
+    CHECK(preview.has_value());
+    CHECK(preview && preview->red.back() == 255);
+}
+
+TEST_CASE(jpeg_malformed) {
+    mangle(grey_jpeg(16, 3, 4));
+}
+
+#ifdef PXSHOT_HAVE_ZLIB
+
+TEST_CASE(png_solid_colour) {
+    auto preview = decode_preview(solid_png(64, 48, 10, 20, 30), 4096);
+    CHECK(preview.has_value());
+    CHECK(preview && preview->width == 64 && preview->height == 48);
+    CHECK(preview && uniform(*preview, 10, 20, 30));
+}
+
+TEST_CASE(png_sampled_and_filtered) {
+    // 256x256 is sampled every second pixel to fit 16K
+    auto preview = decode_preview(solid_png(256, 256, 200, 100, 50, 1), 16384);
+    CHECK(preview.has_value());
+    CHECK(preview && preview->pixels() <= 16384);
+    CHECK(preview && uniform(*preview, 200, 100, 50));
+}
+
+TEST_CASE(png_oversized_header) {
+    auto image = solid_png(4, 4, 0, 0, 0);
+    // Claim 65536 x 65536, past the source pixel limit
+    image[16] = 0;
+    image[17] = 1;
+    image[18] = 0;
+    image[19] = 0;
+    image[20] = 0;
+    image[21] = 1;
+    image[22] = 0;
+    image[23] = 0;
+    CHECK(!decode_preview(image, 4096));
+}
+
+TEST_CASE(png_malformed) {
+    mangle(solid_png(24, 24, 1, 2, 3, 1));
+}
+
+#endif // PXSHOT_HAVE_ZLIB
+
+TEST_CASE(unknown_format) {
+    CHECK(!decode_preview({}, 4096));
+    CHECK(!decode_preview({'R', 'I', 'F', 'F', 0, 0, 0, 0, 'W', 'E', 'B', 'P'}, 4096));
+}
@@ -0,0 +1,126 @@
+// Pxshot C++ SDK - Asynchronous logger tests
+
+#include "test.hpp"
+#include "logger.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <vector>
+
+using namespace pxshot;
+using detail::AsyncLogger;
+using detail::sample_evenly;
+
+namespace {
+
+struct Delivered {
+    LogLevel level;
+    std::string event;
+    int status;
+    std::string detail;
+    std::string line;
+};
+
+/// Collects records from the logging thread
+class Collector {
+public:
+    LogConfig config(LogLevel level = LogLevel::Debug) {
+        LogConfig config;
+        config.level = level;
+        config.handler = [this](const LogRecord& record) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            records_.push_back({record.level, std::string(record.event), record.status, std::string(record.detail),
+                                std::string(record.line)});
+            cv_.notify_all();
+        };
+        return config;
+    }
+    
+    std::vector<Delivered> wait_for(size_t count) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait_for(lock, std::chrono::seconds(5), [&] { return records_.size() >= count; });
+        return records_;
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::vector<Delivered> records_;
+};
+
+ScreenshotOptions page() {
+    ScreenshotOptions options;
+    options.url = "https://example.com/a";
+    return options;
+}
+
+} // namespace
+
+TEST_CASE(success_and_send) {
+    Collector collector;
+    AsyncLogger logger(collector.config());
+    logger.request_started(page(), Priority::Batch);
+    logger.request_finished(page(), Priority::Batch, 12.5, 2048, nullptr);
+    auto records = collector.wait_for(2);
+    CHECK(records.size() == 2);
+    CHECK(records.size() == 2 && records[0].event == "send");
+    CHECK(records.size() == 2 && records[1].event == "done" && records[1].status == 200);
+    CHECK(records.size() == 2 && records[1].line.find(" host=example.com ") != std::string::npos);
+    CHECK(records.size() == 2 && records[1].line.find(" bytes=2048") != std::string::npos);
+}
+
+TEST_CASE(errors_described_by_formatter) {
+    Collector collector;
+    AsyncLogger logger(collector.config(LogLevel::Info));
+    logger.request_finished(page(), Priority::Interactive, 30, 0,
+                            std::make_exception_ptr(HttpError(503, "Service unavailable")));
+    logger.request_finished(page(), Priority::Interactive, 30, 0,
+                            std::make_exception_ptr(HttpError(0, "Connection refused")));
+    logger.request_finished(page(), Priority::Interactive, 30, 0,
+                            std::make_exception_ptr(ApiError("quota", "Quota exceeded")));
+    logger.request_finished(page(), Priority::Interactive, 30, 0, std::make_exception_ptr(42));
+    // A success after the failures reuses no stale error
+    logger.request_finished(page(), Priority::Interactive, 30, 0, nullptr);
+    auto records = collector.wait_for(5);
+    CHECK(records.size() == 5);
+    if (records.size() == 5) {
+        CHECK(records[0].level == LogLevel::Error && records[0].event == "failed");
+        CHECK(records[0].status == 503);
+        CHECK(records[0].detail == "http_503 Service unavailable");
+        CHECK(records[0].line.find(" status=503 ") != std::string::npos);
+        CHECK(records[1].status == 0 && records[1].detail == "network Connection refused");
+        CHECK(records[2].detail.rfind("api:quota ", 0) == 0);
+        CHECK(records[3].detail == "other");
+        CHECK(records[4].status == 200 && records[4].detail.empty());
+    }
+}
+
+TEST_CASE(level_floor) {
+    Collector collector;
+    AsyncLogger logger(collector.config(LogLevel::Warning));
+    logger.request_started(page(), Priority::Batch);
+    logger.request_finished(page(), Priority::Batch, 5, 0, nullptr);
+    logger.event(LogLevel::Warning, "pipelining switched off");
+    auto records = collector.wait_for(1);
+    CHECK(records.size() == 1);
+    CHECK(records.size() == 1 && records[0].event == "client" && records[0].detail == "pipelining switched off");
+}
+
+TEST_CASE(sample_evenly_spacing) {
+    std::atomic<uint64_t> counter{0};
+    std::vector<int> kept;
+    for (int i = 0; i < 12; ++i) {
+        if (sample_evenly(counter, 0.25)) {
+            kept.push_back(i);
+        }
+    }
+    CHECK((kept == std::vector<int>{3, 7, 11}));
+    
+    std::atomic<uint64_t> unused{0};
+    CHECK(sample_evenly(unused, 1.0));
+    CHECK(!sample_evenly(unused, 0.0));
+    CHECK(unused.load() == 0);
+}
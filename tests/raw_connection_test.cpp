@@ -0,0 +1,102 @@
+// Pxshot C++ SDK - Raw HTTP connection tests
+
+#include "test.hpp"
+#include "raw_connection.hpp"
+#include "pxshot/pxshot.hpp"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <string>
+#include <thread>
+
+using namespace pxshot;
+
+namespace {
+
+/// Loopback server that answers one connection with `reply`, whatever
+/// the request, then closes it
+class CannedServer {
+public:
+    explicit CannedServer(std::string reply) : reply_(std::move(reply)) {
+        listener_ = ::socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        ::bind(listener_, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+        ::listen(listener_, 1);
+        socklen_t length = sizeof(address);
+        ::getsockname(listener_, reinterpret_cast<sockaddr*>(&address), &length);
+        port_ = ntohs(address.sin_port);
+        thread_ = std::thread([this] {
+            int client = ::accept(listener_, nullptr, nullptr);
+            char request[4096];
+            (void)::recv(client, request, sizeof(request), 0);
+            (void)::send(client, reply_.data(), reply_.size(), MSG_NOSIGNAL);
+            ::close(client);
+        });
+    }
+    
+    ~CannedServer() {
+        thread_.join();
+        ::close(listener_);
+    }
+    
+    [[nodiscard]] detail::Endpoint endpoint() const {
+        return detail::parse_endpoint("http://127.0.0.1:" + std::to_string(port_));
+    }
+
+private:
+    std::string reply_;
+    int listener_ = -1;
+    int port_ = 0;
+    std::thread thread_;
+};
+
+detail::RawResponse exchange(const std::string& reply) {
+    CannedServer server(reply);
+    detail::RawConnection connection(server.endpoint(), 5);
+    connection.write("GET / HTTP/1.1\r\nHost: test\r\n\r\n");
+    return connection.read_response();
+}
+
+} // namespace
+
+TEST_CASE(content_length_body) {
+    auto response = exchange("HTTP/1.1 200 OK\r\nContent-Type: image/png\r\nContent-Length: 5\r\n\r\nhello");
+    CHECK(response.status == 200);
+    CHECK(response.content_type == "image/png");
+    CHECK(response.body == "hello");
+}
+
+TEST_CASE(chunked_body) {
+    auto response = exchange("HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n"
+                             "3;name=value\r\nabc\r\n2\r\nde\r\n0\r\n\r\n");
+    CHECK(response.body == "abcde");
+}
+
+TEST_CASE(interim_responses_skipped) {
+    auto response = exchange("HTTP/1.1 100 Continue\r\n\r\n"
+                             "HTTP/1.1 103 Early Hints\r\nLink: </style.css>\r\n\r\n"
+                             "HTTP/1.1 201 Created\r\nContent-Length: 2\r\n\r\nok");
+    CHECK(response.status == 201);
+    CHECK(response.body == "ok");
+}
+
+TEST_CASE(malformed_content_length) {
+    CHECK_THROWS(exchange("HTTP/1.1 200 OK\r\nContent-Length: abc\r\n\r\n"), HttpError);
+    CHECK_THROWS(exchange("HTTP/1.1 200 OK\r\nContent-Length: 12x\r\n\r\n"), HttpError);
+    CHECK_THROWS(exchange("HTTP/1.1 200 OK\r\nContent-Length: -1\r\n\r\n"), HttpError);
+    CHECK_THROWS(exchange("HTTP/1.1 200 OK\r\nContent-Length: 99999999999999999999999\r\n\r\n"), HttpError);
+}
+
+TEST_CASE(malformed_chunk_size) {
+    CHECK_THROWS(exchange("HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\nzz\r\n"), HttpError);
+}
+
+TEST_CASE(malformed_status_line) {
+    CHECK_THROWS(exchange("HTTP/1.1 abc Nope\r\n\r\n"), HttpError);
+    CHECK_THROWS(exchange("SPDY/3 200 OK\r\n\r\n"), HttpError);
+}
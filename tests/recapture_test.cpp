@@ -0,0 +1,102 @@
+// Pxshot C++ SDK - Adaptive recapture interval tests
+
+#include "test.hpp"
+#include "recapture.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <vector>
+
+using namespace pxshot;
+using detail::change_rate;
+using detail::next_interval;
+
+namespace {
+
+using std::chrono::seconds;
+
+/// `captures` captures `interval` apart, the first `changed` of them changed
+std::vector<MonitorObservation> history(size_t captures, size_t changed, seconds interval) {
+    std::vector<MonitorObservation> observations;
+    for (size_t i = 0; i < captures; ++i) {
+        observations.push_back({interval, i < changed});
+    }
+    return observations;
+}
+
+MonitorConfig adaptive() {
+    MonitorConfig config;
+    config.adaptive = true;
+    config.min_interval = seconds(300);
+    config.max_interval = seconds(86400);
+    config.change_probability = 0.5;
+    config.max_growth = 2.0;
+    return config;
+}
+
+} // namespace
+
+TEST_CASE(unchanged_history) {
+    CHECK(change_rate(history(8, 0, seconds(3600))) == 0);
+    CHECK(change_rate({}) == 0);
+    
+    // No change seen: grow by max_growth, up to max_interval
+    auto config = adaptive();
+    CHECK(next_interval(config, seconds(3600), 0) == seconds(7200));
+    CHECK(next_interval(config, seconds(60000), 0) == seconds(86400));
+}
+
+TEST_CASE(changed_history) {
+    CHECK(std::isinf(change_rate(history(8, 8, seconds(3600)))));
+    
+    auto config = adaptive();
+    CHECK(next_interval(config, seconds(3600), change_rate(history(8, 8, seconds(3600)))) == seconds(300));
+}
+
+TEST_CASE(mixed_history) {
+    // With equal intervals I and k of n changed, the rate solves
+    // 1 - exp(-rate * I) = k / n
+    for (size_t changed : {1, 2, 5}) {
+        double expected = -std::log1p(-static_cast<double>(changed) / 8) / 3600;
+        CHECK_NEAR(change_rate(history(8, changed, seconds(3600))), expected, expected * 1e-9);
+    }
+    
+    // Unequal intervals: one change in 600 s, none in 3000 s. The slope
+    // 600 / (exp(600 r) - 1) - 3000 is zero at exp(600 r) = 1.2
+    std::vector<MonitorObservation> observations = {{seconds(600), true}, {seconds(3000), false}};
+    double expected = std::log(1.2) / 600;
+    CHECK_NEAR(change_rate(observations), expected, expected * 1e-9);
+}
+
+TEST_CASE(interval_for_rate) {
+    auto config = adaptive();
+    
+    // A change within t is 1 - exp(-rate * t) likely; 0.5 at t = ln 2 / rate
+    CHECK(next_interval(config, seconds(3600), std::log(2.0) / 1000) == seconds(1000));
+    
+    // Target beyond current * max_growth
+    CHECK(next_interval(config, seconds(1000), std::log(2.0) / 5000) == seconds(2000));
+    config.max_growth = 10;
+    CHECK(next_interval(config, seconds(1000), std::log(2.0) / 5000) == seconds(5000));
+    
+    // Target beyond max_interval, and below min_interval
+    CHECK(next_interval(config, seconds(80000), std::log(2.0) / 100000) == seconds(86400));
+    CHECK(next_interval(config, seconds(3600), std::log(2.0) / 10) == seconds(300));
+    
+    // Not adaptive: always the fixed interval
+    MonitorConfig fixed;
+    CHECK(next_interval(fixed, seconds(60), 1.0) == fixed.interval);
+}
+
+TEST_CASE(validation) {
+    auto config = adaptive();
+    detail::validate(config);
+    config.max_interval = seconds(100);
+    CHECK_THROWS(detail::validate(config), ValidationError);
+    config = adaptive();
+    config.change_probability = 1;
+    CHECK_THROWS(detail::validate(config), ValidationError);
+    config = adaptive();
+    config.max_growth = 0.5;
+    CHECK_THROWS(detail::validate(config), ValidationError);
+}
@@ -0,0 +1,96 @@
+// Pxshot C++ SDK - Result cache admission tests
+//
+// Results can only be made by a Client, so the cache is exercised through
+// one, against a loopback server that answers every capture.
+
+#include "test.hpp"
+#include "mock_server.hpp"
+#include "pxshot/pxshot.hpp"
+
+#include <string>
+
+using namespace pxshot;
+
+namespace {
+
+constexpr size_t kImageBytes = 1000;
+
+/// Loopback API answering every capture with the same image
+class Api {
+public:
+    Api() : server_([this](const mock::Request&) { return mock::image(image_); }) {}
+    
+    [[nodiscard]] std::string url() const { return server_.url(); }
+
+private:
+    std::string image_ = std::string(kImageBytes, '\x89');
+    mock::Server server_;
+};
+
+ScreenshotOptions page(const std::string& key) {
+    ScreenshotOptions options;
+    options.url = "https://" + key + ".example/";
+    return options;
+}
+
+ClientConfig config_for(const Api& server, int64_t cache_bytes, CachePolicy policy) {
+    ClientConfig config;
+    config.api_key = "px_test";
+    config.base_url = server.url();
+    config.result_cache_bytes = cache_bytes;
+    config.result_cache_policy = policy;
+    return config;
+}
+
+void capture(Client& client, const std::string& key) {
+    (void)client.screenshot(page(key));
+}
+
+/// Hits on the popular pages after a sweep of one-off pages big enough to
+/// flush an LRU cache several times over
+uint64_t hits_after_sweep(CachePolicy policy, uint64_t& rejected) {
+    Api server;
+    Client client(config_for(server, 200 * 1500, policy));
+    for (int key = 0; key < 50; ++key) {
+        for (int i = 0; i < 4; ++i) {
+            capture(client, "hot" + std::to_string(key));
+        }
+    }
+    for (int key = 0; key < 1000; ++key) {
+        capture(client, "sweep" + std::to_string(key));
+    }
+    auto before = client.stats().cache_hits;
+    for (int key = 0; key < 50; ++key) {
+        capture(client, "hot" + std::to_string(key));
+    }
+    auto stats = client.stats();
+    rejected = stats.cache_rejected;
+    return stats.cache_hits - before;
+}
+
+} // namespace
+
+TEST_CASE(lru_flushed_by_sweep) {
+    uint64_t rejected = 0;
+    CHECK(hits_after_sweep(CachePolicy::Lru, rejected) == 0);
+    CHECK(rejected == 0);
+}
+
+TEST_CASE(tinylfu_keeps_popular_results) {
+    uint64_t rejected = 0;
+    CHECK(hits_after_sweep(CachePolicy::TinyLfu, rejected) == 50);
+    CHECK(rejected > 500);
+}
+
+TEST_CASE(cache_serves_repeats) {
+    Api server;
+    Client client(config_for(server, 1 << 20, CachePolicy::TinyLfu));
+    auto first = client.screenshot(page("a"));
+    auto second = client.screenshot(page("a"));
+    CHECK(first.bytes().size() == kImageBytes);
+    CHECK(second.bytes() == first.bytes());
+    auto stats = client.stats();
+    CHECK(stats.cache_hits == 1);
+    CHECK(stats.cache_misses == 1);
+    CHECK(stats.cache_bytes > static_cast<int64_t>(kImageBytes));
+}
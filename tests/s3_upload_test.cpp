@@ -0,0 +1,141 @@
+// Pxshot C++ SDK - S3 upload sink tests, against the examples' S3 stand-in
+
+#include "test.hpp"
+#include "mock_server.hpp"
+#include "s3_stand_in.hpp"
+
+#include <pxshot/pxshot.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+using namespace pxshot;
+
+namespace {
+
+constexpr size_t kPartBytes = 5 * 1024 * 1024;
+
+/// An S3 stand-in behind a loopback server
+class S3 {
+public:
+    S3() : server_([this](const mock::Request& request) { return stand_in.handle(request); }) {}
+    
+    mock::S3StandIn stand_in;
+    
+    S3Target target() const {
+        S3Target target;
+        target.endpoint = server_.url();
+        target.bucket = "shots";
+        target.access_key_id = "test";
+        target.secret_access_key = "test";
+        target.part_bytes = kPartBytes;
+        target.parallel_parts = 2;
+        return target;
+    }
+
+private:
+    mock::Server server_;
+};
+
+std::string bytes(size_t size) {
+    std::string data(size, '\0');
+    for (size_t i = 0; i < size; ++i) {
+        data[i] = static_cast<char>(i * 131 + i / 4096);
+    }
+    return data;
+}
+
+/// Write `data` to `sink` in 64 KiB pieces as a capture would arrive,
+/// aborting the sink on failure as the client does
+void upload(S3Sink& sink, const std::string& data) {
+    try {
+        sink.begin("image/png", data.size());
+        for (size_t offset = 0; offset < data.size(); offset += 65536) {
+            size_t n = std::min<size_t>(65536, data.size() - offset);
+            sink.write(reinterpret_cast<const uint8_t*>(data.data()) + offset, n);
+        }
+        sink.finish();
+    } catch (...) {
+        sink.abort();
+        throw;
+    }
+}
+
+} // namespace
+
+TEST_CASE(small_body_single_put) {
+    S3 s3;
+    S3Uploader uploader(s3.target());
+    auto data = bytes(300 * 1024);
+    auto sink = uploader.open("small.png");
+    upload(*sink, data);
+    
+    const auto& object = sink->object();
+    CHECK(object.parts == 0);
+    CHECK(object.size_bytes == data.size());
+    CHECK(object.etag == "\"single\"");
+    CHECK(s3.stand_in.object("/shots/small.png") == data);
+    CHECK(s3.stand_in.part_requests() == 0);
+}
+
+TEST_CASE(multipart_reassembles) {
+    S3 s3;
+    S3Uploader uploader(s3.target());
+    auto data = bytes(2 * kPartBytes + 12345);
+    auto sink = uploader.open("captures/large.png");
+    upload(*sink, data);
+    
+    const auto& object = sink->object();
+    CHECK(object.parts == 3);
+    CHECK(object.size_bytes == data.size());
+    CHECK(object.etag == "\"multipart\"");
+    CHECK(s3.stand_in.object("/shots/captures/large.png") == data);
+    CHECK(s3.stand_in.open_uploads() == 0);
+    CHECK(s3.stand_in.aborted() == 0);
+}
+
+TEST_CASE(failed_part_aborts) {
+    S3 s3;
+    s3.stand_in.fail_part(2, 403, 1);          // A retry would succeed
+    S3Uploader uploader(s3.target());
+    auto sink = uploader.open("denied.png");
+    
+    int status = 0;
+    try {
+        upload(*sink, bytes(3 * kPartBytes));
+    } catch (const HttpError& e) {
+        status = e.status_code;
+    }
+    CHECK(status == 403);                       // Client errors are not retried
+    CHECK(s3.stand_in.aborted() == 1);
+    CHECK(s3.stand_in.open_uploads() == 0);
+    CHECK(s3.stand_in.object("/shots/denied.png").empty());
+}
+
+TEST_CASE(server_errors_retried_with_backoff) {
+    S3 s3;
+    s3.stand_in.fail_part(1, 503, 1);
+    S3Uploader uploader(s3.target());
+    auto data = bytes(kPartBytes + 1);
+    auto sink = uploader.open("flaky.png");
+    upload(*sink, data);
+    CHECK(s3.stand_in.object("/shots/flaky.png") == data);
+    CHECK(s3.stand_in.part_requests() == 3);    // Part 1 twice, part 2 once
+    
+    // Three attempts, 100 ms and then 200 ms apart, before giving up
+    s3.stand_in.fail_part(1, 500);
+    sink = uploader.open("down.png");
+    auto start = std::chrono::steady_clock::now();
+    int status = 0;
+    try {
+        upload(*sink, bytes(kPartBytes + 1));
+    } catch (const HttpError& e) {
+        status = e.status_code;
+    }
+    CHECK(status == 500);
+    CHECK(std::chrono::steady_clock::now() - start >= std::chrono::milliseconds(300));
+    CHECK(s3.stand_in.part_requests() == 3 + 3 + 1);
+    CHECK(s3.stand_in.aborted() == 1);
+}
@@ -0,0 +1,70 @@
+// Pxshot C++ SDK - Unit test harness
+//
+// Just enough to register test cases and report failed checks, so the
+// tests need nothing beyond the library's own dependencies. Each test file
+// is its own executable, linked with test_main.cpp.
+
+#ifndef PXSHOT_TEST_HPP
+#define PXSHOT_TEST_HPP
+
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+namespace pxshot {
+namespace test {
+
+struct Case {
+    const char* name;
+    void (*run)();
+};
+
+inline std::vector<Case>& cases() {
+    static std::vector<Case> all;
+    return all;
+}
+
+inline int failures = 0;
+
+struct Registration {
+    Registration(const char* name, void (*run)()) { cases().push_back({name, run}); }
+};
+
+inline void fail(const char* file, int line, const char* expression) {
+    ++failures;
+    std::fprintf(stderr, "%s:%d: check failed: %s\n", file, line, expression);
+}
+
+} // namespace test
+} // namespace pxshot
+
+/// Define a test case, run by test_main.cpp in file order
+#define TEST_CASE(name)                                                                 \
+    static void name();                                                                 \
+    static const ::pxshot::test::Registration name##_registration(#name, name);         \
+    static void name()
+
+#define CHECK(condition)                                                                \
+    do {                                                                                \
+        if (!(condition)) {                                                             \
+            ::pxshot::test::fail(__FILE__, __LINE__, #condition);                       \
+        }                                                                               \
+    } while (0)
+
+#define CHECK_NEAR(actual, expected, tolerance)                                         \
+    CHECK(std::fabs(static_cast<double>(actual) - static_cast<double>(expected)) <= (tolerance))
+
+#define CHECK_THROWS(expression, type)                                                  \
+    do {                                                                                \
+        bool thrown = false;                                                            \
+        try {                                                                           \
+            (void)(expression);                                                         \
+        } catch (const type&) {                                                         \
+            thrown = true;                                                              \
+        }                                                                               \
+        if (!thrown) {                                                                  \
+            ::pxshot::test::fail(__FILE__, __LINE__, #expression " throws " #type);     \
+        }                                                                               \
+    } while (0)
+
+#endif // PXSHOT_TEST_HPP
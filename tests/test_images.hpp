@@ -0,0 +1,160 @@
+// Pxshot C++ SDK - Test images built in memory
+
+#ifndef PXSHOT_TEST_IMAGES_HPP
+#define PXSHOT_TEST_IMAGES_HPP
+
+#ifdef PXSHOT_HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace pxshot {
+namespace test {
+
+inline void append_big_endian(std::vector<uint8_t>& out, uint32_t value, int bytes) {
+    for (int i = bytes - 1; i >= 0; --i) {
+        out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+    }
+}
+
+/// Entropy-coded bits, with 0xFF bytes stuffed as the format requires
+class BitWriter {
+public:
+    void write(uint32_t bits, int count) {
+        for (int i = count - 1; i >= 0; --i) {
+            byte_ = static_cast<uint8_t>(byte_ << 1 | (bits >> i & 1));
+            if (++filled_ == 8) {
+                flush_byte();
+            }
+        }
+    }
+    
+    std::vector<uint8_t> finish() {
+        while (filled_ != 0) {
+            write(1, 1);    // Pad with ones
+        }
+        return std::move(bytes_);
+    }
+
+private:
+    std::vector<uint8_t> bytes_;
+    uint8_t byte_ = 0;
+    int filled_ = 0;
+    
+    void flush_byte() {
+        bytes_.push_back(byte_);
+        if (byte_ == 0xFF) {
+            bytes_.push_back(0);
+        }
+        byte_ = 0;
+        filled_ = 0;
+    }
+};
+
+inline void jpeg_segment(std::vector<uint8_t>& out, uint8_t marker, const std::vector<uint8_t>& payload) {
+    out.push_back(0xFF);
+    out.push_back(marker);
+    append_big_endian(out, static_cast<uint32_t>(payload.size() + 2), 2);
+    out.insert(out.end(), payload.begin(), payload.end());
+}
+
+/// DHT payload of one table whose codes all have length 1 or 2
+inline std::vector<uint8_t> huffman_table(uint8_t table, std::vector<uint8_t> counts, std::vector<uint8_t> symbols) {
+    std::vector<uint8_t> payload{table};
+    counts.resize(16);
+    payload.insert(payload.end(), counts.begin(), counts.end());
+    payload.insert(payload.end(), symbols.begin(), symbols.end());
+    return payload;
+}
+
+/// Baseline greyscale JPEG one block high and `blocks` wide. Every block's
+/// DC difference is `category` one-bits and no block has AC coefficients.
+/// `quantizer` is the DC quantizer, stored at 16-bit precision.
+inline std::vector<uint8_t> grey_jpeg(int blocks, int category, uint16_t quantizer) {
+    std::vector<uint8_t> out{0xFF, 0xD8};
+    
+    std::vector<uint8_t> dqt{0x10};
+    append_big_endian(dqt, quantizer, 2);
+    for (int i = 1; i < 64; ++i) {
+        append_big_endian(dqt, 1, 2);
+    }
+    jpeg_segment(out, 0xDB, dqt);
+    
+    std::vector<uint8_t> sof{8};
+    append_big_endian(sof, 8, 2);
+    append_big_endian(sof, static_cast<uint32_t>(8 * blocks), 2);
+    sof.insert(sof.end(), {1, 1, 0x11, 0});
+    jpeg_segment(out, 0xC0, sof);
+    
+    jpeg_segment(out, 0xC4, huffman_table(0x00, {1}, {static_cast<uint8_t>(category)}));
+    jpeg_segment(out, 0xC4, huffman_table(0x10, {1}, {0x00}));
+    jpeg_segment(out, 0xDA, {1, 1, 0x00, 0, 63, 0});
+    
+    // Each block: DC code 0, `category` bits of ones, then AC code 0 (EOB)
+    BitWriter scan;
+    for (int i = 0; i < blocks; ++i) {
+        scan.write(0, 1);
+        scan.write((1u << category) - 1, category);
+        scan.write(0, 1);
+    }
+    auto bits = scan.finish();
+    out.insert(out.end(), bits.begin(), bits.end());
+    out.insert(out.end(), {0xFF, 0xD9});
+    return out;
+}
+
+#ifdef PXSHOT_HAVE_ZLIB
+
+inline void png_chunk(std::vector<uint8_t>& out, const char* type, const std::vector<uint8_t>& data) {
+    append_big_endian(out, static_cast<uint32_t>(data.size()), 4);
+    size_t start = out.size();
+    out.insert(out.end(), type, type + 4);
+    out.insert(out.end(), data.begin(), data.end());
+    uLong crc = crc32(0, out.data() + start, static_cast<uInt>(out.size() - start));
+    append_big_endian(out, static_cast<uint32_t>(crc), 4);
+}
+
+/// 8-bit RGB PNG of one colour, each row with filter `filter`
+inline std::vector<uint8_t> solid_png(uint32_t width, uint32_t height, uint8_t red, uint8_t green, uint8_t blue,
+                               uint8_t filter = 0) {
+    std::vector<uint8_t> out{0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    std::vector<uint8_t> header;
+    append_big_endian(header, width, 4);
+    append_big_endian(header, height, 4);
+    header.insert(header.end(), {8, 2, 0, 0, 0});
+    png_chunk(out, "IHDR", header);
+    
+    std::vector<uint8_t> raw;
+    for (uint32_t y = 0; y < height; ++y) {
+        raw.push_back(0);
+        for (uint32_t x = 0; x < width; ++x) {
+            raw.insert(raw.end(), {red, green, blue});
+        }
+    }
+    if (filter == 1) {
+        // Sub: every byte after the first pixel is the difference, zero
+        size_t stride = size_t{width} * 3 + 1;
+        for (uint32_t y = 0; y < height; ++y) {
+            raw[y * stride] = 1;
+            std::fill(raw.begin() + static_cast<std::ptrdiff_t>(y * stride + 4),
+                      raw.begin() + static_cast<std::ptrdiff_t>((y + 1) * stride), 0);
+        }
+    }
+    uLongf size = compressBound(static_cast<uLong>(raw.size()));
+    std::vector<uint8_t> compressed(size);
+    compress(compressed.data(), &size, raw.data(), static_cast<uLong>(raw.size()));
+    compressed.resize(size);
+    png_chunk(out, "IDAT", compressed);
+    png_chunk(out, "IEND", {});
+    return out;
+}
+
+#endif // PXSHOT_HAVE_ZLIB
+
+} // namespace test
+} // namespace pxshot
+
+#endif // PXSHOT_TEST_IMAGES_HPP
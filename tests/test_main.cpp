@@ -0,0 +1,19 @@
+// Pxshot C++ SDK - Unit test runner
+
+#include "test.hpp"
+
+#include <exception>
+
+int main() {
+    for (const auto& test : pxshot::test::cases()) {
+        int before = pxshot::test::failures;
+        try {
+            test.run();
+        } catch (const std::exception& e) {
+            std::fprintf(stderr, "%s: unexpected exception: %s\n", test.name, e.what());
+            ++pxshot::test::failures;
+        }
+        std::printf("%s %s\n", pxshot::test::failures == before ? "PASS" : "FAIL", test.name);
+    }
+    return pxshot::test::failures == 0 ? 0 : 1;
+}